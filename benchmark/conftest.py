@@ -0,0 +1,211 @@
+# Copyright 2010-2026 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+import os
+import random
+import shutil
+import sys
+from collections.abc import Callable
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Any
+
+import pytest
+
+import pygit2
+from pygit2 import Index, IndexEntry, Oid, Repository
+from pygit2.enums import CheckoutStrategy, FileMode
+
+
+def pytest_addoption(parser: pytest.Parser) -> None:
+    group = parser.getgroup('pygit2 benchmarks', 'size of the synthetic repository')
+    group.addoption('--repo-commits', type=int, default=1000, help='number of commits')
+    group.addoption(
+        '--repo-fanout', type=int, default=16, help='entries per tree, at every level'
+    )
+    group.addoption('--repo-depth', type=int, default=2, help='levels of directories')
+    group.addoption(
+        '--repo-blob-size', type=int, default=1024, help='size of the blobs in bytes'
+    )
+    group.addoption(
+        '--repo-changes', type=int, default=4, help='files changed by every commit'
+    )
+    group.addoption('--repo-refs', type=int, default=100, help='number of branches')
+
+
+@dataclass
+class RepoSpec:
+    commits: int
+    fanout: int
+    depth: int
+    blob_size: int
+    changes: int
+    refs: int
+
+    @property
+    def name(self) -> str:
+        return (
+            f'c{self.commits}-f{self.fanout}-d{self.depth}-b{self.blob_size}'
+            f'-x{self.changes}-r{self.refs}'
+        )
+
+    def paths(self) -> list[str]:
+        paths = [f'file{i:03}' for i in range(self.fanout)]
+        for _ in range(self.depth):
+            paths = [f'dir{i:03}/{path}' for i in range(self.fanout) for path in paths]
+        return paths
+
+
+@pytest.fixture(scope='session', autouse=True)
+def global_git_config() -> None:
+    # Same as in the unit tests, do not depend on the user configuration
+    levels = [
+        pygit2.enums.ConfigLevel.GLOBAL,
+        pygit2.enums.ConfigLevel.XDG,
+        pygit2.enums.ConfigLevel.SYSTEM,
+    ]
+    for level in levels:
+        pygit2.settings.search_path[level] = ''
+
+
+@pytest.fixture(scope='session')
+def repo_spec(request: pytest.FixtureRequest) -> RepoSpec:
+    option = request.config.getoption
+    return RepoSpec(
+        commits=option('--repo-commits'),
+        fanout=option('--repo-fanout'),
+        depth=option('--repo-depth'),
+        blob_size=option('--repo-blob-size'),
+        changes=option('--repo-changes'),
+        refs=option('--repo-refs'),
+    )
+
+
+def synthesize(path: Path, spec: RepoSpec) -> None:
+    """Create a repository with a linear history, where every commit changes
+    a few random files, then pack it and check it out."""
+    rng = random.Random(0)
+    repo = pygit2.init_repository(path)
+    sig = pygit2.Signature('Bench', 'bench@example.com', 1_000_000_000, 0)
+
+    def blob() -> Oid:
+        return repo.create_blob(rng.randbytes(spec.blob_size))
+
+    paths = spec.paths()
+    index = Index()
+    for path in paths:
+        index.add(IndexEntry(path, blob(), FileMode.BLOB))
+
+    parents: list[Oid] = []
+    commits = []
+    for i in range(spec.commits):
+        if i:
+            for path in rng.sample(paths, min(spec.changes, len(paths))):
+                index.add(IndexEntry(path, blob(), FileMode.BLOB))
+        tree = index.write_tree(repo)
+        author = pygit2.Signature(sig.name, sig.email, sig.time + i, 0)
+        oid = repo.create_commit(None, author, author, f'commit {i}', tree, parents)
+        parents = [oid]
+        commits.append(oid)
+
+    repo.references.create('refs/heads/master', commits[-1], force=True)
+    for i in range(spec.refs):
+        repo.references.create(f'refs/heads/branch{i:05}', rng.choice(commits))
+
+    # Keep only the pack, like most real repositories
+    repo.pack()
+    objects = Path(repo.path) / 'objects'
+    for loose in objects.iterdir():
+        if len(loose.name) == 2:
+            shutil.rmtree(loose)
+
+    repo = Repository(path)
+    repo.checkout_head(strategy=CheckoutStrategy.FORCE)
+
+
+@pytest.fixture(scope='session')
+def repo_path(repo_spec: RepoSpec, tmp_path_factory: pytest.TempPathFactory) -> Path:
+    """Path to the synthetic repository. If PYGIT2_BENCH_CACHE is set, the
+    repository is kept there and reused by later runs."""
+    cache = os.environ.get('PYGIT2_BENCH_CACHE')
+    if cache:
+        path = Path(cache) / repo_spec.name
+        if not (path / '.git').exists():
+            synthesize(path, repo_spec)
+        return path
+
+    path = tmp_path_factory.mktemp('bench') / repo_spec.name
+    synthesize(path, repo_spec)
+    return path
+
+
+@pytest.fixture
+def repo(repo_path: Path) -> Repository:
+    return Repository(repo_path)
+
+
+def _reset_peak_rss() -> bool:
+    # Linux lets us reset the peak, elsewhere it covers the whole run
+    try:
+        with open('/proc/self/clear_refs', 'w') as f:
+            f.write('5')
+    except OSError:
+        return False
+    return True
+
+
+def _peak_rss_kib() -> int:
+    try:
+        with open('/proc/self/status') as f:
+            for line in f:
+                if line.startswith('VmHWM:'):
+                    return int(line.split()[1])
+    except OSError:
+        pass
+    try:
+        import resource
+    except ImportError:  # Windows
+        return 0
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # bytes on macOS, KiB on Linux
+    return peak // 1024 if sys.platform == 'darwin' else peak
+
+
+@pytest.fixture
+def measure(benchmark: Any) -> Callable[..., Any]:
+    """Run the benchmark, and record the peak resident memory and the number
+    of items processed, from which throughput is derived."""
+
+    def run(func: Callable[..., Any], *args: Any, items: int | None = None) -> Any:
+        benchmark.extra_info['peak_rss_reset'] = _reset_peak_rss()
+        result = benchmark(func, *args)
+        benchmark.extra_info['peak_rss_kib'] = _peak_rss_kib()
+        if items is not None:
+            benchmark.extra_info['items'] = items
+            mean = benchmark.stats.stats.mean
+            benchmark.extra_info['items_per_second'] = items / mean
+        return result
+
+    return run
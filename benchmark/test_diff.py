@@ -0,0 +1,55 @@
+# Copyright 2010-2026 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""Diff and patch generation."""
+
+from collections.abc import Callable
+from typing import Any
+
+from pygit2 import Commit, Repository
+
+Measure = Callable[..., Any]
+
+
+def test_diff_commits(repo: Repository, measure: Measure) -> None:
+    """Diff every commit against its parent, as a log --stat would."""
+    commits = [c for c in repo.walk(repo.head.target) if c.parents][:100]
+
+    def diff() -> int:
+        return sum(len(repo.diff(c.parents[0], c)) for c in commits)
+
+    measure(diff, items=len(commits))
+
+
+def test_patch_lines(repo: Repository, measure: Measure) -> None:
+    """Diff the first and last commits, reading every line of the patch."""
+    head = repo.head.peel(Commit)
+    first = list(repo.walk(head.id))[-1]
+    diff = repo.diff(first, head)
+
+    def lines() -> int:
+        return sum(len(hunk.lines) for patch in diff if patch for hunk in patch.hunks)
+
+    measure(lines, items=len(diff))
@@ -0,0 +1,67 @@
+# Copyright 2010-2026 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""Revision walking, commit and tree reading."""
+
+from collections.abc import Callable
+from typing import Any
+
+from pygit2 import Repository, Tree
+from pygit2.enums import SortMode
+
+from .conftest import RepoSpec
+
+Measure = Callable[..., Any]
+
+
+def test_walk(repo: Repository, repo_spec: RepoSpec, measure: Measure) -> None:
+    def walk() -> int:
+        walker = repo.walk(repo.head.target, SortMode.TOPOLOGICAL)
+        return sum(1 for commit in walker)
+
+    assert measure(walk, items=repo_spec.commits) == repo_spec.commits
+
+
+def test_walk_oids(repo: Repository, repo_spec: RepoSpec, measure: Measure) -> None:
+    def walk() -> int:
+        return sum(1 for oid in repo.walk(repo.head.target).oids())
+
+    assert measure(walk, items=repo_spec.commits) == repo_spec.commits
+
+
+def test_commit_table(repo: Repository, repo_spec: RepoSpec, measure: Measure) -> None:
+    def table() -> dict:
+        return repo.commit_table(repo.walk(repo.head.target))
+
+    measure(table, items=repo_spec.commits)
+
+
+def test_tree_iter(repo: Repository, repo_spec: RepoSpec, measure: Measure) -> None:
+    def iterate(tree: Tree) -> int:
+        return sum(iterate(entry) if isinstance(entry, Tree) else 1 for entry in tree)
+
+    tree = repo.head.peel(Tree)
+    files = len(repo_spec.paths())
+    assert measure(iterate, tree, items=files) == files
@@ -0,0 +1,65 @@
+# Copyright 2010-2026 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""Object database iteration and reading, object ids."""
+
+from collections.abc import Callable
+from typing import Any
+
+from pygit2 import Oid, OidSet, Repository
+
+Measure = Callable[..., Any]
+
+
+def test_odb_iter(repo: Repository, measure: Measure) -> None:
+    odb = repo.odb
+    count = sum(1 for oid in odb)
+    assert measure(lambda: sum(1 for oid in odb), items=count) == count
+
+
+def test_read_many(repo: Repository, measure: Measure) -> None:
+    odb = repo.odb
+    oids = list(odb)
+    measure(odb.read_many, oids, items=len(oids))
+
+
+def test_lookup(repo: Repository, measure: Measure) -> None:
+    oids = list(repo.odb)
+
+    def lookup() -> None:
+        for oid in oids:
+            repo[oid]
+
+    measure(lookup, items=len(oids))
+
+
+def test_oid_hash(repo: Repository, measure: Measure) -> None:
+    oids = [Oid(raw=oid.raw) for oid in repo.odb]
+    measure(lambda: len(set(oids)), items=len(oids))
+
+
+def test_oidset(repo: Repository, measure: Measure) -> None:
+    oids = list(repo.odb)
+    measure(lambda: len(OidSet(oids)), items=len(oids))
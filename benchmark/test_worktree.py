@@ -0,0 +1,113 @@
+# Copyright 2010-2026 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+"""Status of the working directory and blob streaming."""
+
+import shutil
+from collections.abc import Callable, Generator
+from pathlib import Path
+from typing import Any
+
+import pytest
+
+from pygit2 import Blob, BlobIO, Repository, StatusCache, Tree
+from pygit2.enums import CheckoutStrategy
+
+from .conftest import RepoSpec
+
+Measure = Callable[..., Any]
+
+
+@pytest.fixture
+def dirty(repo: Repository, repo_spec: RepoSpec) -> Generator[Repository, None, None]:
+    """Modify a few files, and add an untracked one, restoring them after."""
+    workdir = Path(repo.workdir)
+    paths = repo_spec.paths()[:: max(1, len(repo_spec.paths()) // 10)]
+    for path in paths:
+        (workdir / path).write_bytes(b'modified')
+    (workdir / 'untracked').write_bytes(b'untracked')
+    yield repo
+    (workdir / 'untracked').unlink()
+    repo.checkout_head(paths=paths, strategy=CheckoutStrategy.FORCE)
+
+
+def test_status(dirty: Repository, repo_spec: RepoSpec, measure: Measure) -> None:
+    measure(dirty.status, items=len(repo_spec.paths()))
+
+
+def test_status_raw(dirty: Repository, repo_spec: RepoSpec, measure: Measure) -> None:
+    measure(lambda: dirty.status(raw=True), items=len(repo_spec.paths()))
+
+
+def test_status_cache(dirty: Repository, repo_spec: RepoSpec, measure: Measure) -> None:
+    cache = StatusCache(dirty)
+    assert cache.refresh() == dirty.status()
+    measure(cache.refresh, items=len(repo_spec.paths()))
+
+
+@pytest.fixture
+def untracked(
+    dirty: Repository, repo_spec: RepoSpec
+) -> Generator[Repository, None, None]:
+    """Add an untracked copy of the tree layout, which `status()` walks on
+    every call and `StatusCache.refresh()` only when it changes."""
+    workdir = Path(dirty.workdir)
+    for path in repo_spec.paths():
+        path = workdir / 'untracked_tree' / path
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_bytes(b'untracked')
+    yield dirty
+    shutil.rmtree(workdir / 'untracked_tree')
+
+
+def test_status_untracked(
+    untracked: Repository, repo_spec: RepoSpec, measure: Measure
+) -> None:
+    measure(untracked.status, items=len(repo_spec.paths()))
+
+
+def test_status_cache_untracked(
+    untracked: Repository, repo_spec: RepoSpec, measure: Measure
+) -> None:
+    cache = StatusCache(untracked)
+    assert cache.refresh() == untracked.status()
+    measure(cache.refresh, items=len(repo_spec.paths()))
+    assert cache.refresh() == untracked.status()
+
+
+def test_blobio(repo: Repository, repo_spec: RepoSpec, measure: Measure) -> None:
+    tree = repo.head.peel(Tree)
+    paths = repo_spec.paths()[:1000]
+    blobs = [tree[path] for path in paths]
+
+    def read() -> int:
+        total = 0
+        for path, blob in zip(paths, blobs):
+            assert isinstance(blob, Blob)
+            with BlobIO(blob, as_path=path) as f:
+                total += len(f.read())
+        return total
+
+    measure(read, items=len(blobs))
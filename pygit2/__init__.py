@@ -123,6 +123,12 @@ from ._pygit2 import (
     GIT_DIFF_FLAG_VALID_SIZE,
     GIT_DIFF_FORCE_BINARY,
     GIT_DIFF_FORCE_TEXT,
+    GIT_DIFF_FORMAT_NAME_ONLY,
+    GIT_DIFF_FORMAT_NAME_STATUS,
+    GIT_DIFF_FORMAT_PATCH,
+    GIT_DIFF_FORMAT_PATCH_HEADER,
+    GIT_DIFF_FORMAT_PATCH_ID,
+    GIT_DIFF_FORMAT_RAW,
     GIT_DIFF_IGNORE_BLANK_LINES,
     GIT_DIFF_IGNORE_CASE,
     GIT_DIFF_IGNORE_FILEMODE,
@@ -244,11 +250,14 @@ from ._pygit2 import (
     GIT_SUBMODULE_STATUS_WD_UNINITIALIZED,
     GIT_SUBMODULE_STATUS_WD_UNTRACKED,
     GIT_SUBMODULE_STATUS_WD_WD_MODIFIED,
+    GIT_TREEWALK_POST,
+    GIT_TREEWALK_PRE,
     LIBGIT2_VER_MAJOR,
     LIBGIT2_VER_MINOR,
     LIBGIT2_VER_REVISION,
     LIBGIT2_VERSION,
     Blob,
+    BlobReader,
     Branch,
     Commit,
     Diff,
@@ -264,16 +273,23 @@ from ._pygit2 import (
     Odb,
     OdbBackend,
     OdbBackendLoose,
+    OdbBackendMemory,
     OdbBackendPack,
+    OdbObject,
     Oid,
+    OidMap,
+    OidSet,
     Patch,
     Refdb,
     RefdbBackend,
     RefdbFsBackend,
+    RefdbMemoryBackend,
     Reference,
     RefLogEntry,
+    RefsSnapshot,
     RevSpec,
     Signature,
+    SimilarityCache,
     Stash,
     Tag,
     Tree,
@@ -303,6 +319,7 @@ from .callbacks import (
 )
 from .config import Config
 from .credentials import *
+from .diff import DiffCache
 from .errors import (
     AlreadyExistsError,
     AmbiguousError,
@@ -372,6 +389,7 @@ from .rebase import Rebase, RebaseOperation
 from .remotes import Remote
 from .repository import Repository
 from .settings import Settings
+from .status import StatusCache
 from .submodules import Submodule
 from .transaction import ReferenceTransaction
 
@@ -603,6 +621,7 @@ __all__ = (
     'AmbiguousError',
     'AuthError',
     'Blob',
+    'BlobReader',
     'Branch',
     'CertificateError',
     'Commit',
@@ -619,17 +638,24 @@ __all__ = (
     'Note',
     'NotFoundError',
     'Odb',
+    'OdbObject',
     'OdbBackend',
     'OdbBackendLoose',
+    'OdbBackendMemory',
     'OdbBackendPack',
     'Oid',
+    'OidMap',
+    'OidSet',
     'Patch',
     'RefLogEntry',
     'Refdb',
     'RefdbBackend',
     'RefdbFsBackend',
+    'RefdbMemoryBackend',
+    'RefsSnapshot',
     'RevSpec',
     'Signature',
+    'SimilarityCache',
     'Stash',
     'Tag',
     'Tree',
@@ -733,6 +759,12 @@ __all__ = (
     'GIT_DIFF_FLAG_VALID_SIZE',
     'GIT_DIFF_FORCE_BINARY',
     'GIT_DIFF_FORCE_TEXT',
+    'GIT_DIFF_FORMAT_NAME_ONLY',
+    'GIT_DIFF_FORMAT_NAME_STATUS',
+    'GIT_DIFF_FORMAT_PATCH',
+    'GIT_DIFF_FORMAT_PATCH_HEADER',
+    'GIT_DIFF_FORMAT_PATCH_ID',
+    'GIT_DIFF_FORMAT_RAW',
     'GIT_DIFF_IGNORE_BLANK_LINES',
     'GIT_DIFF_IGNORE_CASE',
     'GIT_DIFF_IGNORE_FILEMODE',
@@ -896,6 +928,8 @@ __all__ = (
     'GIT_SUBMODULE_STATUS_WD_UNINITIALIZED',
     'GIT_SUBMODULE_STATUS_WD_UNTRACKED',
     'GIT_SUBMODULE_STATUS_WD_WD_MODIFIED',
+    'GIT_TREEWALK_POST',
+    'GIT_TREEWALK_PRE',
     # High level API.
     'enums',
     'blame',
@@ -921,6 +955,8 @@ __all__ = (
     'Keypair',
     'KeypairFromAgent',
     'KeypairFromMemory',
+    'diff',
+    'DiffCache',
     'errors',
     'check_error',
     'Passthrough',
@@ -945,6 +981,8 @@ __all__ = (
     'references',
     'settings',
     'Settings',
+    'status',
+    'StatusCache',
     'submodules',
     'Submodule',
     'transaction',
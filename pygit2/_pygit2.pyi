@@ -1,9 +1,10 @@
-from collections.abc import Iterator, Sequence
+from collections.abc import Iterable, Iterator, Sequence
 from io import DEFAULT_BUFFER_SIZE, IOBase
 from pathlib import Path
 from queue import Queue
 from threading import Event
 from typing import (  # noqa: UP035
+    BinaryIO,
     Generic,
     Literal,
     Optional,
@@ -30,6 +31,7 @@ from .enums import (
     DeltaStatus,
     DiffFind,
     DiffFlag,
+    DiffFormat,
     DiffOption,
     DiffStatsFormat,
     FileMode,
@@ -40,6 +42,7 @@ from .enums import (
     ReferenceType,
     ResetMode,
     SortMode,
+    TreeWalkMode,
 )
 from .filter import Filter
 
@@ -153,6 +156,12 @@ GIT_DIFF_STATS_FULL: int
 GIT_DIFF_STATS_SHORT: int
 GIT_DIFF_STATS_NUMBER: int
 GIT_DIFF_STATS_INCLUDE_SUMMARY: int
+GIT_DIFF_FORMAT_PATCH: int
+GIT_DIFF_FORMAT_PATCH_HEADER: int
+GIT_DIFF_FORMAT_RAW: int
+GIT_DIFF_FORMAT_NAME_ONLY: int
+GIT_DIFF_FORMAT_NAME_STATUS: int
+GIT_DIFF_FORMAT_PATCH_ID: int
 GIT_DIFF_FIND_BY_CONFIG: int
 GIT_DIFF_FIND_RENAMES: int
 GIT_DIFF_FIND_RENAMES_FROM_REWRITES: int
@@ -241,6 +250,8 @@ GIT_SUBMODULE_STATUS_WD_MODIFIED: int
 GIT_SUBMODULE_STATUS_WD_INDEX_MODIFIED: int
 GIT_SUBMODULE_STATUS_WD_WD_MODIFIED: int
 GIT_SUBMODULE_STATUS_WD_UNTRACKED: int
+GIT_TREEWALK_PRE: int
+GIT_TREEWALK_POST: int
 GIT_BLOB_FILTER_CHECK_FOR_BINARY: int
 GIT_BLOB_FILTER_NO_SYSTEM_ATTRIBUTES: int
 GIT_BLOB_FILTER_ATTRIBUTES_FROM_HEAD: int
@@ -367,6 +378,28 @@ class Blob(Object):
     ) -> None: ...
     def __buffer__(self, flags: int, /) -> memoryview: ...
 
+@final
+class BlobReader:
+    closed: bool
+    def __init__(
+        self,
+        blob: Blob,
+        as_path: Optional[str] = None,
+        flags: int = BlobFilter.CHECK_FOR_BINARY,
+        commit_id: Optional[_OidArg] = None,
+    ) -> None: ...
+    def close(self) -> None: ...
+    def flush(self) -> None: ...
+    def isatty(self) -> bool: ...
+    def read(self, size: int = -1, /) -> bytes: ...
+    def readable(self) -> bool: ...
+    def readall(self) -> bytes: ...
+    def readinto(self, b: bytearray | memoryview, /) -> int: ...
+    def seekable(self) -> bool: ...
+    def writable(self) -> bool: ...
+    def __enter__(self) -> BlobReader: ...
+    def __exit__(self, *args: object) -> None: ...
+
 @final
 class Branch(Reference):  # type: ignore[misc]
     branch_name: str
@@ -413,8 +446,14 @@ class Diff:
         rename_from_rewrite_threshold: int = 50,
         break_rewrite_threshold: int = 60,
         rename_limit: int = 1000,
+        cache: SimilarityCache | None = None,
+        max_pairs: int = 0,
+        timeout: float = 0,
     ) -> None: ...
     def merge(self, diff: Diff) -> None: ...
+    def write_patch(
+        self, file: int | BinaryIO, format: DiffFormat = DiffFormat.PATCH
+    ) -> int: ...
     @staticmethod
     def from_c(diff, repo) -> Diff: ...
     @staticmethod
@@ -453,6 +492,9 @@ class DiffHunk:
     new_start: int
     old_lines: int
     old_start: int
+    def __getitem__(self, index: int) -> DiffLine: ...
+    def __iter__(self) -> Iterator[DiffLine]: ...
+    def __len__(self) -> int: ...
 
 @final
 class DiffLine:
@@ -519,12 +561,31 @@ class Odb:
     def add_backend(self, backend: OdbBackend, priority: int) -> None: ...
     def add_disk_alternate(self, path: str | Path, /) -> None: ...
     def exists(self, oid: _OidArg, /) -> bool: ...
+    def objects(
+        self,
+        loose: bool = True,
+        packed: bool = True,
+        custom: bool = True,
+        packs: Iterable[str | Path] | None = None,
+    ) -> Iterator[Oid]: ...
     def read(self, oid: _OidArg, /) -> tuple[ObjectType, bytes]: ...
     def read_header(self, oid: _OidArg, /) -> tuple[ObjectType, int]: ...
+    def read_many(
+        self, oids: Iterable[_OidArg], /
+    ) -> list[tuple[ObjectType, bytes] | None]: ...
+    def read_object(self, oid: _OidArg, /) -> OdbObject: ...
     def write(self, type: int, data: bytes | str) -> Oid: ...
     def __contains__(self, other: _OidArg, /) -> bool: ...
     def __iter__(self) -> Iterator[Oid]: ...  # Odb_as_iter
 
+@final
+class OdbObject:
+    data: bytes
+    id: Oid
+    size: int
+    type: ObjectType
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+
 @disjoint_base
 class OdbBackend:
     def __init__(self, *args, **kwargs) -> None: ...
@@ -540,6 +601,13 @@ class OdbBackend:
 class OdbBackendLoose(OdbBackend):
     def __init__(self, *args, **kwargs) -> None: ...
 
+@final
+class OdbBackendMemory(OdbBackend):
+    nbytes: int
+    def __init__(self) -> None: ...
+    def write_pack(self, path: str | Path, /) -> str: ...
+    def __len__(self) -> int: ...
+
 @final
 class OdbBackendPack(OdbBackend):
     def __init__(self, *args, **kwargs) -> None: ...
@@ -557,6 +625,31 @@ class Oid:
     def __ne__(self, other, /) -> bool: ...
     def __bool__(self) -> bool: ...
 
+@final
+class OidSet:
+    def __init__(self, oids: Iterable[_OidArg] = ..., /) -> None: ...
+    def add(self, oid: _OidArg, /) -> None: ...
+    def clear(self) -> None: ...
+    def discard(self, oid: _OidArg, /) -> None: ...
+    def update(self, oids: Iterable[_OidArg], /) -> None: ...
+    def __contains__(self, oid: _OidArg, /) -> bool: ...
+    def __iter__(self) -> Iterator[Oid]: ...
+    def __len__(self) -> int: ...
+
+@final
+class OidMap(Generic[_T]):
+    def __init__(self) -> None: ...
+    def clear(self) -> None: ...
+    def get(self, oid: _OidArg, default: _T | None = None, /) -> _T | None: ...
+    def items(self) -> Iterator[tuple[Oid, _T]]: ...
+    def values(self) -> Iterator[_T]: ...
+    def __contains__(self, oid: _OidArg, /) -> bool: ...
+    def __delitem__(self, oid: _OidArg, /) -> None: ...
+    def __getitem__(self, oid: _OidArg, /) -> _T: ...
+    def __iter__(self) -> Iterator[Oid]: ...
+    def __len__(self) -> int: ...
+    def __setitem__(self, oid: _OidArg, value: _T, /) -> None: ...
+
 @final
 class Patch:
     data: bytes
@@ -565,6 +658,7 @@ class Patch:
     line_stats: tuple[int, int, int]  # context, additions, deletions
     text: str | None
 
+    def line_table(self) -> dict[str, bytes | memoryview]: ...
     @staticmethod
     def create_from(
         old: Blob | bytes | None,
@@ -627,6 +721,26 @@ class RefdbBackend:
 class RefdbFsBackend(RefdbBackend):
     def __init__(self, *args, **kwargs) -> None: ...
 
+@final
+class RefdbMemoryBackend(RefdbBackend):
+    def __init__(
+        self, base: RefdbBackend | None = None, reflog: bool = False
+    ) -> None: ...
+    def reflog(self, name: str, /) -> list[RefLogEntry]: ...
+
+@final
+class RefsSnapshot:
+    names: memoryview
+    name_offsets: memoryview
+    targets: memoryview
+    symbolic: memoryview
+    symbolic_offsets: memoryview
+    peeled: memoryview | None
+    def diff(
+        self, other: RefsSnapshot, /
+    ) -> tuple[list[str], list[str], list[str]]: ...
+    def __len__(self) -> int: ...
+
 _Proxy = None | Literal[True] | str
 
 class _StrArray:
@@ -668,7 +782,13 @@ class Repository:
     def apply(
         self, diff: Diff, location: ApplyLocation = ApplyLocation.WORKDIR
     ) -> None: ...
+    def changed_paths(
+        self, commits: Walker | Iterable[_OidArg], threads: int = 1
+    ) -> dict[str, memoryview | list[str]]: ...
     def cherrypick(self, id: _OidArg, /) -> None: ...
+    def commit_table(
+        self, commits: Walker | Iterable[_OidArg], /
+    ) -> dict[str, memoryview]: ...
     def compress_references(self) -> None: ...
     def create_blob(self, data: str | bytes) -> Oid: ...
     def create_blob_fromdisk(self, path: str, /) -> Oid: ...
@@ -719,6 +839,9 @@ class Repository:
     def expand_id(self, hex: str, /) -> Oid: ...
     def free(self) -> None: ...
     def git_object_lookup_prefix(self, oid: _OidArg, /) -> Object: ...
+    def lookup_many(
+        self, oids: Iterable[_OidArg], type: ObjectType | None = None
+    ) -> list[Object | None]: ...
     def list_worktrees(self) -> list[str]: ...
     def listall_branches(self, flag: BranchType = BranchType.LOCAL) -> list[str]: ...
     def listall_mergeheads(self) -> list[Oid]: ...
@@ -745,24 +868,69 @@ class Repository:
         self, flag: BranchType = BranchType.LOCAL
     ) -> list[bytes]: ...
     def raw_listall_references(self) -> list[bytes]: ...
-    def references_iterator_init(self) -> Iterator[Reference]: ...
+    def references_iterator_init(
+        self, glob: str | None = None
+    ) -> Iterator[Reference]: ...
     def references_iterator_next(
         self,
         iter: Iterator[_T],
         references_return_type: ReferenceFilter = ReferenceFilter.ALL,
     ) -> Reference: ...
+    @overload
+    def references_iterator_next_many(
+        self,
+        iter: Iterator[_T],
+        n: int,
+        references_return_type: ReferenceFilter = ReferenceFilter.ALL,
+        names_only: Literal[False] = False,
+    ) -> list[Reference]: ...
+    @overload
+    def references_iterator_next_many(
+        self,
+        iter: Iterator[_T],
+        n: int,
+        references_return_type: ReferenceFilter = ReferenceFilter.ALL,
+        *,
+        names_only: Literal[True],
+    ) -> list[str]: ...
+    def refs_snapshot(
+        self, prefix: str | None = None, peel: bool = False
+    ) -> RefsSnapshot: ...
     def reset(self, oid: _OidArg, reset_type: ResetMode) -> None: ...
     def revparse(self, revspec: str, /) -> RevSpec: ...
     def revparse_ext(self, revision: str, /) -> tuple[Object, Reference]: ...
     def revparse_single(self, revision: str, /) -> Object: ...
     def set_odb(self, odb: Odb, /) -> None: ...
     def set_refdb(self, refdb: Refdb, /) -> None: ...
+    @overload
     def status(
-        self, untracked_files: str = 'all', ignored: bool = False
+        self,
+        untracked_files: str = 'all',
+        ignored: bool = False,
+        pathspec: str | Iterable[str | bytes] | None = None,
+        raw: Literal[False] = False,
     ) -> dict[str, int]: ...
+    @overload
+    def status(
+        self,
+        untracked_files: str = 'all',
+        ignored: bool = False,
+        pathspec: str | Iterable[str | bytes] | None = None,
+        *,
+        raw: Literal[True],
+    ) -> list[tuple[bytes, int]]: ...
     def status_file(self, path: str, /) -> int: ...
+    def update_refs(
+        self,
+        updates: Iterable[tuple[str, _OidArg | None, _OidArg | None]],
+        atomic: bool = True,
+        message: str | None = None,
+    ) -> list[str]: ...
     def walk(
-        self, oid: _OidArg | None, sort_mode: SortMode = SortMode.NONE
+        self,
+        oid: _OidArg | None,
+        sort_mode: SortMode = SortMode.NONE,
+        yield_ids: bool = False,
     ) -> Walker: ...
 
 @disjoint_base
@@ -796,6 +964,15 @@ class Signature:
     def __lt__(self, other, /) -> bool: ...
     def __ne__(self, other, /) -> bool: ...
 
+@final
+class SimilarityCache:
+    hits: int
+    maxsize: int
+    misses: int
+    def __init__(self, maxsize: int = 4096) -> None: ...
+    def clear(self) -> None: ...
+    def __len__(self) -> int: ...
+
 @final
 class Stash:
     commit_id: Oid
@@ -840,6 +1017,40 @@ class Tree(Object):
         context_lines: int = 3,
         interhunk_lines: int = 0,
     ) -> Diff: ...
+    @overload
+    def walk(
+        self,
+        mode: TreeWalkMode = TreeWalkMode.PRE,
+        include_blobs: bool = True,
+        pathspec: str | bytes | Iterable[str | bytes] | None = None,
+        columns: Literal[False] = False,
+        threads: int = 1,
+    ) -> list[tuple[bytes, int, Oid]]: ...
+    @overload
+    def walk(
+        self,
+        mode: TreeWalkMode = TreeWalkMode.PRE,
+        include_blobs: bool = True,
+        pathspec: str | bytes | Iterable[str | bytes] | None = None,
+        *,
+        columns: Literal[True],
+        threads: int = 1,
+    ) -> dict[str, bytes | memoryview]: ...
+    def lookup_paths(
+        self, paths: Iterable[str | bytes]
+    ) -> list[tuple[Oid, int] | None]: ...
+    def _grep(
+        self,
+        literal: bytes,
+        pathspec: str | bytes | Iterable[str | bytes] | None = None,
+        threads: int = 1,
+        ignore_case: bool = False,
+    ) -> list[tuple[bytes, int, bytes]]: ...
+    def _grep_lines(
+        self,
+        pathspec: str | bytes | Iterable[str | bytes] | None = None,
+        threads: int = 1,
+    ) -> list[tuple[bytes, list[bytes]]]: ...
     def __contains__(self, other: str, /) -> bool: ...  # Tree_contains
     def __getitem__(self, index: str | int, /) -> Tree | Blob: ...  # Tree_subscript
     def __iter__(self) -> Iterator[Object]: ...
@@ -859,6 +1070,11 @@ class TreeBuilder:
 @final
 class Walker:
     def hide(self, oid: _OidArg, /) -> None: ...
+    @overload
+    def next_batch(self, n: int, raw: Literal[False] = False) -> list[Oid]: ...
+    @overload
+    def next_batch(self, n: int, raw: Literal[True]) -> bytes: ...
+    def oids(self) -> Walker: ...
     def push(self, oid: _OidArg, /) -> None: ...
     def reset(self) -> None: ...
     def simplify_first_parent(self) -> None: ...
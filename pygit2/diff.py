@@ -0,0 +1,130 @@
+# Copyright 2010-2026 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+import threading
+from collections import OrderedDict
+
+from ._pygit2 import Diff, Oid, Tree
+from .enums import DiffOption
+
+# Options which only apply to the working directory or the index, and so
+# don't change a diff between two trees
+_WORKDIR_OPTIONS = (
+    DiffOption.INCLUDE_IGNORED
+    | DiffOption.RECURSE_IGNORED_DIRS
+    | DiffOption.INCLUDE_UNTRACKED
+    | DiffOption.RECURSE_UNTRACKED_DIRS
+    | DiffOption.ENABLE_FAST_UNTRACKED_DIRS
+    | DiffOption.UPDATE_INDEX
+    | DiffOption.INCLUDE_UNREADABLE
+    | DiffOption.INCLUDE_UNREADABLE_AS_UNTRACKED
+    | DiffOption.SHOW_UNTRACKED_CONTENT
+)
+
+_Key = tuple[Oid, Oid, int, int, int]
+
+
+class DiffCache:
+    """Least recently used cache of diffs between two trees.
+
+    Diffing the same pair of trees again returns the same `Diff` object,
+    whose `stats` and `patchid` are only computed once. Attach one to a
+    repository to make `Repository.diff()` use it::
+
+        >>> repo.diff_cache = DiffCache(maxsize=256)
+        >>> repo.diff('main', 'feature')  # computed
+        >>> repo.diff('main', 'feature')  # from the cache
+        >>> repo.diff_cache.hits, repo.diff_cache.misses
+        (1, 1)
+
+    The cached diffs are shared: `Diff.find_similar()` and `Diff.merge()`
+    change them for every later user. Diff the trees directly, with
+    `Tree.diff_to_tree()`, to get a diff of your own to modify.
+    """
+
+    def __init__(self, maxsize: int = 128) -> None:
+        """
+        Parameters:
+
+        maxsize
+            The maximum number of diffs kept.
+        """
+        if maxsize < 1:
+            raise ValueError('maxsize must be at least 1')
+
+        self.maxsize = maxsize
+        self.hits = 0
+        self.misses = 0
+        self._diffs: OrderedDict[_Key, Diff] = OrderedDict()
+        self._lock = threading.Lock()
+
+    def __len__(self) -> int:
+        return len(self._diffs)
+
+    def get(
+        self,
+        a: Tree,
+        b: Tree,
+        flags: DiffOption = DiffOption.NORMAL,
+        context_lines: int = 3,
+        interhunk_lines: int = 0,
+    ) -> Diff:
+        """Return the diff from tree `a` to tree `b`, computing it with
+        `Tree.diff_to_tree()` if it is not in the cache."""
+        key = (
+            a.id,
+            b.id,
+            int(flags) & ~_WORKDIR_OPTIONS,
+            context_lines,
+            interhunk_lines,
+        )
+        with self._lock:
+            diff = self._diffs.get(key)
+            if diff is not None:
+                self._diffs.move_to_end(key)
+                self.hits += 1
+                return diff
+            self.misses += 1
+
+        # Computed without the lock, so other diffs can be served meanwhile
+        diff = a.diff_to_tree(
+            b,
+            flags=flags,
+            context_lines=context_lines,
+            interhunk_lines=interhunk_lines,
+        )
+        with self._lock:
+            self._diffs[key] = diff
+            self._diffs.move_to_end(key)
+            while len(self._diffs) > self.maxsize:
+                self._diffs.popitem(last=False)
+        return diff
+
+    def clear(self) -> None:
+        """Drop all the diffs, and reset the counters."""
+        with self._lock:
+            self._diffs.clear()
+            self.hits = 0
+            self.misses = 0
@@ -464,6 +464,28 @@ class DiffFlag(IntFlag):
     'file size value is known correct'
 
 
+class DiffFormat(IntEnum):
+    """Output formats for `Diff.write_patch()`"""
+
+    PATCH = _pygit2.GIT_DIFF_FORMAT_PATCH
+    'Full unified diff, equivalent of `git diff`'
+
+    PATCH_HEADER = _pygit2.GIT_DIFF_FORMAT_PATCH_HEADER
+    'The file headers of the patch only'
+
+    RAW = _pygit2.GIT_DIFF_FORMAT_RAW
+    'Equivalent of `git diff --raw`'
+
+    NAME_ONLY = _pygit2.GIT_DIFF_FORMAT_NAME_ONLY
+    'Equivalent of `git diff --name-only`'
+
+    NAME_STATUS = _pygit2.GIT_DIFF_FORMAT_NAME_STATUS
+    'Equivalent of `git diff --name-status`'
+
+    PATCH_ID = _pygit2.GIT_DIFF_FORMAT_PATCH_ID
+    'Patch contents as used to compute the patch id, equivalent of `git patch-id`'
+
+
 class DiffOption(IntFlag):
     """
     Flags for diff options.  A combination of these flags can be passed
@@ -1329,3 +1351,13 @@ class SubmoduleStatus(IntFlag):
 
     WD_UNTRACKED = _pygit2.GIT_SUBMODULE_STATUS_WD_UNTRACKED
     'submodule workdir contains untracked files (flag available if ignore is NONE)'
+
+
+class TreeWalkMode(IntEnum):
+    """Order of the entries returned by `Tree.walk()`"""
+
+    PRE = _pygit2.GIT_TREEWALK_PRE
+    'Trees come before their entries'
+
+    POST = _pygit2.GIT_TREEWALK_POST
+    'Trees come after their entries'
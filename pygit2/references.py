@@ -37,6 +37,14 @@ if TYPE_CHECKING:
     from ._pygit2 import Reference
     from .repository import BaseRepository
 
+# References are fetched from the iterators this many at a time
+_BATCH_SIZE = 256
+
+_FILTER_GLOBS = {
+    ReferenceFilter.BRANCHES: 'refs/heads/*',
+    ReferenceFilter.TAGS: 'refs/tags/*',
+}
+
 
 class References:
     def __init__(self, repository: BaseRepository) -> None:
@@ -52,16 +60,32 @@ class References:
             return None
 
     def __iter__(self) -> Iterator[str]:
-        iter = self._repository.references_iterator_init()
+        return self.names()
+
+    def names(self, glob: str | None = None) -> Iterator[str]:
+        """Iterate over the names of the references, without loading them.
+
+        Parameters:
+
+        glob
+            Optional pattern the names must match, e.g. 'refs/remotes/origin/*'.
+            The reference database uses it to skip the other references, so
+            iterating over a few references of a large repository is cheap.
+        """
+        repository = self._repository
+        iter = repository.references_iterator_init(glob)
         while True:
-            ref = self._repository.references_iterator_next(iter)
-            if ref:
-                yield ref.name
-            else:
+            names = repository.references_iterator_next_many(
+                iter, _BATCH_SIZE, names_only=True
+            )
+            if not names:
                 return
+            yield from names
 
     def iterator(
-        self, references_return_type: ReferenceFilter = ReferenceFilter.ALL
+        self,
+        references_return_type: ReferenceFilter = ReferenceFilter.ALL,
+        glob: str | None = None,
     ) -> Iterator['Reference']:
         """Creates a new iterator and fetches references for a given repository.
 
@@ -78,21 +102,30 @@ class References:
             - ReferenceFilter.BRANCHES, fetches only branches
             - ReferenceFilter.TAGS, fetches only tags
 
+        glob
+            Optional pattern the reference names must match, e.g.
+            'refs/remotes/origin/*'. Like the filter, it is applied by the
+            reference database, which only reads the matching references.
+
         TODO: Add support for filtering by reference types notes and remotes.
         """
 
         # Enforce ReferenceFilter type - raises ValueError if we're given an invalid value
         references_return_type = ReferenceFilter(references_return_type)
 
-        iter = self._repository.references_iterator_init()
+        # Without a glob of its own, the filter is pushed down as a glob
+        if glob is None:
+            glob = _FILTER_GLOBS.get(references_return_type)
+
+        repository = self._repository
+        iter = repository.references_iterator_init(glob)
         while True:
-            ref = self._repository.references_iterator_next(
-                iter, references_return_type
+            refs = repository.references_iterator_next_many(
+                iter, _BATCH_SIZE, references_return_type
             )
-            if ref:
-                yield ref
-            else:
+            if not refs:
                 return
+            yield from refs
 
     def create(self, name: str, target: Oid | str, force: bool = False) -> 'Reference':
         return self._repository.create_reference(name, target, force)
@@ -23,13 +23,17 @@
 # the Free Software Foundation, 51 Franklin Street, Fifth Floor,
 # Boston, MA 02110-1301, USA.
 
+import re
 import tarfile
 import warnings
-from collections.abc import Callable, Iterator
+import zipfile
+from collections.abc import Callable, Iterable, Iterator
+from concurrent.futures import ThreadPoolExecutor
 from io import BytesIO
+from itertools import islice
 from pathlib import Path
 from string import hexdigits
-from time import time
+from time import localtime, time
 from typing import TYPE_CHECKING, Literal, Optional, overload
 
 # Import from pygit2
@@ -37,6 +41,7 @@ from ._pygit2 import (
     GIT_OID_HEXSZ,
     GIT_OID_MINPREFIXLEN,
     Blob,
+    BlobReader,
     Commit,
     Diff,
     InvalidSpecError,
@@ -45,6 +50,7 @@ from ._pygit2 import (
     Patch,
     Reference,
     Signature,
+    SimilarityCache,
     Tree,
     init_file_backend,
 )
@@ -57,6 +63,7 @@ from .callbacks import (
     git_stash_apply_options,
 )
 from .config import Config
+from .diff import DiffCache
 from .enums import (
     AttrCheck,
     BlameFlag,
@@ -103,6 +110,71 @@ if TYPE_CHECKING:
     from pygit2._pygit2 import Odb, Refdb, RefdbBackend
 
 
+# Characters with a special meaning in regular expressions
+_REGEX_SPECIAL = frozenset(b'.^$*+?{}[]()|\\')
+
+
+def _regex_literal(pattern: bytes) -> bytes:
+    """Return the longest literal every match of pattern contains, used to
+    find the candidate lines before running the regular expression.
+
+    The parse is conservative: patterns with alternatives or inline flags
+    have no literal, and neither have groups nor character classes. The
+    parse stops at escapes other than escaped punctuation, like `\\x41` or
+    `\\d`.
+    """
+    if b'|' in pattern or b'(?' in pattern:
+        return b''
+
+    best = b''
+    run = bytearray()
+    depth = 0
+    i = 0
+    while i < len(pattern):
+        c = pattern[i]
+        i += 1
+        if c not in _REGEX_SPECIAL and c != ord('\n'):
+            if depth == 0:
+                run.append(c)
+            continue
+
+        if c in b'*?{':
+            # The previous character is optional
+            del run[-1:]
+            if c == ord('{'):
+                end = pattern.find(b'}', i)
+                i = i if end < 0 else end + 1
+        elif c == ord('\\'):
+            escaped = pattern[i : i + 1]
+            if not escaped or escaped.isalnum() or escaped == b'\n':
+                break
+            i += 1
+            if depth == 0:
+                run.append(escaped[0])
+            continue
+        elif c == ord('['):
+            # Skip the class, a ']' first is part of it
+            if pattern[i : i + 1] == b'^':
+                i += 1
+            if pattern[i : i + 1] == b']':
+                i += 1
+            while i < len(pattern) and pattern[i] != ord(']'):
+                i += 2 if pattern[i] == ord('\\') else 1
+            i += 1
+        elif c == ord('('):
+            depth += 1
+        elif c == ord(')'):
+            depth -= 1
+
+        if len(run) > len(best):
+            best = bytes(run)
+        run.clear()
+
+    if len(run) > len(best):
+        best = bytes(run)
+    return best
+
+
 class BaseRepository(_Repository):
     _pointer: '_Pointer[GitRepositoryC]'
     _repo: 'GitRepositoryC'
@@ -122,6 +194,8 @@ class BaseRepository(_Repository):
     remotes: RemoteCollection
     branches: Branches
     submodules: SubmoduleCollection
+    diff_cache: Optional[DiffCache]
+    similarity_cache: Optional[SimilarityCache]
 
     def __init__(self, *args, **kwargs) -> None:
         super().__init__(*args, **kwargs)
@@ -133,6 +207,8 @@ class BaseRepository(_Repository):
         self.remotes = RemoteCollection(self)
         self.submodules = SubmoduleCollection(self)
         self._active_transaction = None
+        self.diff_cache = None
+        self.similarity_cache = None
 
         # Get the pointer as the contents of a buffer and store it for
         # later access
@@ -653,6 +729,9 @@ class BaseRepository(_Repository):
 
         If you want to diff a tree against an empty tree, use the low level
         API (Tree.diff_to_tree()) directly.
+
+        Diffs between two trees are taken from `diff_cache`, if it is set to
+        a `DiffCache`.
         """
 
         a = self.__whatever_to_tree_or_blob(a)
@@ -666,6 +745,8 @@ class BaseRepository(_Repository):
 
         # Case 1: Diff tree to tree
         if isinstance(a, Tree) and isinstance(b, Tree):
+            if self.diff_cache is not None:
+                return self.diff_cache.get(a, b, **options)  # type: ignore[arg-type]
             return a.diff_to_tree(b, **options)  # type: ignore[arg-type]
 
         # Case 2: Index to workdir
@@ -1617,12 +1698,50 @@ class BaseRepository(_Repository):
     #
     # Utility for writing a tree into an archive
     #
+    def _archive_entries(
+        self, tree: Tree, base: str = ''
+    ) -> Iterator[tuple[str, int, Oid]]:
+        """Yield (path, mode, id) for the files below tree, depth first."""
+        for entry in tree:
+            path = base + entry.name  # type: ignore[operator]
+            if isinstance(entry, Tree):
+                yield from self._archive_entries(entry, path + '/')
+            elif entry.filemode != FileMode.COMMIT:
+                yield path, entry.filemode, entry.id
+
+    def _archive_read(
+        self, entries: list[tuple[str, int, Oid]], filters: bool
+    ) -> list[bytes]:
+        """Read the contents of a batch of archive entries."""
+        ids = [oid for path, mode, oid in entries]
+        if not filters:
+            contents = []
+            for oid, item in zip(ids, self.odb.read_many(ids)):
+                if item is None:
+                    raise KeyError(str(oid))
+                contents.append(item[1])
+            return contents
+
+        contents = []
+        for (path, mode, oid), blob in zip(entries, self.lookup_many(ids)):
+            if blob is None:
+                raise KeyError(str(oid))
+            if mode == FileMode.LINK:
+                contents.append(blob.data)
+            else:
+                reader = BlobReader(blob, as_path=path)
+                contents.append(reader.readall())
+                reader.close()
+        return contents
+
     def write_archive(
         self,
         treeish: str | Tree | Object | Oid,
-        archive: tarfile.TarFile,
+        archive: tarfile.TarFile | zipfile.ZipFile,
         timestamp: int | None = None,
         prefix: str = '',
+        filters: bool = False,
+        batch_size: int = 256,
     ) -> None:
         """
         Write treeish into an archive.
@@ -1633,13 +1752,19 @@ class BaseRepository(_Repository):
         All path names in the archive are added to 'prefix', which defaults to
         an empty string.
 
+        The tree is walked directly, and the contents of the files are read
+        in batches on a worker thread, without holding the GIL, while the
+        previous batch is written to the archive. At most two batches are in
+        memory at once.
+
         Parameters:
 
         treeish
             The treeish to write.
 
         archive
-            An archive from the 'tarfile' module.
+            An archive from the 'tarfile' module (plain or compressed), or
+            from the 'zipfile' module.
 
         timestamp
             Timestamp to use for the files in the archive.
@@ -1647,10 +1772,17 @@ class BaseRepository(_Repository):
         prefix
             Extra prefix to add to the path names in the archive.
 
+        filters
+            If True, apply the filters a checkout would (e.g. end of line
+            conversion, smudge filters) to the contents of the files.
+
+        batch_size
+            Number of files read ahead at once.
+
         Example::
 
             >>> import tarfile, pygit2
-            >>> with tarfile.open('foo.tar', 'w') as archive:
+            >>> with tarfile.open('foo.tar.gz', 'w:gz') as archive:
             >>>     repo = pygit2.Repository('.')
             >>>     repo.write_archive(repo.head.target, archive)
         """
@@ -1673,24 +1805,132 @@ class BaseRepository(_Repository):
         if not timestamp:
             timestamp = int(time())
 
-        index = Index()
-        index.read_tree(tree)
-
-        for entry in index:
-            content = self[entry.id].read_raw()
-            info = tarfile.TarInfo(prefix + entry.path)
-            info.size = len(content)
-            info.mtime = timestamp
-            info.uname = info.gname = 'root'  # just because git does this
-            if entry.mode == FileMode.LINK:
-                info.type = tarfile.SYMTYPE
-                info.linkname = content.decode('utf-8')
-                info.mode = 0o777  # symlinks get placeholder
-                info.size = 0
-                archive.addfile(info)
-            else:
-                info.mode = entry.mode
-                archive.addfile(info, BytesIO(content))
+        # zip can't represent dates before 1980
+        date_time = max(localtime(timestamp)[:6], (1980, 1, 1, 0, 0, 0))
+
+        entries = self._archive_entries(tree)
+        with ThreadPoolExecutor(max_workers=1) as executor:
+            batch = list(islice(entries, batch_size))
+            future = executor.submit(self._archive_read, batch, filters)
+            while batch:
+                contents = future.result()
+                # Read the next batch while this one is written
+                next_batch = list(islice(entries, batch_size))
+                future = executor.submit(self._archive_read, next_batch, filters)
+
+                for (path, mode, oid), content in zip(batch, contents):
+                    path = prefix + path
+                    if isinstance(archive, zipfile.ZipFile):
+                        zinfo = zipfile.ZipInfo(path, date_time=date_time)
+                        zinfo.external_attr = (
+                            0o120777 if mode == FileMode.LINK else mode
+                        ) << 16
+                        archive.writestr(
+                            zinfo,
+                            content,
+                            compress_type=archive.compression,
+                            compresslevel=archive.compresslevel,
+                        )
+                        continue
+
+                    info = tarfile.TarInfo(path)
+                    info.size = len(content)
+                    info.mtime = timestamp
+                    info.uname = info.gname = 'root'  # just because git does this
+                    if mode == FileMode.LINK:
+                        info.type = tarfile.SYMTYPE
+                        info.linkname = content.decode('utf-8')
+                        info.mode = 0o777  # symlinks get placeholder
+                        info.size = 0
+                        archive.addfile(info)
+                    else:
+                        info.mode = mode
+                        archive.addfile(info, BytesIO(content))
+
+                batch = next_batch
+
+    #
+    # Content search
+    #
+    def grep(
+        self,
+        treeish: str | Tree | Object | Oid,
+        pattern: str | bytes,
+        pathspec: str | bytes | Iterable[str | bytes] | None = None,
+        threads: int = 1,
+        fixed_strings: bool = False,
+        flags: int = 0,
+    ) -> list[tuple[bytes, int, bytes]]:
+        """Search the files of treeish for lines matching pattern, like
+        `git grep`, and return them as `(path, line_number, line)` tuples in
+        bytes, without the end of line, sorted by path and line number.
+
+        The tree is walked and the files are read and searched in C,
+        without the GIL, unless the object database has a backend
+        implemented in Python. Binary files are skipped. The lines are
+        first found with the longest literal the pattern requires, ignoring
+        the case with `re.IGNORECASE`, and the regular expression is only
+        run on these. Patterns without such a literal, or with `re.VERBOSE`
+        or `re.LOCALE`, are run on every line; the files are still read and
+        split in C, only the regular expression runs with the GIL held.
+
+        Parameters:
+
+        treeish
+            The commit, tree, or anything which peels to a tree, to search.
+
+        pattern
+            A regular expression, in the syntax of the `re` module, matched
+            against every line. Given as str it is encoded to UTF-8.
+
+        pathspec
+            Patterns restricting the files searched, as in `Tree.walk()`.
+
+        threads
+            The number of native threads reading and searching the files.
+
+        fixed_strings
+            If True pattern is a plain string, not a regular expression.
+
+        flags
+            Flags for `re.compile()`, e.g. `re.IGNORECASE`.
+
+        Example::
+
+            >>> for path, lineno, line in repo.grep('HEAD', 'def main', '*.py'):
+            ...     print(f'{path.decode()}:{lineno}: {line.decode()}')
+        """
+        if isinstance(treeish, (str, Oid)):
+            treeish = self[treeish]
+        tree = treeish.peel(Tree)
+
+        if isinstance(pattern, str):
+            pattern = pattern.encode('utf-8')
+
+        ignore_case = bool(flags & re.IGNORECASE)
+        if fixed_strings and flags in (0, re.IGNORECASE):
+            return tree._grep(pattern, pathspec, threads, ignore_case)
+        if fixed_strings:
+            pattern = re.escape(pattern)
+
+        regex = re.compile(pattern, flags)
+        if flags & (re.VERBOSE | re.LOCALE):
+            literal = b''
+        else:
+            literal = _regex_literal(pattern)
+
+        if not literal:
+            return [
+                (path, lineno, line)
+                for path, lines in tree._grep_lines(pathspec, threads)
+                for lineno, line in enumerate(lines, 1)
+                if regex.search(line)
+            ]
+
+        lines = tree._grep(literal, pathspec, threads, ignore_case)
+        if literal == pattern:
+            return lines
+        return [match for match in lines if regex.search(match[2])]
 
     #
     # Ahead-behind, which mostly lives on its own namespace
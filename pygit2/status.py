@@ -0,0 +1,247 @@
+# Copyright 2010-2026 The pygit2 contributors
+#
+# This file is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License, version 2,
+# as published by the Free Software Foundation.
+#
+# In addition to the permissions in the GNU General Public License,
+# the authors give you unlimited permission to link the compiled
+# version of this file into combinations with other programs,
+# and to distribute those combinations without any restriction
+# coming from the use of this file.  (The General Public License
+# restrictions do apply in other respects; for example, they cover
+# modification of the file, and distribution when not linked into
+# a combined executable.)
+#
+# This file is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+# Boston, MA 02110-1301, USA.
+
+import os
+import time
+from typing import TYPE_CHECKING, Optional
+
+from ._pygit2 import GitError
+from .enums import FileStatus
+
+if TYPE_CHECKING:
+    from .repository import BaseRepository
+
+# Entries modified this recently (in nanoseconds) may change again without
+# their timestamps changing, so they are checked on every refresh.
+_RACY_NS = 2_000_000_000
+
+# Files in the git directory whose changes invalidate the whole cache
+_STATE_FILES = ('index', 'HEAD', 'config', os.path.join('info', 'exclude'))
+
+_Signature = Optional[tuple[int, int, int, int, int]]
+
+
+def _is_under(path: bytes, directory: bytes) -> bool:
+    return path == directory or path.startswith(directory + b'/')
+
+
+class StatusCache:
+    """Status of a working directory, refreshed incrementally.
+
+    Finding the untracked files is usually the most expensive part of the
+    status, as every directory of the working directory must be read and
+    every entry matched against the ignore rules. The first call to
+    `refresh()` computes the full status and remembers the modification
+    times of the directories; later calls only look for untracked files in
+    the directories whose modification time changed.
+
+    The tracked files are checked against the index on every refresh, so
+    changes to them are always seen, even inside ignored directories.
+
+    Any change to the index, the HEAD, the configuration or the ignore
+    rules makes the next refresh compute the full status again. Untracked
+    files inside submodules are only seen by a full refresh, see
+    `invalidate()`.
+
+    Example::
+
+        >>> cache = StatusCache(repo)
+        >>> while True:
+        ...     status = cache.refresh()
+        ...     time.sleep(1)
+    """
+
+    def __init__(
+        self,
+        repo: 'BaseRepository',
+        untracked_files: str = 'all',
+        ignored: bool = False,
+    ) -> None:
+        """
+        Parameters:
+
+        repo
+            The repository, it must have a working directory.
+
+        untracked_files, ignored
+            Same as in `Repository.status()`.
+        """
+        if repo.workdir is None:
+            raise ValueError('the repository has no working directory')
+
+        self._repo = repo
+        self._workdir = os.fsencode(repo.workdir)
+        self._untracked_files = untracked_files
+        self._ignored = ignored
+        self._state: Optional[tuple] = None
+        self._scan_start = 0
+        self._dirs: dict[bytes, _Signature] = {}
+        self._ignore_files: dict[bytes, _Signature] = {}
+        # Untracked and ignored entries, the tracked ones are not cached
+        self._untracked: dict[bytes, int] = {}
+
+    def invalidate(self) -> None:
+        """Make the next refresh compute the full status."""
+        self._state = None
+
+    def refresh(self, raw: bool = False) -> dict[str, FileStatus] | dict[bytes, int]:
+        """Return the current status, as `Repository.status()` does.
+
+        If `raw` is True the paths are bytes and the flags plain integers.
+        """
+        state = self._repo_state()
+        status = None
+        if state == self._state and self._refresh_untracked():
+            status = dict(self._repo.status('no', False, raw=True))
+            status.update(self._untracked)
+        if status is None:
+            status = self._refresh_all()
+            self._state = state
+
+        if raw:
+            return status
+        return {os.fsdecode(path): FileStatus(flags) for path, flags in status.items()}
+
+    #
+    # Private
+    #
+    def _repo_state(self) -> tuple:
+        try:
+            head = self._repo.head.target
+        except GitError:
+            head = None
+
+        stats = []
+        for name in _STATE_FILES:
+            try:
+                st = os.stat(os.path.join(self._repo.path, name))
+            except OSError:
+                stats.append(None)
+            else:
+                stats.append((st.st_mtime_ns, st.st_size, st.st_ino))
+        return (head, *stats)
+
+    def _path(self, relpath: bytes) -> bytes:
+        return os.path.join(self._workdir, relpath) if relpath else self._workdir
+
+    def _signature(self, relpath: bytes) -> _Signature:
+        try:
+            st = os.lstat(self._path(relpath))
+        except OSError:
+            return None
+        return (st.st_mtime_ns, st.st_ctime_ns, st.st_size, st.st_ino, st.st_mode)
+
+    def _record(self, mapping: dict[bytes, _Signature], relpath: bytes) -> None:
+        sig = self._signature(relpath)
+        # Recently modified entries are checked again next time
+        if sig is not None and sig[0] >= self._scan_start - _RACY_NS:
+            sig = None
+        mapping[relpath] = sig
+
+    def _changed(self, mapping: dict[bytes, _Signature]) -> list[bytes]:
+        return [
+            relpath
+            for relpath, sig in mapping.items()
+            if sig is None or sig != self._signature(relpath)
+        ]
+
+    def _scan(self, directory: bytes) -> None:
+        """Record the directories below directory where untracked files may
+        appear, and the ignore files in them."""
+        try:
+            entries = list(os.scandir(self._path(directory)))
+        except OSError:
+            return
+
+        self._record(self._dirs, directory)
+        for entry in entries:
+            relpath = directory + b'/' + entry.name if directory else entry.name
+            if not entry.is_dir(follow_symlinks=False):
+                if entry.name == b'.gitignore':
+                    self._record(self._ignore_files, relpath)
+            elif entry.name == b'.git':
+                continue
+            elif not self._ignored and self._repo.path_is_ignored(os.fsdecode(relpath)):
+                # Tracked files in here are checked against the index
+                continue
+            elif os.path.lexists(os.path.join(entry.path, b'.git')):
+                # Nested repositories (submodules) are not walked
+                self._record(self._dirs, relpath)
+            else:
+                self._scan(relpath)
+
+    def _refresh_all(self) -> dict[bytes, int]:
+        self._scan_start = time.time_ns()
+        self._dirs = {}
+        self._ignore_files = {}
+        status = dict(self._repo.status(self._untracked_files, self._ignored, raw=True))
+        self._untracked = {
+            path: flags
+            for path, flags in status.items()
+            if flags & (FileStatus.WT_NEW | FileStatus.IGNORED)
+        }
+        if self._untracked_files != 'no' or self._ignored:
+            self._scan(b'')
+        return status
+
+    def _refresh_untracked(self) -> bool:
+        """Update the untracked and ignored entries of the directories which
+        changed since the last refresh, returns False if the full status
+        must be computed instead."""
+        if self._changed(self._ignore_files):
+            return False
+
+        # Keep the outermost directories
+        changed_dirs: list[bytes] = []
+        for relpath in sorted(self._changed(self._dirs)):
+            if relpath == b'':
+                return False
+            # Paths are passed as patterns, give up on the few which would
+            # not match themselves
+            if any(c in relpath for c in (b'*', b'?', b'[', b'\\')):
+                return False
+            if not changed_dirs or not _is_under(relpath, changed_dirs[-1]):
+                changed_dirs.append(relpath)
+        if not changed_dirs:
+            return True
+
+        self._scan_start = time.time_ns()
+        for directory in changed_dirs:
+            for mapping in (self._untracked, self._dirs, self._ignore_files):
+                for relpath in [p for p in mapping if _is_under(p, directory)]:
+                    del mapping[relpath]
+            ignore_files = len(self._ignore_files)
+            self._scan(directory)
+            # New ignore files may change the status anywhere
+            if len(self._ignore_files) != ignore_files:
+                return False
+
+        status = self._repo.status(
+            self._untracked_files, self._ignored, pathspec=changed_dirs, raw=True
+        )
+        for path, flags in status:
+            if flags & (FileStatus.WT_NEW | FileStatus.IGNORED):
+                self._untracked[path] = flags
+        return True
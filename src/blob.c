@@ -33,7 +33,9 @@
 #include "error.h"
 #include "object.h"
 #include "oid.h"
+#include "odb.h"
 #include "patch.h"
+#include "refdb_backend.h"
 #include "utils.h"
 
 extern PyObject *GitError;
@@ -89,9 +91,11 @@ Blob_diff(Blob *self, PyObject *args, PyObject *kwds)
     if (Object__load((Object*)self) == NULL) { return NULL; } // Lazy load
     if (other && Object__load((Object*)other) == NULL) { return NULL; } // Lazy load
 
+    PGIT_BEGIN_ALLOW_THREADS_IF(repository_odb_allows_threads(self->repo->repo))
     err = git_patch_from_blobs(&patch, self->blob, old_as_path,
                                other ? other->blob : NULL, new_as_path,
                                &opts);
+    PGIT_END_ALLOW_THREADS_IF
     if (err < 0)
         return Error_set(err);
 
@@ -139,9 +143,11 @@ Blob_diff_to_buffer(Blob *self, PyObject *args, PyObject *kwds)
 
     if (Object__load((Object*)self) == NULL) { return NULL; } // Lazy load
 
+    PGIT_BEGIN_ALLOW_THREADS_IF(repository_odb_allows_threads(self->repo->repo))
     err = git_patch_from_blob_and_buffer(&patch, self->blob, old_as_path,
                                          buffer, buffer_len, buffer_as_path,
                                          &opts);
+    PGIT_END_ALLOW_THREADS_IF
     if (err < 0)
         return Error_set(err);
 
@@ -422,12 +428,23 @@ PyDoc_STRVAR(Blob_data__doc__,
     "    >>> print(blob.data)\n"
     "    MANIFEST\n"
     "    build\n"
-    "    dist\n");
+    "    dist\n"
+    "\n"
+    "This makes a copy of the contents, use `memoryview(blob)` to access\n"
+    "them without copying.\n");
+
+PyObject *
+Blob_data__get__(Blob *self)
+{
+    if (Object__load((Object*)self) == NULL) { return NULL; } // Lazy load
+    return PyBytes_FromStringAndSize(git_blob_rawcontent(self->blob),
+                                     git_blob_rawsize(self->blob));
+}
 
 PyGetSetDef Blob_getseters[] = {
     GETTER(Blob, size),
     GETTER(Blob, is_binary),
-    {"data", (getter)Object_read_raw, NULL, Blob_data__doc__, NULL},
+    GETTER(Blob, data),
     {NULL}
 };
 
@@ -490,3 +507,317 @@ PyTypeObject BlobType = {
     0,                                         /* tp_alloc          */
     0,                                         /* tp_new            */
 };
+
+
+/*
+ * BlobReader
+ */
+
+static void
+BlobReader__close(BlobReader *self)
+{
+    Py_CLEAR(self->blob);
+    git_buf_dispose(&self->filtered);
+    self->data = NULL;
+    self->size = 0;
+    self->pos = 0;
+    self->closed = 1;
+}
+
+static PyObject *
+BlobReader__check_closed(BlobReader *self)
+{
+    if (self->closed) {
+        PyErr_SetString(PyExc_ValueError, "I/O operation on closed file.");
+        return NULL;
+    }
+    return (PyObject *)self;
+}
+
+static int
+BlobReader_init(BlobReader *self, PyObject *args, PyObject *kwds)
+{
+    Blob *py_blob;
+    char *as_path = NULL;
+    PyObject *py_oid = NULL;
+    git_blob_filter_options opts = GIT_BLOB_FILTER_OPTIONS_INIT;
+    int err;
+    char *keywords[] = {"blob", "as_path", "flags", "commit_id", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!|zIO", keywords,
+                                     &BlobType, &py_blob, &as_path,
+                                     &opts.flags, &py_oid))
+        return -1;
+
+    BlobReader__close(self);
+
+    if (Object__load((Object*)py_blob) == NULL) { return -1; } // Lazy load
+
+    if (as_path != NULL &&
+        !((opts.flags & GIT_BLOB_FILTER_CHECK_FOR_BINARY) != 0 &&
+          git_blob_is_binary(py_blob->blob)))
+    {
+        if (py_oid != NULL && py_oid != Py_None) {
+            if (py_oid_to_git_oid(py_oid, &opts.attr_commit_id) == 0)
+                return -1;
+        }
+
+        /* The attributes may be read from HEAD, through the refdb */
+        PGIT_BEGIN_ALLOW_THREADS_IF(
+            refdb_allows_threads() &&
+            repository_odb_allows_threads(git_blob_owner(py_blob->blob)))
+        err = git_blob_filter(&self->filtered, py_blob->blob, as_path, &opts);
+        PGIT_END_ALLOW_THREADS_IF
+        if (err < 0) {
+            Error_set(err);
+            return -1;
+        }
+
+        self->data = self->filtered.ptr;
+        self->size = self->filtered.size;
+    } else {
+        self->data = git_blob_rawcontent(py_blob->blob);
+        self->size = (size_t)git_blob_rawsize(py_blob->blob);
+    }
+
+    Py_INCREF(py_blob);
+    self->blob = py_blob;
+    self->closed = 0;
+    return 0;
+}
+
+static void
+BlobReader_dealloc(BlobReader *self)
+{
+    BlobReader__close(self);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+PyDoc_STRVAR(BlobReader_readinto__doc__,
+  "readinto(b: bytearray | memoryview) -> int\n"
+  "\n"
+  "Read bytes into the writable buffer `b`. Returns the number of bytes\n"
+  "read, 0 at the end of the contents.");
+
+PyObject *
+BlobReader_readinto(BlobReader *self, PyObject *py_buffer)
+{
+    Py_buffer view;
+    size_t n;
+
+    if (BlobReader__check_closed(self) == NULL)
+        return NULL;
+
+    if (PyObject_GetBuffer(py_buffer, &view, PyBUF_WRITABLE) < 0)
+        return NULL;
+
+    n = self->size - self->pos;
+    if ((size_t)view.len < n)
+        n = (size_t)view.len;
+    memcpy(view.buf, self->data + self->pos, n);
+    self->pos += n;
+
+    PyBuffer_Release(&view);
+    return PyLong_FromSize_t(n);
+}
+
+static PyObject *
+BlobReader__read(BlobReader *self, Py_ssize_t size)
+{
+    size_t n;
+    PyObject *py_bytes;
+
+    if (BlobReader__check_closed(self) == NULL)
+        return NULL;
+
+    n = self->size - self->pos;
+    if (size >= 0 && (size_t)size < n)
+        n = (size_t)size;
+
+    py_bytes = PyBytes_FromStringAndSize(self->data + self->pos, n);
+    if (py_bytes != NULL)
+        self->pos += n;
+    return py_bytes;
+}
+
+PyDoc_STRVAR(BlobReader_read__doc__,
+  "read(size: int = -1) -> bytes\n"
+  "\n"
+  "Read up to `size` bytes, or everything left if `size` is negative.");
+
+PyObject *
+BlobReader_read(BlobReader *self, PyObject *args)
+{
+    Py_ssize_t size = -1;
+
+    if (!PyArg_ParseTuple(args, "|n", &size))
+        return NULL;
+
+    return BlobReader__read(self, size);
+}
+
+PyDoc_STRVAR(BlobReader_readall__doc__,
+  "readall() -> bytes\n"
+  "\n"
+  "Read everything left.");
+
+PyObject *
+BlobReader_readall(BlobReader *self)
+{
+    return BlobReader__read(self, -1);
+}
+
+PyDoc_STRVAR(BlobReader_readable__doc__, "readable() -> bool");
+
+PyObject *
+BlobReader_readable(BlobReader *self)
+{
+    Py_RETURN_TRUE;
+}
+
+PyDoc_STRVAR(BlobReader_writable__doc__, "writable() -> bool");
+
+PyObject *
+BlobReader_writable(BlobReader *self)
+{
+    Py_RETURN_FALSE;
+}
+
+PyDoc_STRVAR(BlobReader_seekable__doc__, "seekable() -> bool");
+
+PyObject *
+BlobReader_seekable(BlobReader *self)
+{
+    Py_RETURN_FALSE;
+}
+
+PyDoc_STRVAR(BlobReader_isatty__doc__, "isatty() -> bool");
+
+PyObject *
+BlobReader_isatty(BlobReader *self)
+{
+    Py_RETURN_FALSE;
+}
+
+PyDoc_STRVAR(BlobReader_flush__doc__, "flush() -> None");
+
+PyObject *
+BlobReader_flush(BlobReader *self)
+{
+    if (BlobReader__check_closed(self) == NULL)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(BlobReader_close__doc__,
+  "close() -> None\n"
+  "\n"
+  "Release the blob and the filtered contents.");
+
+PyObject *
+BlobReader_close(BlobReader *self)
+{
+    BlobReader__close(self);
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(BlobReader___enter____doc__, "__enter__() -> BlobReader");
+
+PyObject *
+BlobReader___enter__(BlobReader *self)
+{
+    if (BlobReader__check_closed(self) == NULL)
+        return NULL;
+    Py_INCREF(self);
+    return (PyObject *)self;
+}
+
+PyDoc_STRVAR(BlobReader___exit____doc__, "__exit__(*args) -> None");
+
+PyObject *
+BlobReader___exit__(BlobReader *self, PyObject *args)
+{
+    BlobReader__close(self);
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef BlobReader_methods[] = {
+    METHOD(BlobReader, readinto, METH_O),
+    METHOD(BlobReader, read, METH_VARARGS),
+    METHOD(BlobReader, readall, METH_NOARGS),
+    METHOD(BlobReader, readable, METH_NOARGS),
+    METHOD(BlobReader, writable, METH_NOARGS),
+    METHOD(BlobReader, seekable, METH_NOARGS),
+    METHOD(BlobReader, isatty, METH_NOARGS),
+    METHOD(BlobReader, flush, METH_NOARGS),
+    METHOD(BlobReader, close, METH_NOARGS),
+    METHOD(BlobReader, __enter__, METH_NOARGS),
+    METHOD(BlobReader, __exit__, METH_VARARGS),
+    {NULL}
+};
+
+PyDoc_STRVAR(BlobReader_closed__doc__, "True if the reader is closed.");
+
+PyObject *
+BlobReader_closed__get__(BlobReader *self)
+{
+    return PyBool_FromLong(self->closed);
+}
+
+PyGetSetDef BlobReader_getseters[] = {
+    GETTER(BlobReader, closed),
+    {NULL}
+};
+
+PyDoc_STRVAR(BlobReader__doc__,
+  "BlobReader(blob: Blob, as_path: str = None, flags: enums.BlobFilter = enums.BlobFilter.CHECK_FOR_BINARY, commit_id: Oid = None)\n"
+  "\n"
+  "Raw, read-only stream over the contents of a blob, implementing the\n"
+  "io.RawIOBase interface.\n"
+  "\n"
+  "If `as_path` is None the raw contents of the blob are read in place,\n"
+  "without copying them. Otherwise the blob is filtered as if it had that\n"
+  "path, once, without holding the GIL, and the filtered contents are read.\n"
+  "\n"
+  "In most cases the buffered `BlobIO` wrapper should be used instead.");
+
+PyTypeObject BlobReaderType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.BlobReader",                      /* tp_name           */
+    sizeof(BlobReader),                        /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)BlobReader_dealloc,            /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    BlobReader__doc__,                         /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    BlobReader_methods,                        /* tp_methods        */
+    0,                                         /* tp_members        */
+    BlobReader_getseters,                      /* tp_getset         */
+    0,                                         /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    (initproc)BlobReader_init,                 /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
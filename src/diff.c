@@ -30,11 +30,21 @@
 #include <structmember.h>
 #include "diff.h"
 #include "error.h"
+#include "odb.h"
 #include "oid.h"
 #include "patch.h"
+#include "similarity.h"
 #include "types.h"
 #include "utils.h"
 
+#ifdef _WIN32
+#include <io.h>
+#define pgit_write _write
+#else
+#include <unistd.h>
+#define pgit_write write
+#endif
+
 extern PyObject *GitError;
 
 extern PyTypeObject TreeType;
@@ -44,8 +54,10 @@ extern PyTypeObject DiffDeltaType;
 extern PyTypeObject DiffFileType;
 extern PyTypeObject DiffHunkType;
 extern PyTypeObject DiffLineType;
+extern PyTypeObject DiffLinesIterType;
 extern PyTypeObject DiffStatsType;
 extern PyTypeObject RepositoryType;
+extern PyTypeObject SimilarityCacheType;
 
 extern PyObject *DeltaStatusEnum;
 extern PyObject *DiffFlagEnum;
@@ -61,6 +73,9 @@ wrap_diff(git_diff *diff, Repository *repo)
         Py_XINCREF(repo);
         py_diff->repo = repo;
         py_diff->diff = diff;
+        py_diff->stats = NULL;
+        py_diff->patchid = NULL;
+        py_diff->busy = 0;
     }
 
     return (PyObject*) py_diff;
@@ -141,14 +156,47 @@ wrap_diff_hunk(Patch *patch, size_t idx)
     return (PyObject *) py_hunk;
 }
 
+/*
+ * Whether the GIL can be released while libgit2 works on the diff, which
+ * may read blobs from the object database. Parsed diffs have no repository.
+ */
+static int
+diff_allows_threads(Diff *self)
+{
+    return self->repo == NULL || repository_odb_allows_threads(self->repo->repo);
+}
+
+/*
+ * While the GIL is released libgit2 changes the diff: find_similar rewrites
+ * its deltas, and loading the blobs updates their flags. The diff is marked
+ * busy meanwhile, and the other threads get an error instead of a race.
+ */
+int
+diff_check_busy(Diff *diff)
+{
+    if (diff->busy) {
+        PyErr_SetString(PyExc_RuntimeError, "the diff is in use by another thread");
+        return -1;
+    }
+
+    return 0;
+}
+
 PyObject *
-wrap_diff_stats(git_diff *diff)
+wrap_diff_stats(Diff *self)
 {
     git_diff_stats *stats;
     DiffStats *py_stats;
     int err;
 
-    err = git_diff_get_stats(&stats, diff);
+    if (diff_check_busy(self) < 0)
+        return NULL;
+
+    self->busy = 1;
+    PGIT_BEGIN_ALLOW_THREADS_IF(diff_allows_threads(self))
+    err = git_diff_get_stats(&stats, self->diff);
+    PGIT_END_ALLOW_THREADS_IF
+    self->busy = 0;
     if (err < 0)
         return Error_set(err);
 
@@ -335,6 +383,9 @@ DiffDelta_ensure_flags(DiffDelta *self)
     if (self->flags & (GIT_DIFF_FLAG_BINARY | GIT_DIFF_FLAG_NOT_BINARY))
         return 0;
 
+    if (diff_check_busy(self->diff) < 0)
+        return GIT_EUSER;
+
     err = git_patch_from_diff(&patch, self->diff->diff, self->idx);
     if (err < 0)
         return err;
@@ -603,8 +654,11 @@ diff_get_patch_byindex(git_diff *diff, size_t idx)
 PyObject *
 DiffIter_iternext(DiffIter *self)
 {
-    if (self->i < self->n)
+    if (self->i < self->n) {
+        if (diff_check_busy(self->diff) < 0)
+            return NULL;
         return diff_get_patch_byindex(self->diff->diff, self->i++);
+    }
 
     PyErr_SetNone(PyExc_StopIteration);
     return NULL;
@@ -665,8 +719,11 @@ diff_get_delta_byindex(git_diff *diff, size_t idx, Diff *parent)
 PyObject *
 DeltasIter_iternext(DeltasIter *self)
 {
-    if (self->i < self->n)
+    if (self->i < self->n) {
+        if (diff_check_busy(self->diff) < 0)
+            return NULL;
         return diff_get_delta_byindex(self->diff->diff, self->i++, self->diff);
+    }
 
     PyErr_SetNone(PyExc_StopIteration);
     return NULL;
@@ -716,11 +773,14 @@ Py_ssize_t
 Diff_len(Diff *self)
 {
     assert(self->diff);
+    if (diff_check_busy(self) < 0)
+        return -1;
     return (Py_ssize_t)git_diff_num_deltas(self->diff);
 }
 
 PyDoc_STRVAR(Diff_patchid__doc__,
-    "Corresponding patchid.");
+    "Corresponding patchid. Computed once, until the diff is changed by\n"
+    "find_similar() or merge().");
 
 PyObject *
 Diff_patchid__get__(Diff *self)
@@ -728,10 +788,20 @@ Diff_patchid__get__(Diff *self)
     git_oid oid;
     int err;
 
-    err = git_diff_patchid(&oid, self->diff, NULL);
-    if (err < 0)
-        return Error_set(err);
-    return git_oid_to_python(&oid);
+    if (self->patchid == NULL) {
+        if (diff_check_busy(self) < 0)
+            return NULL;
+        err = git_diff_patchid(&oid, self->diff, NULL);
+        if (err < 0)
+            return Error_set(err);
+
+        self->patchid = git_oid_to_python(&oid);
+        if (self->patchid == NULL)
+            return NULL;
+    }
+
+    Py_INCREF(self->patchid);
+    return self->patchid;
 }
 
 
@@ -742,6 +812,9 @@ Diff_deltas__get__(Diff *self)
 {
     DeltasIter *iter;
 
+    if (diff_check_busy(self) < 0)
+        return NULL;
+
     iter = PyObject_New(DeltasIter, &DeltasIterType);
     if (iter != NULL) {
         Py_INCREF(self);
@@ -760,6 +833,9 @@ Diff_patch__get__(Diff *self)
 {
     git_buf buf = {NULL};
 
+    if (diff_check_busy(self) < 0)
+        return NULL;
+
     int err = git_diff_to_buf(&buf, self->diff, GIT_DIFF_FORMAT_PATCH);
     if (err < 0)
         return Error_set(err);
@@ -771,6 +847,197 @@ Diff_patch__get__(Diff *self)
 }
 
 
+/*
+ * Streaming output for Diff.write_patch: the lines are gathered in a fixed
+ * size buffer, which is written to the file descriptor without the GIL, or
+ * passed to the file object's write method, taking the GIL back meanwhile.
+ */
+#define DIFF_WRITER_SIZE (64 * 1024)
+
+typedef struct {
+    PyObject *file;         /* NULL when writing to fd */
+    int fd;
+    PyThreadState *save;    /* Set while the GIL is released */
+    char *data;
+    size_t size;
+    Py_ssize_t written;
+    int err_no;
+} diff_writer;
+
+static int
+diff_writer_write(diff_writer *writer, const char *data, size_t size)
+{
+    PyObject *result;
+    Py_ssize_t n;
+
+    if (writer->file == NULL) {
+        while (size > 0) {
+            n = pgit_write(writer->fd, data, size > INT_MAX ? INT_MAX : (unsigned int)size);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                writer->err_no = errno;
+                return -1;
+            }
+            data += n;
+            size -= (size_t)n;
+            writer->written += n;
+        }
+        return 0;
+    }
+
+    if (writer->save)
+        PyEval_RestoreThread(writer->save);
+
+    while (size > 0) {
+        result = PyObject_CallMethod(writer->file, "write", "y#", data, (Py_ssize_t)size);
+        if (result == NULL)
+            break;
+
+        /* Raw streams may write less than asked for */
+        n = PyLong_Check(result) ? PyLong_AsSsize_t(result) : (Py_ssize_t)size;
+        Py_DECREF(result);
+        if (n <= 0 || (size_t)n > size) {
+            if (!PyErr_Occurred())
+                PyErr_SetString(PyExc_OSError, "file object did not write any bytes");
+            break;
+        }
+        data += n;
+        size -= (size_t)n;
+        writer->written += n;
+    }
+
+    if (writer->save)
+        writer->save = PyEval_SaveThread();
+
+    return size > 0 ? -1 : 0;
+}
+
+static int
+diff_writer_flush(diff_writer *writer)
+{
+    size_t size = writer->size;
+
+    writer->size = 0;
+    return diff_writer_write(writer, writer->data, size);
+}
+
+static int
+diff_writer_append(diff_writer *writer, const char *data, size_t size)
+{
+    if (writer->size + size > DIFF_WRITER_SIZE && diff_writer_flush(writer) < 0)
+        return -1;
+
+    if (size > DIFF_WRITER_SIZE)
+        return diff_writer_write(writer, data, size);
+
+    memcpy(writer->data + writer->size, data, size);
+    writer->size += size;
+    return 0;
+}
+
+static int
+diff_writer_line_cb(const git_diff_delta *delta, const git_diff_hunk *hunk,
+                    const git_diff_line *line, void *payload)
+{
+    diff_writer *writer = payload;
+    char origin = line->origin;
+
+    /* Same output as git_diff_to_buf */
+    if (origin == GIT_DIFF_LINE_ADDITION || origin == GIT_DIFF_LINE_DELETION ||
+        origin == GIT_DIFF_LINE_CONTEXT) {
+        if (diff_writer_append(writer, &origin, 1) < 0)
+            return -1;
+    }
+
+    return diff_writer_append(writer, line->content, line->content_len);
+}
+
+PyDoc_STRVAR(Diff_write_patch__doc__,
+  "write_patch(file: int | BinaryIO, format: enums.DiffFormat = enums.DiffFormat.PATCH) -> int\n"
+  "\n"
+  "Write the diff to a file descriptor, or to a binary file object, and\n"
+  "return the number of bytes written. The output is streamed in chunks of\n"
+  "64 KiB instead of being built in memory, as `Diff.patch` does.\n"
+  "\n"
+  "Writing to a file descriptor is done without holding the GIL, unless the\n"
+  "object database has a backend implemented in Python. Writing to a file\n"
+  "object takes the GIL back for every chunk.\n"
+  "\n"
+  "Parameters:\n"
+  "\n"
+  "file\n"
+  "    A file descriptor, or an object with a `write` method accepting\n"
+  "    bytes, like a file opened in binary mode or a socket file.\n"
+  "\n"
+  "format\n"
+  "    One of the `enums.DiffFormat` values: PATCH (the default),\n"
+  "    PATCH_HEADER, PATCH_ID, RAW, NAME_ONLY or NAME_STATUS.\n");
+
+PyObject *
+Diff_write_patch(Diff *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"file", "format", NULL};
+    PyObject *py_file;
+    unsigned int format = GIT_DIFF_FORMAT_PATCH;
+    diff_writer writer = {NULL, -1, NULL, NULL, 0, 0, 0};
+    int allow_threads, err;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|I", keywords, &py_file, &format))
+        return NULL;
+
+    if (PyLong_Check(py_file)) {
+        long fd = PyLong_AsLong(py_file);
+        if (fd == -1 && PyErr_Occurred())
+            return NULL;
+        if (fd < 0 || fd > INT_MAX) {
+            PyErr_SetString(PyExc_ValueError, "invalid file descriptor");
+            return NULL;
+        }
+        writer.fd = (int)fd;
+    }
+    else if (PyObject_HasAttrString(py_file, "write")) {
+        writer.file = py_file;
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError, "expected a file descriptor or a file object");
+        return NULL;
+    }
+
+    if (diff_check_busy(self) < 0)
+        return NULL;
+
+    writer.data = malloc(DIFF_WRITER_SIZE);
+    if (writer.data == NULL)
+        return PyErr_NoMemory();
+
+    /* The GIL is also taken back to write to file objects */
+    self->busy = 1;
+    allow_threads = diff_allows_threads(self);
+    writer.save = allow_threads ? PyEval_SaveThread() : NULL;
+    err = git_diff_print(self->diff, format, diff_writer_line_cb, &writer);
+    if (err == 0)
+        err = diff_writer_flush(&writer);
+    if (writer.save)
+        PyEval_RestoreThread(writer.save);
+    self->busy = 0;
+
+    free(writer.data);
+
+    if (err < 0) {
+        if (PyErr_Occurred())
+            return NULL;
+        if (writer.err_no) {
+            errno = writer.err_no;
+            return PyErr_SetFromErrno(PyExc_OSError);
+        }
+        return Error_set(err);
+    }
+
+    return PyLong_FromSsize_t(writer.written);
+}
+
+
 static void
 DiffHunk_dealloc(DiffHunk *self)
 {
@@ -819,40 +1086,95 @@ DiffHunk_header__get__(DiffHunk *self)
                         self->hunk->header_len, NULL, NULL);
 }
 
-PyDoc_STRVAR(DiffHunk_lines__doc__, "Lines.");
+static PyObject *
+diff_hunk_get_line(DiffHunk *self, size_t i)
+{
+    const git_diff_line *line;
+    int err;
+
+    err = git_patch_get_line_in_hunk(&line, self->patch->patch, self->idx, i);
+    if (err < 0)
+        return Error_set(err);
+
+    return wrap_diff_line(line, self);
+}
+
+PyDoc_STRVAR(DiffHunk_lines__doc__,
+  "Lines, as a list. Iterating over the hunk instead creates the DiffLine\n"
+  "objects one at a time.");
 
 PyObject *
 DiffHunk_lines__get__(DiffHunk *self)
 {
     PyObject *py_lines;
     PyObject *py_line;
-    const git_diff_line *line;
     size_t i;
-    int err;
 
-    // TODO Replace by an iterator
     py_lines = PyList_New(self->n_lines);
     if (py_lines == NULL)
         return NULL;
 
     for (i = 0; i < self->n_lines; ++i) {
-        err = git_patch_get_line_in_hunk(&line, self->patch->patch, self->idx, i);
-        if (err < 0) {
-            Py_DECREF(py_lines);
-            return Error_set(err);
-        }
-
-        py_line = wrap_diff_line(line, self);
+        py_line = diff_hunk_get_line(self, i);
         if (py_line == NULL) {
             Py_DECREF(py_lines);
             return NULL;
         }
 
-        PyList_SetItem(py_lines, i, py_line);
-   }
-   return py_lines;
+        PyList_SET_ITEM(py_lines, i, py_line);
+    }
+    return py_lines;
 }
 
+Py_ssize_t
+DiffHunk_len(DiffHunk *self)
+{
+    return (Py_ssize_t)self->n_lines;
+}
+
+PyObject *
+DiffHunk_getitem(DiffHunk *self, PyObject *value)
+{
+    Py_ssize_t i;
+
+    if (!PyIndex_Check(value)) {
+        PyErr_SetString(PyExc_TypeError, "line index must be an integer");
+        return NULL;
+    }
+
+    i = PyNumber_AsSsize_t(value, PyExc_IndexError);
+    if (i == -1 && PyErr_Occurred())
+        return NULL;
+    if (i < 0)
+        i += (Py_ssize_t)self->n_lines;
+    if (i < 0 || (size_t)i >= self->n_lines) {
+        PyErr_SetString(PyExc_IndexError, "line index out of range");
+        return NULL;
+    }
+
+    return diff_hunk_get_line(self, (size_t)i);
+}
+
+PyObject *
+DiffHunk_iter(DiffHunk *self)
+{
+    DiffLinesIter *iter;
+
+    iter = PyObject_New(DiffLinesIter, &DiffLinesIterType);
+    if (iter != NULL) {
+        Py_INCREF(self);
+        iter->hunk = self;
+        iter->i = 0;
+        iter->n = self->n_lines;
+    }
+    return (PyObject*)iter;
+}
+
+PyMappingMethods DiffHunk_as_mapping = {
+    (lenfunc)DiffHunk_len,           /* mp_length */
+    (binaryfunc)DiffHunk_getitem,    /* mp_subscript */
+    0,                               /* mp_ass_subscript */
+};
 
 PyGetSetDef DiffHunk_getsetters[] = {
     GETTER(DiffHunk, old_start),
@@ -879,7 +1201,7 @@ PyTypeObject DiffHunkType = {
     0,                                         /* tp_repr           */
     0,                                         /* tp_as_number      */
     0,                                         /* tp_as_sequence    */
-    0,                                         /* tp_as_mapping     */
+    &DiffHunk_as_mapping,                      /* tp_as_mapping     */
     0,                                         /* tp_hash           */
     0,                                         /* tp_call           */
     0,                                         /* tp_str            */
@@ -892,7 +1214,7 @@ PyTypeObject DiffHunkType = {
     0,                                         /* tp_clear          */
     0,                                         /* tp_richcompare    */
     0,                                         /* tp_weaklistoffset */
-    0,                                         /* tp_iter           */
+    (getiterfunc)DiffHunk_iter,                /* tp_iter           */
     0,                                         /* tp_iternext       */
     0,                                         /* tp_methods        */
     0,                                         /* tp_members        */
@@ -907,6 +1229,55 @@ PyTypeObject DiffHunkType = {
     0,                                         /* tp_new            */
 };
 
+PyObject *
+DiffLinesIter_iternext(DiffLinesIter *self)
+{
+    if (self->i < self->n)
+        return diff_hunk_get_line(self->hunk, self->i++);
+
+    PyErr_SetNone(PyExc_StopIteration);
+    return NULL;
+}
+
+void
+DiffLinesIter_dealloc(DiffLinesIter *self)
+{
+    Py_CLEAR(self->hunk);
+    PyObject_Del(self);
+}
+
+PyDoc_STRVAR(DiffLinesIter__doc__, "Diff hunk lines iterator object.");
+
+PyTypeObject DiffLinesIterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.DiffLinesIter",                   /* tp_name           */
+    sizeof(DiffLinesIter),                     /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)DiffLinesIter_dealloc,         /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    DiffLinesIter__doc__,                      /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    PyObject_SelfIter,                         /* tp_iter           */
+    (iternextfunc) DiffLinesIter_iternext,     /* tp_iternext       */
+};
+
 PyDoc_STRVAR(DiffStats_insertions__doc__, "Total number of insertions");
 
 PyObject *
@@ -1077,16 +1448,22 @@ Diff_merge(Diff *self, PyObject *args)
     if (!PyArg_ParseTuple(args, "O!", &DiffType, &py_diff))
         return NULL;
 
+    if (diff_check_busy(self) < 0 || diff_check_busy(py_diff) < 0)
+        return NULL;
+
     err = git_diff_merge(self->diff, py_diff->diff);
     if (err < 0)
         return Error_set(err);
 
+    Py_CLEAR(self->stats);
+    Py_CLEAR(self->patchid);
+
     Py_RETURN_NONE;
 }
 
 
 PyDoc_STRVAR(Diff_find_similar__doc__,
-  "find_similar(flags: enums.DiffFind = enums.DiffFind.FIND_BY_CONFIG, rename_threshold: int = 50, copy_threshold: int = 50, rename_from_rewrite_threshold: int = 50, break_rewrite_threshold: int = 60, rename_limit: int = 1000)\n"
+  "find_similar(flags: enums.DiffFind = enums.DiffFind.FIND_BY_CONFIG, rename_threshold: int = 50, copy_threshold: int = 50, rename_from_rewrite_threshold: int = 50, break_rewrite_threshold: int = 60, rename_limit: int = 1000, cache: SimilarityCache | None = None, max_pairs: int = 0, timeout: float = 0)\n"
   "\n"
   "Transform a diff marking file renames, copies, etc.\n"
   "\n"
@@ -1095,7 +1472,17 @@ PyDoc_STRVAR(Diff_find_similar__doc__,
   "will, if requested, break modified files into add/remove pairs if the "
   "amount of change is above a threshold.\n"
   "\n"
-  "flags - Combination of enums.DiffFind.FIND_* and enums.DiffFind.BREAK_* constants."
+  "flags - Combination of enums.DiffFind.FIND_* and enums.DiffFind.BREAK_* constants.\n"
+  "\n"
+  "cache - A SimilarityCache keeping the signatures of the blobs compared,\n"
+  "by default the `similarity_cache` of the repository, if any.\n"
+  "\n"
+  "max_pairs, timeout - A budget for the search, in pairs of files compared\n"
+  "and in seconds (0 means no limit). Once it is spent, the remaining files\n"
+  "are only matched if their contents are identical.\n"
+  "\n"
+  "The GIL is released during the search, meanwhile using the diff from\n"
+  "other threads raises RuntimeError."
   );
 
 PyObject *
@@ -1103,21 +1490,73 @@ Diff_find_similar(Diff *self, PyObject *args, PyObject *kwds)
 {
     int err;
     git_diff_find_options opts = GIT_DIFF_FIND_OPTIONS_INIT;
+    similarity_run run;
+    PyObject *py_cache = Py_None;
+    SimilarityCache *cache = NULL;
+    Py_ssize_t max_pairs = 0;
+    double timeout = 0;
 
     char *keywords[] = {"flags", "rename_threshold", "copy_threshold",
                         "rename_from_rewrite_threshold",
-                        "break_rewrite_threshold", "rename_limit", NULL};
+                        "break_rewrite_threshold", "rename_limit",
+                        "cache", "max_pairs", "timeout", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iHHHHI", keywords,
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|iHHHHIOnd", keywords,
             &opts.flags, &opts.rename_threshold, &opts.copy_threshold,
             &opts.rename_from_rewrite_threshold, &opts.break_rewrite_threshold,
-            &opts.rename_limit))
+            &opts.rename_limit, &py_cache, &max_pairs, &timeout))
         return NULL;
 
+    if (max_pairs < 0 || timeout < 0) {
+        PyErr_SetString(PyExc_ValueError, "max_pairs and timeout must not be negative");
+        return NULL;
+    }
+
+    if (diff_check_busy(self) < 0)
+        return NULL;
+
+    /* The cache of the repository, if it has one */
+    if (py_cache == Py_None && self->repo != NULL) {
+        py_cache = PyObject_GetAttrString((PyObject *)self->repo, "similarity_cache");
+        if (py_cache == NULL) {
+            if (!PyErr_ExceptionMatches(PyExc_AttributeError))
+                return NULL;
+            PyErr_Clear();
+            py_cache = Py_None;
+            Py_INCREF(py_cache);
+        }
+    } else {
+        Py_INCREF(py_cache);
+    }
+
+    if (py_cache != Py_None) {
+        if (!PyObject_TypeCheck(py_cache, &SimilarityCacheType)) {
+            PyErr_SetString(PyExc_TypeError, "cache must be a SimilarityCache");
+            Py_DECREF(py_cache);
+            return NULL;
+        }
+        cache = (SimilarityCache *)py_cache;
+        if (cache->lock == NULL)
+            cache = NULL;
+    }
+
+    if (cache || max_pairs > 0 || timeout > 0) {
+        similarity_run_init(&run, cache, opts.flags, (size_t)max_pairs, timeout);
+        opts.metric = &run.metric;
+    }
+
+    self->busy = 1;
+    PGIT_BEGIN_ALLOW_THREADS_IF(diff_allows_threads(self))
     err = git_diff_find_similar(self->diff, &opts);
+    PGIT_END_ALLOW_THREADS_IF
+    self->busy = 0;
+    Py_DECREF(py_cache);
     if (err < 0)
         return Error_set(err);
 
+    Py_CLEAR(self->stats);
+    Py_CLEAR(self->patchid);
+
     Py_RETURN_NONE;
 }
 
@@ -1126,6 +1565,9 @@ Diff_iter(Diff *self)
 {
     DiffIter *iter;
 
+    if (diff_check_busy(self) < 0)
+        return NULL;
+
     iter = PyObject_New(DiffIter, &DiffIterType);
     if (iter != NULL) {
         Py_INCREF(self);
@@ -1144,16 +1586,28 @@ Diff_getitem(Diff *self, PyObject *value)
     if (!PyLong_Check(value))
         return NULL; /* FIXME Raise error */
 
+    if (diff_check_busy(self) < 0)
+        return NULL;
+
     i = PyLong_AsSize_t(value);
     return diff_get_patch_byindex(self->diff, i);
 }
 
-PyDoc_STRVAR(Diff_stats__doc__, "Accumulate diff statistics for all patches.");
+PyDoc_STRVAR(Diff_stats__doc__,
+    "Accumulate diff statistics for all patches. Computed once, until the\n"
+    "diff is changed by find_similar() or merge().");
 
 PyObject *
 Diff_stats__get__(Diff *self)
 {
-    return wrap_diff_stats(self->diff);
+    if (self->stats == NULL) {
+        self->stats = wrap_diff_stats(self);
+        if (self->stats == NULL)
+            return NULL;
+    }
+
+    Py_INCREF(self->stats);
+    return self->stats;
 }
 
 PyDoc_STRVAR(Diff_parse_diff__doc__,
@@ -1181,6 +1635,8 @@ Diff_parse_diff(PyObject *self, PyObject *py_str)
 static void
 Diff_dealloc(Diff *self)
 {
+    Py_CLEAR(self->stats);
+    Py_CLEAR(self->patchid);
     git_diff_free(self->diff);
     Py_CLEAR(self->repo);
     PyObject_Del(self);
@@ -1203,6 +1659,7 @@ PyMappingMethods Diff_as_mapping = {
 static PyMethodDef Diff_methods[] = {
     METHOD(Diff, merge, METH_VARARGS),
     METHOD(Diff, find_similar, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Diff, write_patch, METH_VARARGS | METH_KEYWORDS),
     METHOD(Diff, from_c, METH_STATIC | METH_VARARGS),
     {"parse_diff", (PyCFunction) Diff_parse_diff,
       METH_O | METH_STATIC, Diff_parse_diff__doc__},
@@ -38,5 +38,6 @@ PyObject* wrap_diff_delta(const git_diff_delta *delta, Diff *diff, size_t idx);
 PyObject* wrap_diff_file(const git_diff_file *file);
 PyObject* wrap_diff_hunk(Patch *patch, size_t idx);
 PyObject* wrap_diff_line(const git_diff_line *line, DiffHunk *hunk);
+int diff_check_busy(Diff *diff);
 
 #endif
@@ -235,11 +235,7 @@ Object_peel(Object *self, PyObject *py_type)
 Py_hash_t
 Object_hash(Object *self)
 {
-    const git_oid *oid = Object__id(self);
-    PyObject *py_oid = git_oid_to_py_str(oid);
-    Py_hash_t ret = PyObject_Hash(py_oid);
-    Py_DECREF(py_oid);
-    return ret;
+    return git_oid_hash(Object__id(self));
 }
 
 PyObject *
@@ -29,16 +29,30 @@
 #include <Python.h>
 #include "error.h"
 #include "object.h"
+#include "odb.h"
 #include "odb_backend.h"
+#include "odb_memory.h"
 #include "oid.h"
 #include "types.h"
 #include "utils.h"
 #include <git2/odb.h>
 
 extern PyTypeObject OdbBackendType;
+extern PyTypeObject OdbIterType;
+extern PyTypeObject OdbObjectType;
 
+extern PyObject *GitError;
 extern PyObject *ObjectTypeEnum;
 
+/* Kinds of backends, used to filter what OdbIter yields */
+#define ODB_ITER_LOOSE   1
+#define ODB_ITER_PACKED  2
+#define ODB_ITER_CUSTOM  4
+#define ODB_ITER_ALL     (ODB_ITER_LOOSE | ODB_ITER_PACKED | ODB_ITER_CUSTOM)
+
+/* Number of ids an OdbIter is handed at once */
+#define ODB_ITER_BATCH 4096
+
 static git_otype
 int_to_loose_object_type(int type_id)
 {
@@ -66,73 +80,675 @@ Odb_init(Odb *self, PyObject *args, PyObject *kwds)
         return -1;
 
     int err;
+    PyObject *tvalue = NULL;
     if (py_path) {
-        PyObject *tvalue;
         char *path = pgit_borrow_fsdefault(py_path, &tvalue);
         if (path == NULL)
             return -1;
         err = git_odb_open(&self->odb, path);
-        Py_DECREF(tvalue);
     }
     else {
         err = git_odb_new(&self->odb);
     }
 
     if (err) {
+        Py_XDECREF(tvalue);
         Error_set(err);
         return -1;
     }
 
+    if (tvalue) {
+        self->paths = Py_BuildValue("[N]", tvalue);
+        if (self->paths == NULL)
+            return -1;
+    }
+
     return 0;
 }
 
 void
 Odb_dealloc(Odb *self)
 {
+    Py_CLEAR(self->paths);
     git_odb_free(self->odb);
 
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
+/*
+ * Whether libgit2 may use the odb with the GIL released, i.e. none of its
+ * backends is implemented in Python.
+ */
+int
+odb_allows_threads(git_odb *odb)
+{
+    git_odb_backend *backend;
+    size_t i, n;
+
+    n = git_odb_num_backends(odb);
+    for (i = 0; i < n; i++) {
+        if (git_odb_get_backend(&backend, odb, i) < 0) {
+            git_error_clear();
+            return 0;
+        }
+        if (odb_backend_to_python(backend))
+            return 0;
+    }
+
+    return 1;
+}
+
+int
+repository_odb_allows_threads(git_repository *repo)
+{
+    git_odb *odb;
+    int allows;
+
+    if (git_repository_odb(&odb, repo) < 0) {
+        git_error_clear();
+        return 0;
+    }
+
+    allows = odb_allows_threads(odb);
+    git_odb_free(odb);
+    return allows;
+}
+
+/*
+ * Open a handle of our own on the repository, for a native worker thread.
+ *
+ * The calls which release the GIL work on the handle of the caller, so the
+ * other threads of the application may read through it meanwhile. libgit2
+ * locks the caches of a handle and its built-in backends for that, custom
+ * native backends must be thread safe (OdbBackendMemory is), those written
+ * in Python keep the GIL (see odb_allows_threads).
+ *
+ * The worker threads pygit2 starts itself never share a handle, neither
+ * with each other nor with the caller. The handle is only opened when it
+ * gets the same object database backends as the shared one, i.e. no custom
+ * ones; returns NULL otherwise, and the work must then be done on the
+ * calling thread alone.
+ */
+git_repository *
+repository_open_thread_handle(git_repository *shared)
+{
+    git_repository *repo = NULL;
+    git_odb *shared_odb = NULL, *odb = NULL;
+    const char *path = git_repository_path(shared);
+    int same = 0;
+
+    if (path == NULL ||
+        git_repository_open_ext(&repo, path, GIT_REPOSITORY_OPEN_NO_SEARCH |
+                                GIT_REPOSITORY_OPEN_BARE, NULL) < 0) {
+        git_error_clear();
+        return NULL;
+    }
+
+    if (git_repository_odb(&shared_odb, shared) == 0 &&
+        git_repository_odb(&odb, repo) == 0)
+        same = git_odb_num_backends(shared_odb) == git_odb_num_backends(odb);
+    git_odb_free(shared_odb);
+    git_odb_free(odb);
+
+    if (!same) {
+        git_repository_free(repo);
+        git_error_clear();
+        return NULL;
+    }
+    return repo;
+}
+
+/*
+ * OdbIter
+ *
+ * The backends are visited one at a time. A native backend is read by a
+ * producer thread, through its foreach callback, which hands the ids over
+ * in batches of ODB_ITER_BATCH and waits for each to be taken before it
+ * goes on, so the memory used does not grow with the backend. The ids are
+ * kept raw, and turned into Oid objects only as they are yielded. For
+ * backends implemented in Python we pull from their iterator directly.
+ */
+
+/*
+ * The built-in backends are told apart by the callbacks they implement: only
+ * the loose backend streams writes, and only the pack backend takes packs.
+ */
+static unsigned int
+odb_backend_kind(git_odb_backend *backend)
+{
+    if (backend->writestream != NULL && backend->writepack == NULL)
+        return ODB_ITER_LOOSE;
+    if (backend->writepack != NULL && backend->write == NULL)
+        return ODB_ITER_PACKED;
+
+    return ODB_ITER_CUSTOM;
+}
+
+/*
+ * The pack indexes to visit instead of the pack backends, when restricted to
+ * some packs: every name in every object directory of the odb.
+ */
+static PyObject *
+odb_iter_pack_paths(Odb *odb, PyObject *packs)
+{
+    PyObject *paths, *iter, *name, *path;
+    Py_ssize_t i;
+
+    paths = PyList_New(0);
+    if (paths == NULL)
+        return NULL;
+
+    for (i = 0; i < PyList_GET_SIZE(odb->paths); i++) {
+        iter = PyObject_GetIter(packs);
+        if (iter == NULL)
+            goto error;
+
+        while ((name = PyIter_Next(iter))) {
+            path = PyBytes_FromFormat("%s/pack/%s.idx",
+                                      PyBytes_AS_STRING(PyList_GET_ITEM(odb->paths, i)),
+                                      PyBytes_AS_STRING(name));
+            Py_DECREF(name);
+            if (path == NULL || PyList_Append(paths, path) < 0) {
+                Py_XDECREF(path);
+                Py_DECREF(iter);
+                goto error;
+            }
+            Py_DECREF(path);
+        }
+        Py_DECREF(iter);
+        if (PyErr_Occurred())
+            goto error;
+    }
+
+    return paths;
+
+error:
+    Py_DECREF(paths);
+    return NULL;
+}
+
+struct odb_iter_producer {
+    git_odb_backend *backend;
+    int own_backend;            /* Whether to free the backend once read */
+    pgit_thread thread;
+    PyThread_type_lock full;    /* Held until a batch is handed over */
+    PyThread_type_lock empty;   /* Held until the last batch is taken */
+    git_oid *slot;              /* The batch handed over */
+    size_t slot_len;
+    git_oid *fill;              /* The batch being filled */
+    size_t fill_len;
+    volatile int stop;          /* Set by the consumer to end early */
+    int done;                   /* Set with the last batch */
+    int err;
+    char *err_msg;
+};
+
+static void
+odb_iter_producer_free(odb_iter_producer *p)
+{
+    if (p->full)
+        PyThread_free_lock(p->full);
+    if (p->empty)
+        PyThread_free_lock(p->empty);
+    if (p->own_backend)
+        p->backend->free(p->backend);
+    free(p->slot);
+    free(p->fill);
+    free(p->err_msg);
+    free(p);
+}
+
+/* Hand the filled batch over, once the previous one is taken */
+static void
+odb_iter_producer_hand_over(odb_iter_producer *p, int done)
+{
+    git_oid *batch;
+
+    PyThread_acquire_lock(p->empty, WAIT_LOCK);
+    batch = p->slot;
+    p->slot = p->fill;
+    p->slot_len = p->fill_len;
+    p->fill = batch;
+    p->fill_len = 0;
+    p->done = done;
+    PyThread_release_lock(p->full);
+}
+
 static int
-Odb_build_as_iter(const git_oid *oid, void *accum)
+odb_iter_producer_cb(const git_oid *oid, void *payload)
+{
+    odb_iter_producer *p = payload;
+
+    if (p->fill_len == ODB_ITER_BATCH) {
+        odb_iter_producer_hand_over(p, 0);
+        if (p->stop)
+            return GIT_EUSER;
+    }
+
+    git_oid_cpy(&p->fill[p->fill_len++], oid);
+    return 0;
+}
+
+static void
+odb_iter_producer_run(void *payload)
 {
+    odb_iter_producer *p = payload;
+    const git_error *error;
     int err;
-    PyObject *py_oid = git_oid_to_python(oid);
-    if (py_oid == NULL)
-        return GIT_EUSER;
 
-    err = PyList_Append((PyObject*)accum, py_oid);
-    Py_DECREF(py_oid);
+    err = p->backend->foreach(p->backend, odb_iter_producer_cb, p);
+    if (err < 0 && !p->stop) {
+        /* Error messages are per thread, keep ours for the consumer */
+        error = git_error_last();
+        p->err = err;
+        p->err_msg = strdup(error && error->message ? error->message : "");
+    }
+    odb_iter_producer_hand_over(p, 1);
+}
+
+/* Start reading the ids of a native backend, on a producer thread. */
+static int
+OdbIter_start(OdbIter *self, git_odb_backend *backend, int own_backend)
+{
+    odb_iter_producer *p;
+
+    if (self->batch == NULL) {
+        self->batch = malloc(ODB_ITER_BATCH * sizeof(git_oid));
+        if (self->batch == NULL)
+            goto nomem;
+    }
+
+    p = calloc(1, sizeof(*p));
+    if (p == NULL)
+        goto nomem;
+    p->backend = backend;
+    p->own_backend = own_backend;
+    p->full = PyThread_allocate_lock();
+    p->empty = PyThread_allocate_lock();
+    p->slot = malloc(ODB_ITER_BATCH * sizeof(git_oid));
+    p->fill = malloc(ODB_ITER_BATCH * sizeof(git_oid));
+    if (p->full == NULL || p->empty == NULL || p->slot == NULL || p->fill == NULL) {
+        odb_iter_producer_free(p);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    /* Nothing handed over yet */
+    PyThread_acquire_lock(p->full, WAIT_LOCK);
+    if (pgit_thread_start(&p->thread, odb_iter_producer_run, p) < 0) {
+        odb_iter_producer_free(p);
+        PyErr_SetString(PyExc_RuntimeError, "cannot start a thread");
+        return -1;
+    }
+
+    self->producer = p;
+    return 1;
+
+nomem:
+    if (own_backend)
+        backend->free(backend);
+    PyErr_NoMemory();
+    return -1;
+}
+
+/* Take the next batch of the producer, waiting for it without the GIL. */
+static void
+OdbIter_take(OdbIter *self, int *done)
+{
+    odb_iter_producer *p = self->producer;
+    git_oid *batch;
+
+    Py_BEGIN_ALLOW_THREADS
+    PyThread_acquire_lock(p->full, WAIT_LOCK);
+    Py_END_ALLOW_THREADS
+
+    batch = self->batch;
+    self->batch = p->slot;
+    self->batch_len = p->slot_len;
+    self->batch_pos = 0;
+    p->slot = batch;
+    *done = p->done;
+    PyThread_release_lock(p->empty);
+}
+
+/* Wait for the producer to end, and free it. */
+static int
+OdbIter_finish(OdbIter *self)
+{
+    odb_iter_producer *p = self->producer;
+    int err = p->err;
+
+    Py_BEGIN_ALLOW_THREADS
+    pgit_thread_join(&p->thread);
+    Py_END_ALLOW_THREADS
+
     if (err < 0)
-        return GIT_EUSER;
+        git_error_set_str(GIT_ERROR_ODB, p->err_msg ? p->err_msg : "");
+    self->producer = NULL;
+    odb_iter_producer_free(p);
+    if (err < 0) {
+        Error_set(err);
+        return -1;
+    }
+    return 0;
+}
+
+/* Make the producer stop early, and wait for it. */
+static void
+OdbIter_stop(OdbIter *self)
+{
+    int done = 0;
+
+    self->producer->stop = 1;
+    while (!done)
+        OdbIter_take(self, &done);
+    self->batch_len = 0;
+    self->producer->err = 0;
+    OdbIter_finish(self);
+}
+
+/* Collect the ids of the next of the selected packs, skipping missing ones. */
+static int
+OdbIter_next_pack(OdbIter *self)
+{
+    git_odb_backend *backend;
+    const char *path;
+    int err;
+
+    path = PyBytes_AS_STRING(PyList_GET_ITEM(self->packs, self->pack_i++));
+
+    Py_BEGIN_ALLOW_THREADS
+    err = git_odb_backend_one_pack(&backend, path);
+    Py_END_ALLOW_THREADS
+    if (err == GIT_ENOTFOUND) {
+        git_error_clear();
+        return 1;
+    }
+    if (err < 0) {
+        Error_set(err);
+        return -1;
+    }
+
+    return OdbIter_start(self, backend, 1);
+}
+
+/*
+ * Produce the next batch of ids. Returns 1 if there may be more ids, 0 once
+ * every backend has been visited, and -1 on error. The batch may be empty.
+ */
+static int
+OdbIter_refill(OdbIter *self)
+{
+    git_odb_backend *backend;
+    PyObject *py_backend, *iter_method;
+    unsigned int kind;
+    int err, done;
+
+    self->batch_len = 0;
+    self->batch_pos = 0;
+
+    if (self->producer) {
+        OdbIter_take(self, &done);
+        if (done && OdbIter_finish(self) < 0) {
+            self->batch_len = 0;
+            return -1;
+        }
+        return 1;
+    }
+
+    while (self->backend_i < git_odb_num_backends(self->odb->odb)) {
+        err = git_odb_get_backend(&backend, self->odb->odb, self->backend_i++);
+        if (err < 0) {
+            Error_set(err);
+            return -1;
+        }
+
+        /* With a pack filter, the selected packs are visited instead */
+        kind = odb_backend_kind(backend);
+        if ((self->kinds & kind) == 0 || backend->foreach == NULL ||
+            (kind == ODB_ITER_PACKED && self->packs))
+            continue;
+
+        /* Call the Python __iter__ method directly, see
+         * pgit_odb_backend_foreach */
+        py_backend = odb_backend_to_python(backend);
+        if (py_backend) {
+            iter_method = PyObject_GetAttrString(py_backend, "__iter__");
+            if (iter_method == NULL)
+                return -1;
+            self->py_iter = PyObject_CallObject(iter_method, NULL);
+            Py_DECREF(iter_method);
+            return self->py_iter ? 1 : -1;
+        }
+
+        return OdbIter_start(self, backend, 0);
+    }
+
+    if (self->packs && (self->kinds & ODB_ITER_PACKED) &&
+        self->pack_i < PyList_GET_SIZE(self->packs))
+        return OdbIter_next_pack(self);
 
     return 0;
 }
 
-PyObject *
-Odb_as_iter(Odb *self)
+static PyObject *
+wrap_odb_iter(Odb *odb, unsigned int kinds, PyObject *packs)
 {
-    PyObject *accum = PyList_New(0);
-    if (accum == NULL)
+    OdbIter *iter;
+
+    if (packs && odb->paths == NULL) {
+        PyErr_SetString(PyExc_ValueError,
+                        "cannot filter by pack, the location of the "
+                        "object directories is unknown");
         return NULL;
+    }
 
-    int err = git_odb_foreach(self->odb, Odb_build_as_iter, (void*)accum);
-    if (err == GIT_EUSER && PyErr_Occurred()) {
-        Py_DECREF(accum);
+    iter = PyObject_New(OdbIter, &OdbIterType);
+    if (iter == NULL)
         return NULL;
+
+    Py_INCREF(odb);
+    iter->odb = odb;
+    iter->kinds = kinds;
+    iter->packs = NULL;
+    iter->pack_i = 0;
+    iter->backend_i = 0;
+    iter->py_iter = NULL;
+    iter->batch = NULL;
+    iter->batch_len = 0;
+    iter->batch_pos = 0;
+    iter->producer = NULL;
+
+    if (packs) {
+        iter->packs = odb_iter_pack_paths(odb, packs);
+        if (iter->packs == NULL) {
+            Py_DECREF(iter);
+            return NULL;
+        }
     }
-    if (err == GIT_EUSER)
-        err = GIT_ERROR;
 
-    if (err < 0) {
-        Py_DECREF(accum);
-        return Error_set(err);
+    return (PyObject *)iter;
+}
+
+void
+OdbIter_dealloc(OdbIter *self)
+{
+    if (self->producer)
+        OdbIter_stop(self);
+    Py_CLEAR(self->py_iter);
+    Py_CLEAR(self->packs);
+    Py_CLEAR(self->odb);
+    free(self->batch);
+    PyObject_Del(self);
+}
+
+PyObject *
+OdbIter_iternext(OdbIter *self)
+{
+    PyObject *item;
+    git_oid oid;
+    size_t len;
+
+    for (;;) {
+        if (self->batch_pos < self->batch_len)
+            return git_oid_to_python(&self->batch[self->batch_pos++]);
+
+        if (self->py_iter) {
+            item = PyIter_Next(self->py_iter);
+            if (item) {
+                len = py_oid_to_git_oid(item, &oid);
+                Py_DECREF(item);
+                if (len == 0)
+                    return NULL;
+                return git_oid_to_python(&oid);
+            }
+            if (PyErr_Occurred())
+                return NULL;
+            Py_CLEAR(self->py_iter);
+        }
+
+        if (OdbIter_refill(self) <= 0)
+            return NULL;
     }
+}
 
-    PyObject *ret = PyObject_GetIter(accum);
-    Py_DECREF(accum);
+PyDoc_STRVAR(OdbIter__doc__, "Object database iterator.");
+
+PyTypeObject OdbIterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.OdbIter",                         /* tp_name           */
+    sizeof(OdbIter),                           /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)OdbIter_dealloc,               /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    OdbIter__doc__,                            /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    PyObject_SelfIter,                         /* tp_iter           */
+    (iternextfunc)OdbIter_iternext,            /* tp_iternext       */
+};
+
+
+PyObject *
+Odb_as_iter(Odb *self)
+{
+    return wrap_odb_iter(self, ODB_ITER_ALL, NULL);
+}
+
+PyDoc_STRVAR(Odb_objects__doc__,
+  "objects(loose: bool = True, packed: bool = True, custom: bool = True, packs: Iterable[str] | None = None) -> Iterator[Oid]\n"
+  "\n"
+  "Return an iterator over the ids of the objects in the database. The\n"
+  "backends are visited one at a time, the native ones read a few thousand\n"
+  "ids ahead on a thread of their own, and an Oid is only created for the\n"
+  "id being yielded.\n"
+  "\n"
+  "Parameters:\n"
+  "\n"
+  "loose\n"
+  "    Include objects from the loose object backends.\n"
+  "\n"
+  "packed\n"
+  "    Include objects from the pack backends.\n"
+  "\n"
+  "custom\n"
+  "    Include objects from any other backend, e.g. those added with\n"
+  "    add_backend().\n"
+  "\n"
+  "packs\n"
+  "    Only include packed objects from the packs with the given names\n"
+  "    (e.g. 'pack-<id>' or 'pack-<id>.pack'), in the object directories of\n"
+  "    the Odb (not its alternates). This requires the location of the\n"
+  "    object directories to be known, i.e. the Odb was opened from a path\n"
+  "    or obtained from Repository.odb.");
+
+PyObject *
+Odb_objects(Odb *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"loose", "packed", "custom", "packs", NULL};
+    int loose = 1, packed = 1, custom = 1;
+    unsigned int kinds = 0;
+    PyObject *py_packs = Py_None;
+    PyObject *packs = NULL;
+    PyObject *iter, *item, *ret;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|pppO", keywords,
+                                     &loose, &packed, &custom, &py_packs))
+        return NULL;
+
+    if (loose)
+        kinds |= ODB_ITER_LOOSE;
+    if (packed)
+        kinds |= ODB_ITER_PACKED;
+    if (custom)
+        kinds |= ODB_ITER_CUSTOM;
+
+    /* Normalize the pack names to their basename without extension */
+    if (py_packs != Py_None) {
+        packs = PySet_New(NULL);
+        if (packs == NULL)
+            return NULL;
+
+        iter = PyObject_GetIter(py_packs);
+        if (iter == NULL)
+            goto error;
+
+        while ((item = PyIter_Next(iter))) {
+            PyObject *bytes = NULL;
+            int ok = PyUnicode_FSConverter(item, &bytes);
+            Py_DECREF(item);
+            if (!ok) {
+                Py_DECREF(iter);
+                goto error;
+            }
+
+            const char *name = PyBytes_AS_STRING(bytes);
+            const char *sep = strrchr(name, '/');
+            if (sep)
+                name = sep + 1;
+            size_t len = strlen(name);
+            if (len > 5 && strcmp(name + len - 5, ".pack") == 0)
+                len -= 5;
+            else if (len > 4 && strcmp(name + len - 4, ".idx") == 0)
+                len -= 4;
+
+            PyObject *base = PyBytes_FromStringAndSize(name, len);
+            Py_DECREF(bytes);
+            if (base == NULL || PySet_Add(packs, base) < 0) {
+                Py_XDECREF(base);
+                Py_DECREF(iter);
+                goto error;
+            }
+            Py_DECREF(base);
+        }
+        Py_DECREF(iter);
+        if (PyErr_Occurred())
+            goto error;
+    }
+
+    ret = wrap_odb_iter(self, kinds, packs);
+    Py_XDECREF(packs);
     return ret;
+
+error:
+    Py_XDECREF(packs);
+    return NULL;
 }
 
 
@@ -152,9 +768,23 @@ Odb_add_disk_alternate(Odb *self, PyObject *py_path)
         return NULL;
 
     int err = git_odb_add_disk_alternate(self->odb, path);
-    Py_DECREF(tvalue);
-    if (err)
+    if (err) {
+        Py_DECREF(tvalue);
         return Error_set(err);
+    }
+
+    if (self->paths == NULL) {
+        self->paths = PyList_New(0);
+        if (self->paths == NULL) {
+            Py_DECREF(tvalue);
+            return NULL;
+        }
+    }
+
+    err = PyList_Append(self->paths, tvalue);
+    Py_DECREF(tvalue);
+    if (err < 0)
+        return NULL;
 
     Py_RETURN_NONE;
 }
@@ -211,6 +841,116 @@ Odb_read(Odb *self, PyObject *py_hex)
     return tuple;
 }
 
+PyDoc_STRVAR(Odb_read_object__doc__,
+  "read_object(oid: Oid | str) -> OdbObject\n"
+  "\n"
+  "Read an object from the database, without copying its data. The\n"
+  "returned object implements the buffer interface, so the contents can be\n"
+  "accessed through `memoryview(obj)`; the underlying buffer stays alive as\n"
+  "long as the OdbObject or any view on it does.");
+
+PyObject *
+Odb_read_object(Odb *self, PyObject *py_hex)
+{
+    git_oid oid;
+    git_odb_object *obj;
+    OdbObject *py_obj;
+    size_t len;
+
+    len = py_oid_to_git_oid(py_hex, &oid);
+    if (len == 0)
+        return NULL;
+
+    obj = Odb_read_raw(self->odb, &oid, len);
+    if (obj == NULL)
+        return NULL;
+
+    py_obj = PyObject_New(OdbObject, &OdbObjectType);
+    if (py_obj == NULL) {
+        git_odb_object_free(obj);
+        return NULL;
+    }
+
+    py_obj->obj = obj;
+    return (PyObject *)py_obj;
+}
+
+PyDoc_STRVAR(Odb_read_many__doc__,
+  "read_many(oids: Iterable[Oid | str]) -> list[tuple[enums.ObjectType, bytes] | None]\n"
+  "\n"
+  "Read the raw data of several objects at once. Returns a list with a\n"
+  "(type, data) tuple for every id, in the order given, or None where the\n"
+  "object does not exist.\n"
+  "\n"
+  "The objects are read ordered by id, and without holding the GIL unless\n"
+  "the database has a backend implemented in Python.");
+
+PyObject *
+Odb_read_many(Odb *self, PyObject *py_oids)
+{
+    pgit_oid_request *requests;
+    git_odb_object *obj;
+    Py_ssize_t i, n;
+    PyObject *list = NULL;
+    PyObject *item;
+    int err = 0;
+
+    requests = py_oids_to_git_requests(py_oids, &n);
+    if (requests == NULL)
+        return NULL;
+
+    PGIT_BEGIN_ALLOW_THREADS_IF(odb_allows_threads(self->odb))
+    for (i = 0; i < n; i++) {
+        requests[i].err = git_odb_read_prefix(&obj, self->odb,
+                                              &requests[i].oid, requests[i].len);
+        requests[i].result = requests[i].err < 0 ? NULL : obj;
+        if (requests[i].err < 0 && requests[i].err != GIT_ENOTFOUND) {
+            err = requests[i].err;
+            break;
+        }
+    }
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (err < 0) {
+        if (err == GIT_EUSER && PyErr_Occurred())
+            goto exit;
+        Error_set_oid(err, &requests[i].oid, requests[i].len);
+        goto exit;
+    }
+
+    list = PyList_New(n);
+    if (list == NULL)
+        goto exit;
+
+    for (i = 0; i < n; i++) {
+        obj = requests[i].result;
+        if (obj == NULL) {
+            Py_INCREF(Py_None);
+            PyList_SET_ITEM(list, requests[i].pos, Py_None);
+            continue;
+        }
+
+        item = Py_BuildValue(
+            "(Ny#)",
+            pygit2_enum(ObjectTypeEnum, git_odb_object_type(obj)),
+            git_odb_object_data(obj),
+            git_odb_object_size(obj));
+        if (item == NULL) {
+            Py_CLEAR(list);
+            goto exit;
+        }
+        PyList_SET_ITEM(list, requests[i].pos, item);
+    }
+
+exit:
+    /* Not found errors are expected, do not leave them behind */
+    git_error_clear();
+    for (i = 0; i < n; i++)
+        git_odb_object_free(requests[i].result);
+    PyMem_Free(requests);
+    return list;
+}
+
 PyDoc_STRVAR(Odb_read_header__doc__,
     "read_header(oid: Oid) -> tuple[enums.ObjectType, int]\n"
     "\n"
@@ -341,6 +1081,9 @@ Odb_add_backend(Odb *self, PyObject *args)
     if (err != 0)
         return Error_set(err);
 
+    /* The odb frees it, but the Python object may still use it */
+    odb_memory_retain(backend->odb_backend);
+
     Py_INCREF(backend);
 
     Py_RETURN_NONE;
@@ -349,8 +1092,11 @@ Odb_add_backend(Odb *self, PyObject *args)
 
 static PyMethodDef Odb_methods[] = {
     METHOD(Odb, add_disk_alternate, METH_O),
+    METHOD(Odb, objects, METH_VARARGS | METH_KEYWORDS),
     METHOD(Odb, read, METH_O),
     METHOD(Odb, read_header, METH_O),
+    METHOD(Odb, read_many, METH_O),
+    METHOD(Odb, read_object, METH_O),
     METHOD(Odb, write, METH_VARARGS),
     METHOD(Odb, exists, METH_O),
     METHOD(Odb, add_backend, METH_VARARGS),
@@ -476,12 +1222,137 @@ PyTypeObject OdbType = {
 };
 
 PyObject *
-wrap_odb(git_odb *c_odb)
+wrap_odb(git_odb *c_odb, const char *objects_dir)
 {
     Odb *py_odb = PyObject_New(Odb, &OdbType);
+    if (py_odb == NULL) {
+        git_odb_free(c_odb);
+        return NULL;
+    }
 
-    if (py_odb)
-        py_odb->odb = c_odb;
+    py_odb->odb = c_odb;
+    py_odb->paths = NULL;
+    if (objects_dir) {
+        py_odb->paths = Py_BuildValue("[y]", objects_dir);
+        if (py_odb->paths == NULL) {
+            Py_DECREF(py_odb);
+            return NULL;
+        }
+    }
 
     return (PyObject *)py_odb;
 }
+
+
+/*
+ * OdbObject
+ */
+
+static void
+OdbObject_dealloc(OdbObject *self)
+{
+    git_odb_object_free(self->obj);
+    PyObject_Del(self);
+}
+
+PyDoc_STRVAR(OdbObject_id__doc__, "The id of the object.");
+
+PyObject *
+OdbObject_id__get__(OdbObject *self)
+{
+    return git_oid_to_python(git_odb_object_id(self->obj));
+}
+
+PyDoc_STRVAR(OdbObject_type__doc__, "The type of the object.");
+
+PyObject *
+OdbObject_type__get__(OdbObject *self)
+{
+    return pygit2_enum(ObjectTypeEnum, git_odb_object_type(self->obj));
+}
+
+PyDoc_STRVAR(OdbObject_size__doc__, "Size in bytes.");
+
+PyObject *
+OdbObject_size__get__(OdbObject *self)
+{
+    return PyLong_FromSize_t(git_odb_object_size(self->obj));
+}
+
+PyDoc_STRVAR(OdbObject_data__doc__,
+  "A copy of the contents of the object, a byte string. Use\n"
+  "`memoryview(obj)` to access them without copying.");
+
+PyObject *
+OdbObject_data__get__(OdbObject *self)
+{
+    return PyBytes_FromStringAndSize(git_odb_object_data(self->obj),
+                                     git_odb_object_size(self->obj));
+}
+
+PyGetSetDef OdbObject_getseters[] = {
+    GETTER(OdbObject, id),
+    GETTER(OdbObject, type),
+    GETTER(OdbObject, size),
+    GETTER(OdbObject, data),
+    {NULL}
+};
+
+static int
+OdbObject_getbuffer(OdbObject *self, Py_buffer *view, int flags)
+{
+    return PyBuffer_FillInfo(view, (PyObject *) self,
+                             (void *) git_odb_object_data(self->obj),
+                             git_odb_object_size(self->obj), 1, flags);
+}
+
+static PyBufferProcs OdbObject_as_buffer = {
+    (getbufferproc)OdbObject_getbuffer,
+};
+
+PyDoc_STRVAR(OdbObject__doc__, "Raw object read from an object database.\n"
+  "\n"
+  "OdbObjects implement the buffer interface, which means you can get access\n"
+  "to its data via `memoryview(obj)` without the need to create a copy."
+);
+
+PyTypeObject OdbObjectType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.OdbObject",                       /* tp_name           */
+    sizeof(OdbObject),                         /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)OdbObject_dealloc,             /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    &OdbObject_as_buffer,                      /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    OdbObject__doc__,                          /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    0,                                         /* tp_methods        */
+    0,                                         /* tp_members        */
+    OdbObject_getseters,                       /* tp_getset         */
+    0,                                         /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    0,                                         /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
@@ -33,10 +33,14 @@
 #include <git2.h>
 #include "types.h"
 
-PyObject *wrap_odb(git_odb *c_odb);
+PyObject *wrap_odb(git_odb *c_odb, const char *objects_dir);
 
 git_odb_object *Odb_read_raw(git_odb *odb, const git_oid *oid, size_t len);
 
 PyObject *Odb_read(Odb *self, PyObject *py_hex);
 
+int odb_allows_threads(git_odb *odb);
+int repository_odb_allows_threads(git_repository *repo);
+git_repository *repository_open_thread_handle(git_repository *shared);
+
 #endif
@@ -265,6 +265,19 @@ pgit_odb_backend_free(git_odb_backend *backend)
     Py_DECREF(custom_backend->py_backend);
 }
 
+/*
+ * Return (borrowed) the Python object implementing the given backend, or NULL
+ * if it is not a backend implemented in Python.
+ */
+PyObject *
+odb_backend_to_python(git_odb_backend *backend)
+{
+    if (backend->read != pgit_odb_backend_read)
+        return NULL;
+
+    return ((pgit_odb_backend *)backend)->py_backend;
+}
+
 int
 OdbBackend_init(OdbBackend *self, PyObject *args, PyObject *kwds)
 {
@@ -35,4 +35,6 @@
 
 PyObject *wrap_odb_backend(git_odb_backend *c_odb_backend);
 
+PyObject *odb_backend_to_python(git_odb_backend *c_odb_backend);
+
 #endif
@@ -0,0 +1,651 @@
+/*
+ * Copyright 2010-2026 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <git2.h>
+#include <git2/sys/errors.h>
+#include <git2/sys/odb_backend.h>
+#include "error.h"
+#include "odb_memory.h"
+#include "oid.h"
+#include "types.h"
+#include "utils.h"
+
+extern PyTypeObject OdbBackendType;
+extern PyTypeObject OdbBackendMemoryType;
+
+/*
+ * The objects are copied into large blocks (the arena), which are only freed
+ * with the backend, and indexed by an open addressing hash table keyed by the
+ * id. Every call takes the lock of the backend, which is a plain native lock,
+ * so libgit2 may call the backend without the GIL.
+ */
+
+#define ODB_MEMORY_BLOCK_SIZE (1024 * 1024)
+#define ODB_MEMORY_MIN_SLOTS 1024
+
+typedef struct odb_memory_block odb_memory_block;
+
+struct odb_memory_block {
+    odb_memory_block *next;
+    size_t used;
+    size_t size;
+    char data[];
+};
+
+typedef struct {
+    git_oid oid;
+    git_object_t type;              /* 0 for a free slot */
+    size_t len;
+    const char *data;
+} odb_memory_slot;
+
+typedef struct {
+    git_odb_backend parent;
+    PyThread_type_lock lock;
+    odb_memory_block *blocks;       /* The current one first */
+    odb_memory_slot *slots;
+    size_t mask;
+    size_t count;
+    size_t bytes;
+    long refcount;                  /* The Python object, and every odb */
+} odb_memory;
+
+
+/*
+ * Arena
+ */
+
+static const char *
+odb_memory_copy(odb_memory *db, const void *data, size_t len)
+{
+    odb_memory_block *block = db->blocks;
+    char *out;
+
+    if (block == NULL || block->size - block->used < len) {
+        /* Large objects get a block of their own, behind the current one */
+        size_t size = len > ODB_MEMORY_BLOCK_SIZE / 4 ? len : ODB_MEMORY_BLOCK_SIZE;
+
+        block = malloc(sizeof(odb_memory_block) + size);
+        if (block == NULL)
+            return NULL;
+        block->used = 0;
+        block->size = size;
+        if (db->blocks && size == len) {
+            block->next = db->blocks->next;
+            db->blocks->next = block;
+        } else {
+            block->next = db->blocks;
+            db->blocks = block;
+        }
+    }
+
+    out = block->data + block->used;
+    block->used += len;
+    memcpy(out, data, len);
+    return out;
+}
+
+
+/*
+ * Table
+ */
+
+static size_t
+odb_memory_hash(const git_oid *oid)
+{
+    size_t hash;
+
+    /* The ids are hashes already */
+    memcpy(&hash, oid->id, sizeof(hash));
+    return hash;
+}
+
+static odb_memory_slot *
+odb_memory_find(odb_memory *db, const git_oid *oid)
+{
+    size_t i = odb_memory_hash(oid) & db->mask;
+
+    while (db->slots[i].type) {
+        if (git_oid_equal(&db->slots[i].oid, oid))
+            return &db->slots[i];
+        i = (i + 1) & db->mask;
+    }
+    return NULL;
+}
+
+static int
+odb_memory_grow(odb_memory *db)
+{
+    size_t i, j, nslots = (db->mask + 1) * 2;
+    odb_memory_slot *slots;
+
+    slots = calloc(nslots, sizeof(odb_memory_slot));
+    if (slots == NULL)
+        return -1;
+
+    for (i = 0; i <= db->mask; i++) {
+        if (!db->slots[i].type)
+            continue;
+        j = odb_memory_hash(&db->slots[i].oid) & (nslots - 1);
+        while (slots[j].type)
+            j = (j + 1) & (nslots - 1);
+        slots[j] = db->slots[i];
+    }
+
+    free(db->slots);
+    db->slots = slots;
+    db->mask = nslots - 1;
+    return 0;
+}
+
+/* Find the objects matching the short id; returns how many, up to 2 */
+static int
+odb_memory_find_prefix(odb_memory_slot **out, odb_memory *db, const git_oid *short_id,
+                       size_t len)
+{
+    size_t i;
+    int found = 0;
+
+    for (i = 0; i <= db->mask; i++) {
+        if (!db->slots[i].type || git_oid_ncmp(&db->slots[i].oid, short_id, len) != 0)
+            continue;
+        if (found)
+            return 2;
+        *out = &db->slots[i];
+        found = 1;
+    }
+    return found;
+}
+
+static int
+odb_memory_error_ambiguous(void)
+{
+    git_error_set(GIT_ERROR_ODB, "ambiguous OID prefix - found multiple objects");
+    return GIT_EAMBIGUOUS;
+}
+
+/* Copy the ids, so they can be used without the lock */
+static git_oid *
+odb_memory_oids(odb_memory *db, size_t *count)
+{
+    git_oid *oids;
+    size_t i, n = 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    oids = malloc((db->count ? db->count : 1) * sizeof(git_oid));
+    for (i = 0; oids && i <= db->mask; i++) {
+        if (db->slots[i].type)
+            git_oid_cpy(&oids[n++], &db->slots[i].oid);
+    }
+    PyThread_release_lock(db->lock);
+
+    *count = n;
+    return oids;
+}
+
+static void
+odb_memory_release(odb_memory *db)
+{
+    odb_memory_block *block, *next;
+    long refcount;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    refcount = --db->refcount;
+    PyThread_release_lock(db->lock);
+    if (refcount > 0)
+        return;
+
+    for (block = db->blocks; block; block = next) {
+        next = block->next;
+        free(block);
+    }
+    free(db->slots);
+    PyThread_free_lock(db->lock);
+    free(db);
+}
+
+
+/*
+ * Backend
+ */
+
+static int
+odb_memory_read(void **out, size_t *len, git_object_t *type,
+                git_odb_backend *backend, const git_oid *oid)
+{
+    odb_memory *db = (odb_memory *)backend;
+    odb_memory_slot *slot;
+    int err = 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    if ((slot = odb_memory_find(db, oid)) == NULL) {
+        err = GIT_ENOTFOUND;
+    } else if ((*out = git_odb_backend_data_alloc(backend, slot->len)) == NULL) {
+        err = GIT_ERROR;
+    } else {
+        memcpy(*out, slot->data, slot->len);
+        *len = slot->len;
+        *type = slot->type;
+    }
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+odb_memory_read_prefix(git_oid *out_oid, void **out, size_t *len, git_object_t *type,
+                       git_odb_backend *backend, const git_oid *short_id, size_t short_len)
+{
+    odb_memory *db = (odb_memory *)backend;
+    odb_memory_slot *slot = NULL;
+    int found, err = 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    found = odb_memory_find_prefix(&slot, db, short_id, short_len);
+    if (found == 0) {
+        err = GIT_ENOTFOUND;
+    } else if (found > 1) {
+        err = odb_memory_error_ambiguous();
+    } else if ((*out = git_odb_backend_data_alloc(backend, slot->len)) == NULL) {
+        err = GIT_ERROR;
+    } else {
+        memcpy(*out, slot->data, slot->len);
+        git_oid_cpy(out_oid, &slot->oid);
+        *len = slot->len;
+        *type = slot->type;
+    }
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+odb_memory_read_header(size_t *len, git_object_t *type, git_odb_backend *backend,
+                       const git_oid *oid)
+{
+    odb_memory *db = (odb_memory *)backend;
+    odb_memory_slot *slot;
+    int err = 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    if ((slot = odb_memory_find(db, oid)) == NULL) {
+        err = GIT_ENOTFOUND;
+    } else {
+        *len = slot->len;
+        *type = slot->type;
+    }
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+odb_memory_write(git_odb_backend *backend, const git_oid *oid, const void *data,
+                 size_t len, git_object_t type)
+{
+    odb_memory *db = (odb_memory *)backend;
+    odb_memory_slot *slot;
+    const char *copy;
+    size_t i;
+    int err = 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    if (odb_memory_find(db, oid))
+        goto exit;
+
+    /* At most half full, so the probes stay short */
+    if (db->count >= (db->mask + 1) / 2 && odb_memory_grow(db) < 0)
+        goto nomem;
+    if ((copy = odb_memory_copy(db, data, len)) == NULL)
+        goto nomem;
+
+    i = odb_memory_hash(oid) & db->mask;
+    while (db->slots[i].type)
+        i = (i + 1) & db->mask;
+    slot = &db->slots[i];
+    git_oid_cpy(&slot->oid, oid);
+    slot->type = type;
+    slot->len = len;
+    slot->data = copy;
+    db->count++;
+    db->bytes += len;
+    goto exit;
+
+nomem:
+    git_error_set_oom();
+    err = GIT_ERROR;
+exit:
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+odb_memory_exists(git_odb_backend *backend, const git_oid *oid)
+{
+    odb_memory *db = (odb_memory *)backend;
+    int exists;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    exists = odb_memory_find(db, oid) != NULL;
+    PyThread_release_lock(db->lock);
+    return exists;
+}
+
+static int
+odb_memory_exists_prefix(git_oid *out, git_odb_backend *backend,
+                         const git_oid *short_id, size_t short_len)
+{
+    odb_memory *db = (odb_memory *)backend;
+    odb_memory_slot *slot = NULL;
+    int found, err = 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    found = odb_memory_find_prefix(&slot, db, short_id, short_len);
+    if (found == 0)
+        err = GIT_ENOTFOUND;
+    else if (found > 1)
+        err = odb_memory_error_ambiguous();
+    else
+        git_oid_cpy(out, &slot->oid);
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+odb_memory_foreach(git_odb_backend *backend, git_odb_foreach_cb cb, void *payload)
+{
+    git_oid *oids;
+    size_t i, count;
+    int err = 0;
+
+    /* The callback may read from the backend */
+    if ((oids = odb_memory_oids((odb_memory *)backend, &count)) == NULL) {
+        git_error_set_oom();
+        return GIT_ERROR;
+    }
+
+    for (i = 0; i < count && err == 0; i++)
+        err = cb(&oids[i], payload);
+
+    free(oids);
+    return err;
+}
+
+static void
+odb_memory_free(git_odb_backend *backend)
+{
+    odb_memory_release((odb_memory *)backend);
+}
+
+/* An odb is given the backend, see Odb.add_backend */
+void
+odb_memory_retain(git_odb_backend *backend)
+{
+    odb_memory *db = (odb_memory *)backend;
+
+    if (backend->free != odb_memory_free)
+        return;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    db->refcount++;
+    PyThread_release_lock(db->lock);
+}
+
+/* Write the objects as a pack, through a repository reading only them */
+static int
+odb_memory_write_pack(char *name, odb_memory *db, const char *path)
+{
+    git_odb *odb = NULL;
+    git_repository *repo = NULL;
+    git_packbuilder *pb = NULL;
+    git_oid *oids;
+    size_t i, count;
+    int err;
+
+    if ((oids = odb_memory_oids(db, &count)) == NULL) {
+        git_error_set_oom();
+        return GIT_ERROR;
+    }
+
+    if ((err = git_odb_new(&odb)) < 0)
+        goto exit;
+    odb_memory_retain(&db->parent);
+    if ((err = git_odb_add_backend(odb, &db->parent, 1)) < 0) {
+        odb_memory_release(db);
+        goto exit;
+    }
+    if ((err = git_repository_wrap_odb(&repo, odb)) < 0 ||
+        (err = git_packbuilder_new(&pb, repo)) < 0)
+        goto exit;
+
+    for (i = 0; i < count; i++) {
+        if ((err = git_packbuilder_insert(pb, &oids[i], NULL)) < 0)
+            goto exit;
+    }
+
+    if ((err = git_packbuilder_write(pb, path, 0, NULL, NULL)) < 0)
+        goto exit;
+    strncpy(name, git_packbuilder_name(pb), GIT_OID_HEXSZ);
+    name[GIT_OID_HEXSZ] = '\0';
+
+exit:
+    git_packbuilder_free(pb);
+    git_repository_free(repo);
+    git_odb_free(odb);
+    free(oids);
+    return err;
+}
+
+
+/*
+ * OdbBackendMemory
+ */
+
+PyDoc_STRVAR(OdbBackendMemory_write_pack__doc__,
+  "write_pack(path: str | Path) -> str\n"
+  "\n"
+  "Writes the objects as a pack and its index to the directory, e.g. the\n"
+  "objects/pack directory of a repository, and returns the name of the pack.");
+
+PyObject *
+OdbBackendMemory_write_pack(OdbBackendMemory *self, PyObject *py_path)
+{
+    char name[GIT_OID_HEXSZ + 1];
+    PyObject *tvalue;
+    char *path;
+    int err;
+
+    path = pgit_borrow_fsdefault(py_path, &tvalue);
+    if (path == NULL)
+        return NULL;
+
+    Py_BEGIN_ALLOW_THREADS;
+    err = odb_memory_write_pack(name, (odb_memory *)self->super.odb_backend, path);
+    Py_END_ALLOW_THREADS;
+    Py_DECREF(tvalue);
+    if (err < 0)
+        return Error_set(err);
+
+    return to_unicode(name, NULL, NULL);
+}
+
+PyDoc_STRVAR(OdbBackendMemory_nbytes__doc__,
+  "The size of the objects kept, in bytes.");
+
+PyObject *
+OdbBackendMemory_nbytes__get__(OdbBackendMemory *self)
+{
+    odb_memory *db = (odb_memory *)self->super.odb_backend;
+    size_t bytes;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    bytes = db->bytes;
+    PyThread_release_lock(db->lock);
+    return PyLong_FromSize_t(bytes);
+}
+
+Py_ssize_t
+OdbBackendMemory_len(OdbBackendMemory *self)
+{
+    odb_memory *db = (odb_memory *)self->super.odb_backend;
+    size_t count;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    count = db->count;
+    PyThread_release_lock(db->lock);
+    return (Py_ssize_t)count;
+}
+
+int
+OdbBackendMemory_init(OdbBackendMemory *self, PyObject *args, PyObject *kwds)
+{
+    odb_memory *db;
+
+    if (args && PyTuple_Size(args) > 0) {
+        PyErr_SetString(PyExc_TypeError, "OdbBackendMemory takes no arguments");
+        return -1;
+    }
+
+    if (kwds && PyDict_Size(kwds) > 0) {
+        PyErr_SetString(PyExc_TypeError, "OdbBackendMemory takes no keyword arguments");
+        return -1;
+    }
+
+    if (self->super.odb_backend) {
+        PyErr_SetString(PyExc_RuntimeError, "OdbBackendMemory is already initialized");
+        return -1;
+    }
+
+    db = calloc(1, sizeof(odb_memory));
+    if (db == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    db->lock = PyThread_allocate_lock();
+    db->slots = calloc(ODB_MEMORY_MIN_SLOTS, sizeof(odb_memory_slot));
+    if (db->lock == NULL || db->slots == NULL) {
+        if (db->lock)
+            PyThread_free_lock(db->lock);
+        free(db->slots);
+        free(db);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    git_odb_init_backend(&db->parent, GIT_ODB_BACKEND_VERSION);
+    db->parent.read = odb_memory_read;
+    db->parent.read_prefix = odb_memory_read_prefix;
+    db->parent.read_header = odb_memory_read_header;
+    db->parent.write = odb_memory_write;
+    db->parent.exists = odb_memory_exists;
+    db->parent.exists_prefix = odb_memory_exists_prefix;
+    db->parent.foreach = odb_memory_foreach;
+    db->parent.free = odb_memory_free;
+    db->mask = ODB_MEMORY_MIN_SLOTS - 1;
+    db->refcount = 1;
+
+    self->super.odb_backend = &db->parent;
+    return 0;
+}
+
+void
+OdbBackendMemory_dealloc(OdbBackendMemory *self)
+{
+    if (self->super.odb_backend)
+        odb_memory_release((odb_memory *)self->super.odb_backend);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyMethodDef OdbBackendMemory_methods[] = {
+    METHOD(OdbBackendMemory, write_pack, METH_O),
+    {NULL}
+};
+
+static PyGetSetDef OdbBackendMemory_getseters[] = {
+    GETTER(OdbBackendMemory, nbytes),
+    {NULL}
+};
+
+static PySequenceMethods OdbBackendMemory_as_sequence = {
+    (lenfunc)OdbBackendMemory_len,  /* sq_length */
+    0,                              /* sq_concat */
+    0,                              /* sq_repeat */
+    0,                              /* sq_item */
+    0,                              /* sq_slice */
+    0,                              /* sq_ass_item */
+    0,                              /* sq_ass_slice */
+    0,                              /* sq_contains */
+};
+
+PyDoc_STRVAR(OdbBackendMemory__doc__,
+  "OdbBackendMemory()\n"
+  "\n"
+  "Object database backend keeping the objects in memory. Give it to an odb\n"
+  "with Odb.add_backend(); with a higher priority than the backends on disk\n"
+  "it gets every new object, and so keeps the writes off the disk.\n"
+  "\n"
+  "Being implemented in C, libgit2 uses it without the GIL.");
+
+PyTypeObject OdbBackendMemoryType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.OdbBackendMemory",                /* tp_name           */
+    sizeof(OdbBackendMemory),                  /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)OdbBackendMemory_dealloc,      /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    &OdbBackendMemory_as_sequence,             /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    OdbBackendMemory__doc__,                   /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    OdbBackendMemory_methods,                  /* tp_methods        */
+    0,                                         /* tp_members        */
+    OdbBackendMemory_getseters,                /* tp_getset         */
+    &OdbBackendType,                           /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    (initproc)OdbBackendMemory_init,           /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
@@ -47,6 +47,7 @@ git_oid_to_python(const git_oid *oid)
         return NULL;
 
     git_oid_cpy(&(py_oid->oid), oid);
+    py_oid->hash = -1;
     return (PyObject*)py_oid;
 }
 
@@ -98,6 +99,62 @@ py_oid_to_git_oid(PyObject *py_oid, git_oid *oid)
     return py_hex_to_git_oid(py_oid, oid);
 }
 
+static int
+oid_request_cmp(const void *a, const void *b)
+{
+    const pgit_oid_request *ra = a;
+    const pgit_oid_request *rb = b;
+    int cmp;
+
+    cmp = git_oid_cmp(&ra->oid, &rb->oid);
+    if (cmp == 0)
+        cmp = (ra->pos > rb->pos) - (ra->pos < rb->pos);
+
+    return cmp;
+}
+
+/*
+ * Convert a sequence of oids to an array of lookup requests, sorted by id so
+ * the object database is visited in order. The position of every request in
+ * the original sequence is kept in 'pos'. The array must be released with
+ * PyMem_Free.
+ */
+pgit_oid_request *
+py_oids_to_git_requests(PyObject *py_oids, Py_ssize_t *n)
+{
+    pgit_oid_request *requests;
+    PyObject *seq;
+    Py_ssize_t i, size;
+
+    seq = PySequence_Fast(py_oids, "expected an iterable of oids");
+    if (seq == NULL)
+        return NULL;
+
+    size = PySequence_Fast_GET_SIZE(seq);
+    requests = PyMem_Calloc(size > 0 ? size : 1, sizeof(pgit_oid_request));
+    if (requests == NULL) {
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    for (i = 0; i < size; i++) {
+        requests[i].len = py_oid_to_git_oid(PySequence_Fast_GET_ITEM(seq, i),
+                                            &requests[i].oid);
+        if (requests[i].len == 0) {
+            PyMem_Free(requests);
+            Py_DECREF(seq);
+            return NULL;
+        }
+        requests[i].pos = i;
+    }
+
+    Py_DECREF(seq);
+    qsort(requests, size, sizeof(pgit_oid_request), oid_request_cmp);
+    *n = size;
+    return requests;
+}
+
 int
 py_oid_to_git_oid_expand(git_repository *repo, PyObject *py_str, git_oid *oid)
 {
@@ -155,6 +212,8 @@ Oid_init(Oid *self, PyObject *args, PyObject *kw)
     if (!PyArg_ParseTupleAndKeywords(args, kw, "|OO", keywords, &raw, &hex))
         return -1;
 
+    self->hash = -1;
+
     /* We expect one or the other, but not both. */
     if (raw == NULL && hex == NULL) {
         PyErr_SetString(PyExc_ValueError, "Expected raw or hex.");
@@ -189,13 +248,41 @@ Oid_init(Oid *self, PyObject *args, PyObject *kw)
 }
 
 
+/*
+ * Hash an oid the same as its hex string, since an Oid compares equal to it,
+ * but without creating the string: str hashes the bytes of ASCII strings.
+ */
 Py_hash_t
-Oid_hash(PyObject *oid)
+git_oid_hash(const git_oid *oid)
 {
-    PyObject *py_oid = git_oid_to_py_str(&((Oid *)oid)->oid);
-    Py_hash_t ret = PyObject_Hash(py_oid);
+#if defined(PYPY_VERSION)
+    PyObject *py_oid = git_oid_to_py_str(oid);
+    if (py_oid == NULL)
+        return -1;
+    Py_hash_t hash = PyObject_Hash(py_oid);
     Py_DECREF(py_oid);
-    return ret;
+    return hash;
+#else
+    char hex[GIT_OID_HEXSZ];
+
+    git_oid_fmt(hex, oid);
+#if PY_VERSION_HEX >= 0x030E0000
+    return Py_HashBuffer(hex, GIT_OID_HEXSZ);
+#else
+    return _Py_HashBytes(hex, GIT_OID_HEXSZ);
+#endif
+#endif
+}
+
+Py_hash_t
+Oid_hash(PyObject *oid)
+{
+    Oid *self = (Oid *)oid;
+
+    if (self->hash == -1)
+        self->hash = git_oid_hash(&self->oid);
+
+    return self->hash;
 }
 
 
@@ -37,5 +37,17 @@ int py_oid_to_git_oid_expand(git_repository *repo, PyObject *py_str,
                              git_oid *oid);
 PyObject* git_oid_to_python(const git_oid *oid);
 PyObject* git_oid_to_py_str(const git_oid *oid);
+Py_hash_t git_oid_hash(const git_oid *oid);
+
+/* One request of a batched lookup, see py_oids_to_git_requests */
+typedef struct {
+    git_oid oid;
+    size_t len;
+    Py_ssize_t pos;
+    void *result;
+    int err;
+} pgit_oid_request;
+
+pgit_oid_request *py_oids_to_git_requests(PyObject *py_oids, Py_ssize_t *n);
 
 #endif
@@ -0,0 +1,804 @@
+/*
+ * Copyright 2010-2026 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <git2.h>
+#include "error.h"
+#include "oid.h"
+#include "types.h"
+#include "utils.h"
+
+extern PyTypeObject OidSetType;
+extern PyTypeObject OidMapType;
+extern PyTypeObject OidTableIterType;
+
+/*
+ * OidTable
+ *
+ * The keys are stored inline, 20 bytes each, with linear probing. Object ids
+ * are uniformly distributed already, so the first bytes of the id are used
+ * as the hash. Removal shifts the following entries back instead of leaving
+ * tombstones.
+ */
+
+#define OID_TABLE_MIN_CAPACITY 16
+
+/* What an iterator yields */
+#define OID_TABLE_KEYS   0
+#define OID_TABLE_VALUES 1
+#define OID_TABLE_ITEMS  2
+
+static size_t
+oid_table_hash(const git_oid *oid)
+{
+    size_t hash;
+
+    memcpy(&hash, oid->id, sizeof(hash));
+    return hash;
+}
+
+/* Return the slot of the oid, or of the free slot where it would go */
+static size_t
+oid_table_find(const OidTable *table, const git_oid *oid, int *found)
+{
+    size_t i = oid_table_hash(oid) & table->mask;
+
+    while (table->used[i]) {
+        if (git_oid_equal(&table->keys[i], oid)) {
+            *found = 1;
+            return i;
+        }
+        i = (i + 1) & table->mask;
+    }
+
+    *found = 0;
+    return i;
+}
+
+static int
+oid_table_contains(const OidTable *table, const git_oid *oid)
+{
+    int found = 0;
+
+    if (table->size > 0)
+        oid_table_find(table, oid, &found);
+
+    return found;
+}
+
+static int
+oid_table_resize(OidTable *table, size_t capacity, int with_values)
+{
+    OidTable new_table;
+    size_t i, slot;
+    int found;
+
+    new_table.keys = PyMem_Malloc(capacity * sizeof(git_oid));
+    new_table.used = PyMem_Calloc(capacity, 1);
+    new_table.values = with_values ? PyMem_Calloc(capacity, sizeof(PyObject *)) : NULL;
+    if (new_table.keys == NULL || new_table.used == NULL ||
+        (with_values && new_table.values == NULL)) {
+        PyMem_Free(new_table.keys);
+        PyMem_Free(new_table.used);
+        PyMem_Free(new_table.values);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    new_table.mask = capacity - 1;
+    new_table.size = table->size;
+    new_table.version = table->version;
+
+    for (i = 0; table->used && i <= table->mask; i++) {
+        if (!table->used[i])
+            continue;
+
+        slot = oid_table_find(&new_table, &table->keys[i], &found);
+        new_table.used[slot] = 1;
+        git_oid_cpy(&new_table.keys[slot], &table->keys[i]);
+        if (with_values)
+            new_table.values[slot] = table->values[i];
+    }
+
+    PyMem_Free(table->keys);
+    PyMem_Free(table->used);
+    PyMem_Free(table->values);
+    *table = new_table;
+    return 0;
+}
+
+/*
+ * Find the slot of the oid, inserting it if missing. Returns the slot or -1
+ * on error. The value of a new slot is NULL.
+ */
+static Py_ssize_t
+oid_table_insert(OidTable *table, const git_oid *oid, int with_values)
+{
+    size_t capacity = table->used ? table->mask + 1 : 0;
+    size_t slot;
+    int found;
+
+    /* Keep the load factor under 0.7 */
+    if ((table->size + 1) * 10 > capacity * 7) {
+        size_t new_capacity = capacity ? capacity * 2 : OID_TABLE_MIN_CAPACITY;
+        if (oid_table_resize(table, new_capacity, with_values) < 0)
+            return -1;
+    }
+
+    slot = oid_table_find(table, oid, &found);
+    if (!found) {
+        table->used[slot] = 1;
+        git_oid_cpy(&table->keys[slot], oid);
+        table->size++;
+        table->version++;
+    }
+
+    return (Py_ssize_t)slot;
+}
+
+/* Remove the entry of the given slot, the caller releases the value */
+static void
+oid_table_remove(OidTable *table, size_t i)
+{
+    size_t j = i, k;
+
+    for (;;) {
+        j = (j + 1) & table->mask;
+        if (!table->used[j])
+            break;
+
+        /* Move the entry back unless its home slot is in (i, j] */
+        k = oid_table_hash(&table->keys[j]) & table->mask;
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+
+        git_oid_cpy(&table->keys[i], &table->keys[j]);
+        if (table->values)
+            table->values[i] = table->values[j];
+        i = j;
+    }
+
+    table->used[i] = 0;
+    if (table->values)
+        table->values[i] = NULL;
+    table->size--;
+    table->version++;
+}
+
+static void
+oid_table_clear(OidTable *table)
+{
+    OidTable old = *table;
+    size_t i;
+
+    /* Empty the table first, releasing a value may run arbitrary code */
+    table->keys = NULL;
+    table->used = NULL;
+    table->values = NULL;
+    table->mask = 0;
+    table->size = 0;
+    table->version++;
+
+    for (i = 0; old.values && i <= old.mask; i++) {
+        if (old.used[i])
+            Py_DECREF(old.values[i]);
+    }
+
+    PyMem_Free(old.keys);
+    PyMem_Free(old.used);
+    PyMem_Free(old.values);
+}
+
+/* Convert a key, which must be a full oid */
+static int
+oid_table_key(PyObject *py_oid, git_oid *oid)
+{
+    size_t len = py_oid_to_git_oid(py_oid, oid);
+    if (len == 0)
+        return -1;
+
+    if (len != GIT_OID_HEXSZ) {
+        PyErr_SetObject(PyExc_ValueError, py_oid);
+        return -1;
+    }
+
+    return 0;
+}
+
+static PyObject *
+oid_table_iter(PyObject *owner, int kind)
+{
+    OidTableIter *iter;
+
+    iter = PyObject_New(OidTableIter, &OidTableIterType);
+    if (iter) {
+        Py_INCREF(owner);
+        iter->owner = owner;
+        iter->pos = 0;
+        iter->version = ((OidSet *)owner)->table.version;
+        iter->kind = kind;
+    }
+    return (PyObject *)iter;
+}
+
+
+/*
+ * OidSet
+ */
+
+PyDoc_STRVAR(OidSet_add__doc__,
+  "add(oid: Oid)\n"
+  "\n"
+  "Add an oid to the set.");
+
+PyObject *
+OidSet_add(OidSet *self, PyObject *py_oid)
+{
+    git_oid oid;
+
+    if (oid_table_key(py_oid, &oid) < 0)
+        return NULL;
+
+    if (oid_table_insert(&self->table, &oid, 0) < 0)
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(OidSet_discard__doc__,
+  "discard(oid: Oid)\n"
+  "\n"
+  "Remove an oid from the set if it is present.");
+
+PyObject *
+OidSet_discard(OidSet *self, PyObject *py_oid)
+{
+    git_oid oid;
+    size_t slot;
+    int found = 0;
+
+    if (oid_table_key(py_oid, &oid) < 0)
+        return NULL;
+
+    if (self->table.size > 0) {
+        slot = oid_table_find(&self->table, &oid, &found);
+        if (found)
+            oid_table_remove(&self->table, slot);
+    }
+
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(OidSet_update__doc__,
+  "update(oids: Iterable[Oid])\n"
+  "\n"
+  "Add all the given oids to the set.");
+
+PyObject *
+OidSet_update(OidSet *self, PyObject *py_oids)
+{
+    PyObject *iter, *item;
+    git_oid oid;
+    int err;
+
+    iter = PyObject_GetIter(py_oids);
+    if (iter == NULL)
+        return NULL;
+
+    while ((item = PyIter_Next(iter))) {
+        err = oid_table_key(item, &oid);
+        Py_DECREF(item);
+        if (err < 0 || oid_table_insert(&self->table, &oid, 0) < 0) {
+            Py_DECREF(iter);
+            return NULL;
+        }
+    }
+
+    Py_DECREF(iter);
+    if (PyErr_Occurred())
+        return NULL;
+
+    Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(OidSet_clear__doc__,
+  "clear()\n"
+  "\n"
+  "Remove all the oids from the set.");
+
+PyObject *
+OidSet_clear(OidSet *self)
+{
+    oid_table_clear(&self->table);
+    Py_RETURN_NONE;
+}
+
+int
+OidSet_init(OidSet *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *py_oids = NULL;
+    PyObject *result;
+
+    if (!PyArg_ParseTuple(args, "|O", &py_oids))
+        return -1;
+
+    if (kwds && PyDict_Size(kwds) > 0) {
+        PyErr_SetString(PyExc_TypeError, "OidSet takes no keyword arguments");
+        return -1;
+    }
+
+    oid_table_clear(&self->table);
+    if (py_oids == NULL)
+        return 0;
+
+    result = OidSet_update(self, py_oids);
+    if (result == NULL)
+        return -1;
+
+    Py_DECREF(result);
+    return 0;
+}
+
+void
+OidSet_dealloc(OidSet *self)
+{
+    oid_table_clear(&self->table);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+Py_ssize_t
+OidSet_len(OidSet *self)
+{
+    return (Py_ssize_t)self->table.size;
+}
+
+int
+OidSet_contains(OidSet *self, PyObject *py_oid)
+{
+    git_oid oid;
+
+    if (oid_table_key(py_oid, &oid) < 0)
+        return -1;
+
+    return oid_table_contains(&self->table, &oid);
+}
+
+PyObject *
+OidSet_iter(OidSet *self)
+{
+    return oid_table_iter((PyObject *)self, OID_TABLE_KEYS);
+}
+
+PySequenceMethods OidSet_as_sequence = {
+    (lenfunc)OidSet_len,            /* sq_length */
+    0,                              /* sq_concat */
+    0,                              /* sq_repeat */
+    0,                              /* sq_item */
+    0,                              /* sq_slice */
+    0,                              /* sq_ass_item */
+    0,                              /* sq_ass_slice */
+    (objobjproc)OidSet_contains,    /* sq_contains */
+};
+
+static PyMethodDef OidSet_methods[] = {
+    METHOD(OidSet, add, METH_O),
+    METHOD(OidSet, clear, METH_NOARGS),
+    METHOD(OidSet, discard, METH_O),
+    METHOD(OidSet, update, METH_O),
+    {NULL}
+};
+
+PyDoc_STRVAR(OidSet__doc__,
+  "OidSet(oids: Iterable[Oid] = ())\n"
+  "\n"
+  "Set of object ids. Takes much less memory than a set of Oid objects, and\n"
+  "membership tests do not create any object. Accepts Oid objects and full\n"
+  "hex strings, iterating yields Oid objects.");
+
+PyTypeObject OidSetType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.OidSet",                          /* tp_name           */
+    sizeof(OidSet),                            /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)OidSet_dealloc,                /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    &OidSet_as_sequence,                       /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    OidSet__doc__,                             /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    (getiterfunc)OidSet_iter,                  /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    OidSet_methods,                            /* tp_methods        */
+    0,                                         /* tp_members        */
+    0,                                         /* tp_getset         */
+    0,                                         /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    (initproc)OidSet_init,                     /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
+
+
+/*
+ * OidMap
+ */
+
+PyDoc_STRVAR(OidMap_get__doc__,
+  "get(oid: Oid, default: object = None) -> object\n"
+  "\n"
+  "Return the value for the given oid, or default if it is not in the map.");
+
+PyObject *
+OidMap_get(OidMap *self, PyObject *args)
+{
+    PyObject *py_oid, *value = Py_None;
+    git_oid oid;
+    size_t slot;
+    int found = 0;
+
+    if (!PyArg_ParseTuple(args, "O|O", &py_oid, &value))
+        return NULL;
+
+    if (oid_table_key(py_oid, &oid) < 0)
+        return NULL;
+
+    if (self->table.size > 0) {
+        slot = oid_table_find(&self->table, &oid, &found);
+        if (found)
+            value = self->table.values[slot];
+    }
+
+    Py_INCREF(value);
+    return value;
+}
+
+PyDoc_STRVAR(OidMap_items__doc__,
+  "items() -> Iterator[tuple[Oid, object]]\n"
+  "\n"
+  "Return an iterator over the (oid, value) pairs of the map.");
+
+PyObject *
+OidMap_items(OidMap *self)
+{
+    return oid_table_iter((PyObject *)self, OID_TABLE_ITEMS);
+}
+
+PyDoc_STRVAR(OidMap_values__doc__,
+  "values() -> Iterator[object]\n"
+  "\n"
+  "Return an iterator over the values of the map.");
+
+PyObject *
+OidMap_values(OidMap *self)
+{
+    return oid_table_iter((PyObject *)self, OID_TABLE_VALUES);
+}
+
+PyDoc_STRVAR(OidMap_clear__doc__,
+  "clear()\n"
+  "\n"
+  "Remove all the entries from the map.");
+
+PyObject *
+OidMap_clear(OidMap *self)
+{
+    oid_table_clear(&self->table);
+    Py_RETURN_NONE;
+}
+
+int
+OidMap_init(OidMap *self, PyObject *args, PyObject *kwds)
+{
+    if (!PyArg_ParseTuple(args, ""))
+        return -1;
+
+    if (kwds && PyDict_Size(kwds) > 0) {
+        PyErr_SetString(PyExc_TypeError, "OidMap takes no keyword arguments");
+        return -1;
+    }
+
+    oid_table_clear(&self->table);
+    return 0;
+}
+
+int
+OidMap_traverse(OidMap *self, visitproc visit, void *arg)
+{
+    size_t i;
+
+    for (i = 0; self->table.used && i <= self->table.mask; i++) {
+        if (self->table.used[i])
+            Py_VISIT(self->table.values[i]);
+    }
+    return 0;
+}
+
+int
+OidMap_tp_clear(OidMap *self)
+{
+    oid_table_clear(&self->table);
+    return 0;
+}
+
+void
+OidMap_dealloc(OidMap *self)
+{
+    PyObject_GC_UnTrack(self);
+    oid_table_clear(&self->table);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+Py_ssize_t
+OidMap_len(OidMap *self)
+{
+    return (Py_ssize_t)self->table.size;
+}
+
+int
+OidMap_contains(OidMap *self, PyObject *py_oid)
+{
+    git_oid oid;
+
+    if (oid_table_key(py_oid, &oid) < 0)
+        return -1;
+
+    return oid_table_contains(&self->table, &oid);
+}
+
+PyObject *
+OidMap_getitem(OidMap *self, PyObject *py_oid)
+{
+    git_oid oid;
+    size_t slot = 0;
+    int found = 0;
+
+    if (oid_table_key(py_oid, &oid) < 0)
+        return NULL;
+
+    if (self->table.size > 0)
+        slot = oid_table_find(&self->table, &oid, &found);
+
+    if (!found) {
+        PyErr_SetObject(PyExc_KeyError, py_oid);
+        return NULL;
+    }
+
+    Py_INCREF(self->table.values[slot]);
+    return self->table.values[slot];
+}
+
+int
+OidMap_setitem(OidMap *self, PyObject *py_oid, PyObject *value)
+{
+    PyObject *old;
+    git_oid oid;
+    Py_ssize_t slot = 0;
+    int found = 0;
+
+    if (oid_table_key(py_oid, &oid) < 0)
+        return -1;
+
+    /* Delete */
+    if (value == NULL) {
+        if (self->table.size > 0)
+            slot = oid_table_find(&self->table, &oid, &found);
+        if (!found) {
+            PyErr_SetObject(PyExc_KeyError, py_oid);
+            return -1;
+        }
+
+        old = self->table.values[slot];
+        oid_table_remove(&self->table, slot);
+        Py_DECREF(old);
+        return 0;
+    }
+
+    /* Insert or replace */
+    slot = oid_table_insert(&self->table, &oid, 1);
+    if (slot < 0)
+        return -1;
+
+    old = self->table.values[slot];
+    Py_INCREF(value);
+    self->table.values[slot] = value;
+    Py_XDECREF(old);
+    return 0;
+}
+
+PyObject *
+OidMap_iter(OidMap *self)
+{
+    return oid_table_iter((PyObject *)self, OID_TABLE_KEYS);
+}
+
+PySequenceMethods OidMap_as_sequence = {
+    0,                              /* sq_length */
+    0,                              /* sq_concat */
+    0,                              /* sq_repeat */
+    0,                              /* sq_item */
+    0,                              /* sq_slice */
+    0,                              /* sq_ass_item */
+    0,                              /* sq_ass_slice */
+    (objobjproc)OidMap_contains,    /* sq_contains */
+};
+
+PyMappingMethods OidMap_as_mapping = {
+    (lenfunc)OidMap_len,              /* mp_length */
+    (binaryfunc)OidMap_getitem,       /* mp_subscript */
+    (objobjargproc)OidMap_setitem,    /* mp_ass_subscript */
+};
+
+static PyMethodDef OidMap_methods[] = {
+    METHOD(OidMap, clear, METH_NOARGS),
+    METHOD(OidMap, get, METH_VARARGS),
+    METHOD(OidMap, items, METH_NOARGS),
+    METHOD(OidMap, values, METH_NOARGS),
+    {NULL}
+};
+
+PyDoc_STRVAR(OidMap__doc__,
+  "OidMap()\n"
+  "\n"
+  "Dictionary keyed by object id, the counterpart of OidSet. Accepts Oid\n"
+  "objects and full hex strings as keys, iterating yields Oid objects.");
+
+PyTypeObject OidMapType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.OidMap",                          /* tp_name           */
+    sizeof(OidMap),                            /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)OidMap_dealloc,                /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    &OidMap_as_sequence,                       /* tp_as_sequence    */
+    &OidMap_as_mapping,                        /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,   /* tp_flags          */
+    OidMap__doc__,                             /* tp_doc            */
+    (traverseproc)OidMap_traverse,             /* tp_traverse       */
+    (inquiry)OidMap_tp_clear,                  /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    (getiterfunc)OidMap_iter,                  /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    OidMap_methods,                            /* tp_methods        */
+    0,                                         /* tp_members        */
+    0,                                         /* tp_getset         */
+    0,                                         /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    (initproc)OidMap_init,                     /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
+
+
+/*
+ * Iterator over the keys, values or items of an OidSet or OidMap
+ */
+
+void
+OidTableIter_dealloc(OidTableIter *self)
+{
+    Py_CLEAR(self->owner);
+    PyObject_Del(self);
+}
+
+PyObject *
+OidTableIter_iternext(OidTableIter *self)
+{
+    OidTable *table = &((OidSet *)self->owner)->table;
+    PyObject *py_oid;
+    size_t i;
+
+    if (self->version != table->version) {
+        PyErr_SetString(PyExc_RuntimeError, "container changed during iteration");
+        return NULL;
+    }
+
+    for (i = self->pos; table->used && i <= table->mask; i++) {
+        if (!table->used[i])
+            continue;
+
+        self->pos = i + 1;
+        if (self->kind == OID_TABLE_VALUES) {
+            Py_INCREF(table->values[i]);
+            return table->values[i];
+        }
+
+        py_oid = git_oid_to_python(&table->keys[i]);
+        if (py_oid == NULL || self->kind == OID_TABLE_KEYS)
+            return py_oid;
+
+        return Py_BuildValue("NO", py_oid, table->values[i]);
+    }
+
+    self->pos = i;
+    return NULL;
+}
+
+PyDoc_STRVAR(OidTableIter__doc__, "OidSet and OidMap iterator.");
+
+PyTypeObject OidTableIterType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.OidTableIter",                    /* tp_name           */
+    sizeof(OidTableIter),                      /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)OidTableIter_dealloc,          /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    OidTableIter__doc__,                       /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    PyObject_SelfIter,                         /* tp_iter           */
+    (iternextfunc)OidTableIter_iternext,       /* tp_iternext       */
+};
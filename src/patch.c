@@ -239,10 +239,151 @@ Patch_hunks__get__(Patch *self)
     return py_hunks;
 }
 
+/* Wrap a bytes object in a memoryview of the given format, steals bytes */
+static PyObject *
+line_table_column(PyObject *bytes, const char *format)
+{
+    PyObject *view, *result;
+
+    if (bytes == NULL)
+        return NULL;
+
+    view = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    if (view == NULL || format[0] == 'B')
+        return view;
+
+    result = PyObject_CallMethod(view, "cast", "s", format);
+    Py_DECREF(view);
+    return result;
+}
+
+PyDoc_STRVAR(Patch_line_table__doc__,
+  "line_table() -> dict[str, bytes | memoryview]\n"
+  "\n"
+  "Return all the lines of the patch as flat columns, without creating a\n"
+  "DiffHunk or DiffLine object per hunk or line. The dictionary has:\n"
+  "\n"
+  "content\n"
+  "    The contents of all the lines, concatenated (bytes).\n"
+  "\n"
+  "offsets\n"
+  "    Line i is content[offsets[i]:offsets[i+1]] (format 'q').\n"
+  "\n"
+  "origin\n"
+  "    The origin of every line, e.g. ord('+') (format 'B').\n"
+  "\n"
+  "old_lineno, new_lineno\n"
+  "    Line numbers in the old and new files, or -1 (format 'i').\n"
+  "\n"
+  "hunk_offsets\n"
+  "    The lines of hunk j are lines hunk_offsets[j] to hunk_offsets[j+1]\n"
+  "    (format 'q').\n"
+  "\n"
+  "Example::\n"
+  "\n"
+  "  >>> table = patch.line_table()\n"
+  "  >>> offsets = table['offsets']\n"
+  "  >>> first = table['content'][offsets[0]:offsets[1]]\n");
+
+PyObject *
+Patch_line_table(Patch *self)
+{
+    static const char *names[5] = {"offsets", "origin", "old_lineno", "new_lineno", "hunk_offsets"};
+    static const char *formats[5] = {"q", "B", "i", "i", "q"};
+    const git_diff_line *line;
+    size_t h, i, nhunks, nlines, total = 0, size = 0;
+    PyObject *content = NULL, *columns[5] = {NULL};
+    PyObject *result = NULL, *column;
+    char *content_p, *origin_p;
+    int64_t *offsets_p, *hunk_offsets_p;
+    int32_t *old_p, *new_p;
+    int err;
+
+    assert(self->patch);
+    nhunks = git_patch_num_hunks(self->patch);
+
+    /* First pass, to size the columns */
+    for (h = 0; h < nhunks; h++) {
+        nlines = git_patch_num_lines_in_hunk(self->patch, h);
+        for (i = 0; i < nlines; i++) {
+            err = git_patch_get_line_in_hunk(&line, self->patch, h, i);
+            if (err < 0)
+                return Error_set(err);
+            size += line->content_len;
+        }
+        total += nlines;
+    }
+
+    content = PyBytes_FromStringAndSize(NULL, size);
+    columns[0] = PyBytes_FromStringAndSize(NULL, (total + 1) * sizeof(int64_t));
+    columns[1] = PyBytes_FromStringAndSize(NULL, total);
+    columns[2] = PyBytes_FromStringAndSize(NULL, total * sizeof(int32_t));
+    columns[3] = PyBytes_FromStringAndSize(NULL, total * sizeof(int32_t));
+    columns[4] = PyBytes_FromStringAndSize(NULL, (nhunks + 1) * sizeof(int64_t));
+    if (!content || !columns[0] || !columns[1] || !columns[2] || !columns[3] || !columns[4])
+        goto error;
+
+    content_p = PyBytes_AS_STRING(content);
+    offsets_p = (int64_t *)PyBytes_AS_STRING(columns[0]);
+    origin_p = PyBytes_AS_STRING(columns[1]);
+    old_p = (int32_t *)PyBytes_AS_STRING(columns[2]);
+    new_p = (int32_t *)PyBytes_AS_STRING(columns[3]);
+    hunk_offsets_p = (int64_t *)PyBytes_AS_STRING(columns[4]);
+
+    /* Second pass, to fill them */
+    *offsets_p = 0;
+    *hunk_offsets_p++ = 0;
+    size = 0;
+    total = 0;
+    for (h = 0; h < nhunks; h++) {
+        nlines = git_patch_num_lines_in_hunk(self->patch, h);
+        for (i = 0; i < nlines; i++) {
+            git_patch_get_line_in_hunk(&line, self->patch, h, i);
+            memcpy(content_p + size, line->content, line->content_len);
+            size += line->content_len;
+            *++offsets_p = (int64_t)size;
+            *origin_p++ = line->origin;
+            *old_p++ = line->old_lineno;
+            *new_p++ = line->new_lineno;
+        }
+        total += nlines;
+        *hunk_offsets_p++ = (int64_t)total;
+    }
+
+    result = PyDict_New();
+    if (result == NULL)
+        goto error;
+
+    if (PyDict_SetItemString(result, "content", content) < 0)
+        goto error;
+    Py_CLEAR(content);
+
+    for (i = 0; i < 5; i++) {
+        column = line_table_column(columns[i], formats[i]);
+        columns[i] = NULL;
+        if (column == NULL || PyDict_SetItemString(result, names[i], column) < 0) {
+            Py_XDECREF(column);
+            goto error;
+        }
+        Py_DECREF(column);
+    }
+
+    return result;
+
+error:
+    Py_XDECREF(content);
+    for (i = 0; i < 5; i++)
+        Py_XDECREF(columns[i]);
+    Py_XDECREF(result);
+    return NULL;
+}
+
 
 static PyMethodDef Patch_methods[] = {
     {"create_from", (PyCFunction) Patch_create_from,
       METH_KEYWORDS | METH_VARARGS | METH_STATIC, Patch_create_from__doc__},
+    METHOD(Patch, line_table, METH_NOARGS),
     {NULL}
 };
 
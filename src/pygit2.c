@@ -57,10 +57,17 @@ PyObject *ReferenceTypeEnum;
 
 extern PyTypeObject RepositoryType;
 extern PyTypeObject OdbType;
+extern PyTypeObject OdbIterType;
+extern PyTypeObject BufferType;
+extern PyTypeObject OdbObjectType;
 extern PyTypeObject OdbBackendType;
 extern PyTypeObject OdbBackendPackType;
 extern PyTypeObject OdbBackendLooseType;
+extern PyTypeObject OdbBackendMemoryType;
 extern PyTypeObject OidType;
+extern PyTypeObject OidSetType;
+extern PyTypeObject OidMapType;
+extern PyTypeObject OidTableIterType;
 extern PyTypeObject ObjectType;
 extern PyTypeObject CommitType;
 extern PyTypeObject DiffType;
@@ -70,17 +77,21 @@ extern PyTypeObject DiffDeltaType;
 extern PyTypeObject DiffFileType;
 extern PyTypeObject DiffHunkType;
 extern PyTypeObject DiffLineType;
+extern PyTypeObject DiffLinesIterType;
 extern PyTypeObject DiffStatsType;
+extern PyTypeObject SimilarityCacheType;
 extern PyTypeObject PatchType;
 extern PyTypeObject TreeType;
 extern PyTypeObject TreeBuilderType;
 extern PyTypeObject TreeIterType;
 extern PyTypeObject BlobType;
+extern PyTypeObject BlobReaderType;
 extern PyTypeObject TagType;
 extern PyTypeObject WalkerType;
 extern PyTypeObject RefdbType;
 extern PyTypeObject RefdbBackendType;
 extern PyTypeObject RefdbFsBackendType;
+extern PyTypeObject RefdbMemoryBackendType;
 extern PyTypeObject ReferenceType;
 extern PyTypeObject RevSpecType;
 extern PyTypeObject RefLogIterType;
@@ -95,6 +106,7 @@ extern PyTypeObject WorktreeType;
 extern PyTypeObject MailmapType;
 extern PyTypeObject StashType;
 extern PyTypeObject RefsIteratorType;
+extern PyTypeObject RefsSnapshotType;
 extern PyTypeObject FilterSourceType;
 
 
@@ -475,13 +487,19 @@ PyInit__pygit2(void)
     ADD_EXC(m, AuthError, GitError);
     ADD_EXC(m, CertificateError, GitError);
 
+    /* Memory of the columnar results */
+    INIT_TYPE(BufferType, NULL, NULL)
+
     /* Repository */
     INIT_TYPE(RepositoryType, NULL, PyType_GenericNew)
     ADD_TYPE(m, Repository)
 
     /* Odb */
     INIT_TYPE(OdbType, NULL, PyType_GenericNew)
+    INIT_TYPE(OdbIterType, NULL, NULL)
     ADD_TYPE(m, Odb)
+    INIT_TYPE(OdbObjectType, NULL, NULL)
+    ADD_TYPE(m, OdbObject)
 
     INIT_TYPE(OdbBackendType, NULL, PyType_GenericNew)
     ADD_TYPE(m, OdbBackend)
@@ -489,10 +507,17 @@ PyInit__pygit2(void)
     ADD_TYPE(m, OdbBackendPack)
     INIT_TYPE(OdbBackendLooseType, &OdbBackendType, PyType_GenericNew)
     ADD_TYPE(m, OdbBackendLoose)
+    INIT_TYPE(OdbBackendMemoryType, &OdbBackendType, PyType_GenericNew)
+    ADD_TYPE(m, OdbBackendMemory)
 
     /* Oid */
     INIT_TYPE(OidType, NULL, PyType_GenericNew)
     ADD_TYPE(m, Oid)
+    INIT_TYPE(OidSetType, NULL, PyType_GenericNew)
+    ADD_TYPE(m, OidSet)
+    INIT_TYPE(OidMapType, NULL, PyType_GenericNew)
+    ADD_TYPE(m, OidMap)
+    INIT_TYPE(OidTableIterType, NULL, NULL)
     ADD_CONSTANT_INT(m, GIT_OID_RAWSZ)
     ADD_CONSTANT_INT(m, GIT_OID_HEXSZ)
     ADD_CONSTANT_STR(m, GIT_OID_HEX_ZERO)
@@ -508,6 +533,7 @@ PyInit__pygit2(void)
     INIT_TYPE(TreeIterType, NULL, NULL)
     INIT_TYPE(TreeBuilderType, NULL, NULL)
     INIT_TYPE(BlobType, &ObjectType, NULL)
+    INIT_TYPE(BlobReaderType, NULL, PyType_GenericNew)
     INIT_TYPE(TagType, &ObjectType, NULL)
     INIT_TYPE(RefsIteratorType, NULL, NULL)
     ADD_TYPE(m, Object)
@@ -516,6 +542,7 @@ PyInit__pygit2(void)
     ADD_TYPE(m, Tree)
     ADD_TYPE(m, TreeBuilder)
     ADD_TYPE(m, Blob)
+    ADD_TYPE(m, BlobReader)
     ADD_TYPE(m, Tag)
     ADD_CONSTANT_INT(m, GIT_OBJECT_ANY)
     ADD_CONSTANT_INT(m, GIT_OBJECT_INVALID)
@@ -558,6 +585,8 @@ PyInit__pygit2(void)
     ADD_TYPE(m, RefdbBackend)
     INIT_TYPE(RefdbFsBackendType, &RefdbBackendType, PyType_GenericNew)
     ADD_TYPE(m, RefdbFsBackend)
+    INIT_TYPE(RefdbMemoryBackendType, &RefdbBackendType, PyType_GenericNew)
+    ADD_TYPE(m, RefdbMemoryBackend)
 
     /*
      * References
@@ -567,9 +596,11 @@ PyInit__pygit2(void)
     INIT_TYPE(RefLogIterType, NULL, NULL)
     INIT_TYPE(NoteType, NULL, NULL)
     INIT_TYPE(NoteIterType, NULL, NULL)
+    INIT_TYPE(RefsSnapshotType, NULL, NULL)
     ADD_TYPE(m, Reference)
     ADD_TYPE(m, RefLogEntry)
     ADD_TYPE(m, Note)
+    ADD_TYPE(m, RefsSnapshot)
     ADD_CONSTANT_INT(m, GIT_REFERENCES_ALL)
     ADD_CONSTANT_INT(m, GIT_REFERENCES_BRANCHES)
     ADD_CONSTANT_INT(m, GIT_REFERENCES_TAGS)
@@ -650,8 +681,10 @@ PyInit__pygit2(void)
     INIT_TYPE(DiffFileType, NULL, NULL)
     INIT_TYPE(DiffHunkType, NULL, NULL)
     INIT_TYPE(DiffLineType, NULL, NULL)
+    INIT_TYPE(DiffLinesIterType, NULL, NULL)
     INIT_TYPE(DiffStatsType, NULL, NULL)
     INIT_TYPE(PatchType, NULL, NULL)
+    INIT_TYPE(SimilarityCacheType, NULL, PyType_GenericNew)
     ADD_TYPE(m, Diff)
     ADD_TYPE(m, DiffDelta)
     ADD_TYPE(m, DiffFile)
@@ -659,6 +692,7 @@ PyInit__pygit2(void)
     ADD_TYPE(m, DiffLine)
     ADD_TYPE(m, DiffStats)
     ADD_TYPE(m, Patch)
+    ADD_TYPE(m, SimilarityCache)
 
     /* (git_diff_options in libgit2) */
     ADD_CONSTANT_INT(m, GIT_DIFF_NORMAL)
@@ -700,6 +734,14 @@ PyInit__pygit2(void)
     ADD_CONSTANT_INT(m, GIT_DIFF_STATS_NUMBER)
     ADD_CONSTANT_INT(m, GIT_DIFF_STATS_INCLUDE_SUMMARY)
 
+    /* Output formats for Diff.write_patch (git_diff_format_t in libgit2) */
+    ADD_CONSTANT_INT(m, GIT_DIFF_FORMAT_PATCH)
+    ADD_CONSTANT_INT(m, GIT_DIFF_FORMAT_PATCH_HEADER)
+    ADD_CONSTANT_INT(m, GIT_DIFF_FORMAT_RAW)
+    ADD_CONSTANT_INT(m, GIT_DIFF_FORMAT_NAME_ONLY)
+    ADD_CONSTANT_INT(m, GIT_DIFF_FORMAT_NAME_STATUS)
+    ADD_CONSTANT_INT(m, GIT_DIFF_FORMAT_PATCH_ID)
+
     /* Flags for Diff.find_similar (git_diff_find_t in libgit2) */
     ADD_CONSTANT_INT(m, GIT_DIFF_FIND_BY_CONFIG) /** Obey diff.renames */
     ADD_CONSTANT_INT(m, GIT_DIFF_FIND_RENAMES) /* --find-renames */
@@ -809,6 +851,10 @@ PyInit__pygit2(void)
     ADD_CONSTANT_INT(m, GIT_SUBMODULE_STATUS_WD_WD_MODIFIED);
     ADD_CONSTANT_INT(m, GIT_SUBMODULE_STATUS_WD_UNTRACKED);
 
+    /* Tree.walk (git_treewalk_mode in libgit2) */
+    ADD_CONSTANT_INT(m, GIT_TREEWALK_PRE)
+    ADD_CONSTANT_INT(m, GIT_TREEWALK_POST)
+
     /* Mailmap */
     INIT_TYPE(MailmapType, NULL, PyType_GenericNew)
     ADD_TYPE(m, Mailmap)
@@ -29,6 +29,7 @@
 #include <Python.h>
 #include "error.h"
 #include "refdb.h"
+#include "refdb_memory.h"
 #include "types.h"
 #include "utils.h"
 #include <git2/refdb.h>
@@ -73,6 +74,9 @@ Refdb_set_backend(Refdb *self, RefdbBackend *backend)
     err = git_refdb_set_backend(self->refdb, backend->refdb_backend);
     if (err != 0)
         return Error_set(err);
+
+    /* The refdb frees it, but the Python object may still use it */
+    refdb_memory_retain(backend->refdb_backend);
     Py_RETURN_NONE;
 }
 
@@ -64,6 +64,9 @@ struct pygit2_refdb_backend
              *unlock;
 };
 
+/* Number of backends implemented in Python, changed with the GIL held */
+static Py_ssize_t python_backends = 0;
+
 struct pygit2_refdb_iterator {
     struct git_reference_iterator base;
     PyObject *iterator;
@@ -195,8 +198,22 @@ pygit2_refdb_backend_iterator(git_reference_iterator **iter,
     const char *glob)
 {
     struct pygit2_refdb_backend *be = (struct pygit2_refdb_backend *)_be;
-    PyObject *iterator = PyObject_GetIter((PyObject *)be->RefdbBackend);
-    assert(iterator);
+    PyObject *iterator, *result;
+
+    // Backends with an iterator(glob) method get the glob, so they can skip
+    // the references it excludes; the others are iterated in full. Either
+    // way the names are matched against the glob below.
+    if (be->iterator) {
+        result = PyObject_CallFunction(be->iterator, "(z)", glob);
+        if (result == NULL)
+            return GIT_EUSER;
+        iterator = PyObject_GetIter(result);
+        Py_DECREF(result);
+    } else {
+        iterator = PyObject_GetIter((PyObject *)be->RefdbBackend);
+    }
+    if (iterator == NULL)
+        return GIT_EUSER;
 
     struct pygit2_refdb_iterator *pyiter = calloc(1, sizeof(struct pygit2_refdb_iterator));
     if (pyiter == NULL) {
@@ -503,6 +520,23 @@ pygit2_refdb_backend_free(git_refdb_backend *_be)
     Py_DECREF(be->RefdbBackend);
 }
 
+/*
+ * Whether references may be read without the GIL. libgit2 does not tell
+ * which backend a refdb uses, so this is only the case while no backend
+ * implemented in Python exists.
+ */
+int
+refdb_allows_threads(void)
+{
+    return python_backends == 0;
+}
+
+int
+refdb_backend_is_python(git_refdb_backend *backend)
+{
+    return backend->free == pygit2_refdb_backend_free;
+}
+
 int
 RefdbBackend_init(RefdbBackend *self, PyObject *args, PyObject *kwds)
 {
@@ -524,7 +558,10 @@ RefdbBackend_init(RefdbBackend *self, PyObject *args, PyObject *kwds)
     git_refdb_init_backend(&be->backend, GIT_REFDB_BACKEND_VERSION);
     be->RefdbBackend = (PyObject *)self;
 
-    if (PyIter_Check((PyObject *)self)) {
+    if (PyObject_HasAttrString((PyObject *)self, "iterator")) {
+        be->iterator = PyObject_GetAttrString((PyObject *)self, "iterator");
+        be->backend.iterator = pygit2_refdb_backend_iterator;
+    } else if (PyIter_Check((PyObject *)self)) {
         be->backend.iterator = pygit2_refdb_backend_iterator;
     }
 
@@ -588,6 +625,7 @@ RefdbBackend_init(RefdbBackend *self, PyObject *args, PyObject *kwds)
 
     Py_INCREF((PyObject *)self);
     be->backend.free = pygit2_refdb_backend_free;
+    python_backends++;
 
     self->refdb_backend = (git_refdb_backend *)be;
     return 0;
@@ -614,6 +652,7 @@ RefdbBackend_dealloc(RefdbBackend *self)
         Py_CLEAR(be->lock);
         Py_CLEAR(be->unlock);
         free(be);
+        python_backends--;
     }
     Py_TYPE(self)->tp_free((PyObject *) self);
 }
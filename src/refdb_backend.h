@@ -34,5 +34,7 @@
 #include "types.h"
 
 PyObject *wrap_refdb_backend(git_refdb_backend *c_refdb_backend);
+int refdb_allows_threads(void);
+int refdb_backend_is_python(git_refdb_backend *backend);
 
 #endif
@@ -0,0 +1,1200 @@
+/*
+ * Copyright 2010-2026 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <git2.h>
+#include <git2/sys/errors.h>
+#include <git2/sys/refdb_backend.h>
+#include <git2/sys/refs.h>
+#include "error.h"
+#include "oid.h"
+#include "refdb_backend.h"
+#include "refdb_memory.h"
+#include "types.h"
+#include "utils.h"
+#include "wildmatch.h"
+
+extern PyTypeObject RefdbBackendType;
+extern PyTypeObject RefdbMemoryBackendType;
+extern PyTypeObject RefLogEntryType;
+
+/*
+ * The references are kept in a chained hash table, and sorted by name when
+ * iterated. Every call takes the lock of the backend, which is a plain
+ * native lock, so libgit2 may call the backend without the GIL.
+ *
+ * With a base backend, the references not written in memory are read from
+ * it, and the ones deleted in memory are kept as tombstones to hide them.
+ * The base is never written to.
+ */
+
+#define REFDB_MEMORY_MIN_BUCKETS 64
+
+enum {
+    REFDB_MEMORY_NONE,          /* Only a lock or a log, see the base */
+    REFDB_MEMORY_SET,
+    REFDB_MEMORY_DELETED,       /* Hides the reference of the base */
+};
+
+typedef struct {
+    git_oid old;
+    git_oid new;
+    git_signature *committer;
+    char *message;
+} refdb_memory_log_entry;
+
+typedef struct refdb_memory_ref refdb_memory_ref;
+
+struct refdb_memory_ref {
+    char *name;
+    int state;
+    git_reference_t type;
+    git_oid target;
+    char *symbolic;
+    int locked;
+    int has_log;
+    refdb_memory_log_entry *log;    /* Oldest first */
+    size_t log_count;
+    size_t log_alloc;
+    refdb_memory_ref *next;         /* In the bucket */
+};
+
+typedef struct {
+    git_refdb_backend parent;
+    PyThread_type_lock lock;
+    git_refdb_backend *base;        /* Owned, may be NULL */
+    refdb_memory_ref **buckets;
+    size_t mask;
+    size_t size;
+    int reflog;
+    long refcount;                  /* The Python object, and every refdb */
+} refdb_memory;
+
+typedef struct {
+    git_reference_iterator parent;
+    git_reference **refs;
+    size_t count;
+    size_t pos;
+    git_reference *current;         /* Keeps the name of next_name alive */
+} refdb_memory_iterator;
+
+
+/*
+ * Table
+ */
+
+static size_t
+refdb_memory_hash(const char *name)
+{
+    size_t hash = 2166136261u;
+
+    for (; *name; name++)
+        hash = (hash ^ (unsigned char)*name) * 16777619u;
+    return hash;
+}
+
+static refdb_memory_ref *
+refdb_memory_find(refdb_memory *db, const char *name)
+{
+    refdb_memory_ref *ref = db->buckets[refdb_memory_hash(name) & db->mask];
+
+    while (ref && strcmp(ref->name, name) != 0)
+        ref = ref->next;
+    return ref;
+}
+
+static int
+refdb_memory_grow(refdb_memory *db)
+{
+    size_t i, nbuckets = (db->mask + 1) * 2;
+    refdb_memory_ref **buckets, *ref, *next;
+
+    buckets = calloc(nbuckets, sizeof(refdb_memory_ref *));
+    if (buckets == NULL)
+        return -1;
+
+    for (i = 0; i <= db->mask; i++) {
+        for (ref = db->buckets[i]; ref; ref = next) {
+            next = ref->next;
+            ref->next = buckets[refdb_memory_hash(ref->name) & (nbuckets - 1)];
+            buckets[refdb_memory_hash(ref->name) & (nbuckets - 1)] = ref;
+        }
+    }
+
+    free(db->buckets);
+    db->buckets = buckets;
+    db->mask = nbuckets - 1;
+    return 0;
+}
+
+/* Find the entry, or add an empty one; returns NULL on out of memory */
+static refdb_memory_ref *
+refdb_memory_get(refdb_memory *db, const char *name)
+{
+    refdb_memory_ref *ref = refdb_memory_find(db, name);
+    size_t bucket;
+
+    if (ref)
+        return ref;
+
+    if (db->size > db->mask && refdb_memory_grow(db) < 0)
+        goto nomem;
+
+    ref = calloc(1, sizeof(refdb_memory_ref));
+    if (ref == NULL)
+        goto nomem;
+    if ((ref->name = strdup(name)) == NULL) {
+        free(ref);
+        goto nomem;
+    }
+
+    bucket = refdb_memory_hash(name) & db->mask;
+    ref->next = db->buckets[bucket];
+    db->buckets[bucket] = ref;
+    db->size++;
+    return ref;
+
+nomem:
+    git_error_set_oom();
+    return NULL;
+}
+
+static void
+refdb_memory_clear_log(refdb_memory_ref *ref)
+{
+    size_t i;
+
+    for (i = 0; i < ref->log_count; i++) {
+        git_signature_free(ref->log[i].committer);
+        free(ref->log[i].message);
+    }
+    free(ref->log);
+    ref->log = NULL;
+    ref->log_count = 0;
+    ref->log_alloc = 0;
+    ref->has_log = 0;
+}
+
+static void
+refdb_memory_free_ref(refdb_memory_ref *ref)
+{
+    refdb_memory_clear_log(ref);
+    free(ref->symbolic);
+    free(ref->name);
+    free(ref);
+}
+
+/* Drop the entry if it holds nothing anymore */
+static void
+refdb_memory_trim(refdb_memory *db, refdb_memory_ref *ref)
+{
+    refdb_memory_ref **link;
+
+    if (ref->state != REFDB_MEMORY_NONE || ref->locked || ref->has_log)
+        return;
+
+    link = &db->buckets[refdb_memory_hash(ref->name) & db->mask];
+    while (*link != ref)
+        link = &(*link)->next;
+    *link = ref->next;
+    db->size--;
+    refdb_memory_free_ref(ref);
+}
+
+/* Set the value of the entry to the one of the reference */
+static int
+refdb_memory_set(refdb_memory_ref *ref, const git_reference *value)
+{
+    char *symbolic = NULL;
+
+    if (git_reference_type(value) == GIT_REFERENCE_SYMBOLIC) {
+        if ((symbolic = strdup(git_reference_symbolic_target(value))) == NULL) {
+            git_error_set_oom();
+            return -1;
+        }
+        memset(&ref->target, 0, sizeof(ref->target));
+    } else {
+        git_oid_cpy(&ref->target, git_reference_target(value));
+    }
+
+    free(ref->symbolic);
+    ref->symbolic = symbolic;
+    ref->type = git_reference_type(value);
+    ref->state = REFDB_MEMORY_SET;
+    return 0;
+}
+
+static git_reference *
+refdb_memory_to_reference(const refdb_memory_ref *ref, const char *name)
+{
+    git_reference *out;
+
+    if (ref->type == GIT_REFERENCE_SYMBOLIC)
+        out = git_reference__alloc_symbolic(name, ref->symbolic);
+    else
+        out = git_reference__alloc(name, &ref->target, NULL);
+    if (out == NULL)
+        git_error_set_oom();
+    return out;
+}
+
+/* Read the reference, from memory or the base. With the lock held. */
+static int
+refdb_memory_read(git_reference **out, refdb_memory *db, const char *name)
+{
+    refdb_memory_ref *ref = refdb_memory_find(db, name);
+
+    if (ref && ref->state == REFDB_MEMORY_SET) {
+        *out = refdb_memory_to_reference(ref, name);
+        return *out ? 0 : GIT_ERROR;
+    }
+
+    if (db->base && !(ref && ref->state == REFDB_MEMORY_DELETED))
+        return db->base->lookup(out, db->base, name);
+
+    git_error_set(GIT_ERROR_REFERENCE, "reference '%s' not found", name);
+    return GIT_ENOTFOUND;
+}
+
+static int
+refdb_memory_in_base(refdb_memory *db, const char *name)
+{
+    int exists = 0;
+
+    if (db->base && db->base->exists(&exists, db->base, name) < 0) {
+        git_error_clear();
+        return 1;   /* Hide it anyway */
+    }
+    return exists;
+}
+
+/* Like the files backend, compare the reference to its expected value */
+static int
+refdb_memory_check_old(refdb_memory *db, const char *name,
+                       const git_oid *old_id, const char *old_target)
+{
+    git_reference *ref;
+    int err, cmp = 0;
+
+    if (!old_id && !old_target)
+        return 0;
+
+    err = refdb_memory_read(&ref, db, name);
+    if (err == GIT_ENOTFOUND && old_id && git_oid_is_zero(old_id)) {
+        git_error_clear();
+        return 0;
+    }
+    if (err < 0)
+        return err;
+
+    if (old_id)
+        cmp = git_reference_type(ref) != GIT_REFERENCE_DIRECT ||
+              !git_oid_equal(old_id, git_reference_target(ref));
+    if (old_target && !cmp)
+        cmp = git_reference_type(ref) != GIT_REFERENCE_SYMBOLIC ||
+              strcmp(old_target, git_reference_symbolic_target(ref)) != 0;
+    git_reference_free(ref);
+
+    if (cmp) {
+        git_error_set(GIT_ERROR_REFERENCE, "old reference value does not match");
+        return GIT_EMODIFIED;
+    }
+    return 0;
+}
+
+/* The id the reference points to, following one symbolic link */
+static void
+refdb_memory_log_id(git_oid *out, refdb_memory *db, const git_reference *ref)
+{
+    git_reference *target;
+
+    memset(out, 0, sizeof(*out));
+    if (ref == NULL)
+        return;
+
+    if (git_reference_type(ref) == GIT_REFERENCE_DIRECT) {
+        git_oid_cpy(out, git_reference_target(ref));
+    } else if (refdb_memory_read(&target, db, git_reference_symbolic_target(ref)) == 0) {
+        if (git_reference_type(target) == GIT_REFERENCE_DIRECT)
+            git_oid_cpy(out, git_reference_target(target));
+        git_reference_free(target);
+    } else {
+        git_error_clear();
+    }
+}
+
+static int
+refdb_memory_append_log(refdb_memory_ref *ref, const git_oid *old, const git_oid *new,
+                        const git_signature *who, const char *message)
+{
+    refdb_memory_log_entry *entry;
+
+    if (ref->log_count == ref->log_alloc) {
+        size_t alloc = ref->log_alloc ? ref->log_alloc * 2 : 4;
+        entry = realloc(ref->log, alloc * sizeof(refdb_memory_log_entry));
+        if (entry == NULL)
+            goto nomem;
+        ref->log = entry;
+        ref->log_alloc = alloc;
+    }
+
+    entry = &ref->log[ref->log_count];
+    git_oid_cpy(&entry->old, old);
+    git_oid_cpy(&entry->new, new);
+    entry->message = NULL;
+    if (message && (entry->message = strdup(message)) == NULL)
+        goto nomem;
+    if (git_signature_dup(&entry->committer, who) < 0) {
+        free(entry->message);
+        return GIT_ERROR;
+    }
+
+    ref->log_count++;
+    ref->has_log = 1;
+    return 0;
+
+nomem:
+    git_error_set_oom();
+    return GIT_ERROR;
+}
+
+/* Write the reference, with the lock held and the checks done */
+static int
+refdb_memory_write_unlocked(refdb_memory *db, refdb_memory_ref *entry,
+                            const git_reference *ref, int update_reflog,
+                            const git_signature *who, const char *message)
+{
+    git_reference *current = NULL;
+    git_oid old, new;
+    int err;
+
+    if (db->reflog && update_reflog && who) {
+        err = refdb_memory_read(&current, db, entry->name);
+        if (err < 0 && err != GIT_ENOTFOUND)
+            return err;
+        git_error_clear();
+        refdb_memory_log_id(&old, db, current);
+        refdb_memory_log_id(&new, db, ref);
+        git_reference_free(current);
+        if ((err = refdb_memory_append_log(entry, &old, &new, who, message)) < 0)
+            return err;
+    }
+
+    return refdb_memory_set(entry, ref);
+}
+
+/* Delete the reference, with the lock held and the checks done */
+static void
+refdb_memory_delete_unlocked(refdb_memory *db, refdb_memory_ref *entry)
+{
+    free(entry->symbolic);
+    entry->symbolic = NULL;
+    refdb_memory_clear_log(entry);
+    entry->state = refdb_memory_in_base(db, entry->name)
+                 ? REFDB_MEMORY_DELETED : REFDB_MEMORY_NONE;
+    refdb_memory_trim(db, entry);
+}
+
+static int
+refdb_memory_exists_unlocked(refdb_memory *db, const char *name)
+{
+    refdb_memory_ref *ref = refdb_memory_find(db, name);
+
+    if (ref && ref->state != REFDB_MEMORY_NONE)
+        return ref->state == REFDB_MEMORY_SET;
+    return refdb_memory_in_base(db, name);
+}
+
+static int
+refdb_memory_check_unlocked(refdb_memory_ref *ref)
+{
+    if (ref && ref->locked) {
+        git_error_set(GIT_ERROR_REFERENCE, "reference '%s' is locked", ref->name);
+        return GIT_ELOCKED;
+    }
+    return 0;
+}
+
+static void
+refdb_memory_release(refdb_memory *db)
+{
+    refdb_memory_ref *ref, *next;
+    size_t i;
+    long refcount;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    refcount = --db->refcount;
+    PyThread_release_lock(db->lock);
+    if (refcount > 0)
+        return;
+
+    for (i = 0; i <= db->mask; i++) {
+        for (ref = db->buckets[i]; ref; ref = next) {
+            next = ref->next;
+            refdb_memory_free_ref(ref);
+        }
+    }
+    if (db->base)
+        db->base->free(db->base);
+    free(db->buckets);
+    PyThread_free_lock(db->lock);
+    free(db);
+}
+
+
+/*
+ * Iterator
+ */
+
+static int
+refdb_memory_iterator_next(git_reference **out, git_reference_iterator *_iter)
+{
+    refdb_memory_iterator *iter = (refdb_memory_iterator *)_iter;
+
+    if (iter->pos == iter->count)
+        return GIT_ITEROVER;
+
+    *out = iter->refs[iter->pos];
+    iter->refs[iter->pos++] = NULL;
+    return 0;
+}
+
+static int
+refdb_memory_iterator_next_name(const char **out, git_reference_iterator *_iter)
+{
+    refdb_memory_iterator *iter = (refdb_memory_iterator *)_iter;
+
+    if (iter->pos == iter->count)
+        return GIT_ITEROVER;
+
+    git_reference_free(iter->current);
+    iter->current = iter->refs[iter->pos];
+    iter->refs[iter->pos++] = NULL;
+    *out = git_reference_name(iter->current);
+    return 0;
+}
+
+static void
+refdb_memory_iterator_free(git_reference_iterator *_iter)
+{
+    refdb_memory_iterator *iter = (refdb_memory_iterator *)_iter;
+    size_t i;
+
+    for (i = iter->pos; i < iter->count; i++)
+        git_reference_free(iter->refs[i]);
+    git_reference_free(iter->current);
+    free(iter->refs);
+    free(iter);
+}
+
+static int
+refdb_memory_iterator_add(refdb_memory_iterator *iter, size_t *alloc, git_reference *ref)
+{
+    git_reference **refs;
+
+    if (iter->count == *alloc) {
+        *alloc = *alloc ? *alloc * 2 : 64;
+        refs = realloc(iter->refs, *alloc * sizeof(git_reference *));
+        if (refs == NULL) {
+            git_reference_free(ref);
+            git_error_set_oom();
+            return GIT_ERROR;
+        }
+        iter->refs = refs;
+    }
+
+    iter->refs[iter->count++] = ref;
+    return 0;
+}
+
+static int
+refdb_memory_reference_cmp(const void *a, const void *b)
+{
+    return strcmp(git_reference_name(*(git_reference * const *)a),
+                  git_reference_name(*(git_reference * const *)b));
+}
+
+/* Read the matching references of the base, unless known in memory */
+static int
+refdb_memory_iterator_add_base(refdb_memory_iterator *iter, size_t *alloc,
+                               refdb_memory *db, const char *glob)
+{
+    git_reference_iterator *base_iter;
+    git_reference *ref;
+    refdb_memory_ref *entry;
+    int err;
+
+    if ((err = db->base->iterator(&base_iter, db->base, glob)) < 0)
+        return err;
+
+    while ((err = base_iter->next(&ref, base_iter)) == 0) {
+        entry = refdb_memory_find(db, git_reference_name(ref));
+        if (entry && entry->state != REFDB_MEMORY_NONE) {
+            git_reference_free(ref);
+            continue;
+        }
+        if ((err = refdb_memory_iterator_add(iter, alloc, ref)) < 0)
+            break;
+    }
+
+    /* Not a refdb iterator: it is freed with its own callback */
+    base_iter->free(base_iter);
+    return err == GIT_ITEROVER ? 0 : err;
+}
+
+static int
+refdb_memory_iterator_new(git_reference_iterator **out, git_refdb_backend *backend,
+                      const char *glob)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_iterator *iter;
+    refdb_memory_ref *entry;
+    git_reference *ref;
+    size_t i, alloc = 0;
+    int err = 0;
+
+    iter = calloc(1, sizeof(refdb_memory_iterator));
+    if (iter == NULL) {
+        git_error_set_oom();
+        return GIT_ERROR;
+    }
+    iter->parent.next = refdb_memory_iterator_next;
+    iter->parent.next_name = refdb_memory_iterator_next_name;
+    iter->parent.free = refdb_memory_iterator_free;
+
+    /* A snapshot, so the references may be changed while iterating */
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    for (i = 0; i <= db->mask && err == 0; i++) {
+        for (entry = db->buckets[i]; entry && err == 0; entry = entry->next) {
+            if (entry->state != REFDB_MEMORY_SET ||
+                (glob && wildmatch(glob, entry->name, 0) == WM_NOMATCH))
+                continue;
+            if ((ref = refdb_memory_to_reference(entry, entry->name)) == NULL)
+                err = GIT_ERROR;
+            else
+                err = refdb_memory_iterator_add(iter, &alloc, ref);
+        }
+    }
+    if (err == 0 && db->base)
+        err = refdb_memory_iterator_add_base(iter, &alloc, db, glob);
+    PyThread_release_lock(db->lock);
+
+    if (err < 0) {
+        refdb_memory_iterator_free((git_reference_iterator *)iter);
+        return err;
+    }
+
+    qsort(iter->refs, iter->count, sizeof(git_reference *), refdb_memory_reference_cmp);
+    *out = (git_reference_iterator *)iter;
+    return 0;
+}
+
+
+/*
+ * Backend
+ */
+
+static int
+refdb_memory_exists(int *exists, git_refdb_backend *backend, const char *name)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    *exists = refdb_memory_exists_unlocked(db, name);
+    PyThread_release_lock(db->lock);
+    return 0;
+}
+
+static int
+refdb_memory_lookup(git_reference **out, git_refdb_backend *backend, const char *name)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    int err;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    err = refdb_memory_read(out, db, name);
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+refdb_memory_write(git_refdb_backend *backend, const git_reference *ref, int force,
+                   const git_signature *who, const char *message,
+                   const git_oid *old, const char *old_target)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    const char *name = git_reference_name(ref);
+    refdb_memory_ref *entry;
+    int err;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    entry = refdb_memory_find(db, name);
+    if ((err = refdb_memory_check_unlocked(entry)) < 0)
+        goto exit;
+
+    if (!force && refdb_memory_exists_unlocked(db, name)) {
+        git_error_set(GIT_ERROR_REFERENCE,
+                      "failed to write reference '%s': a reference with "
+                      "that name already exists.", name);
+        err = GIT_EEXISTS;
+        goto exit;
+    }
+    if ((err = refdb_memory_check_old(db, name, old, old_target)) < 0)
+        goto exit;
+
+    if ((entry = refdb_memory_get(db, name)) == NULL) {
+        err = GIT_ERROR;
+        goto exit;
+    }
+    err = refdb_memory_write_unlocked(db, entry, ref, 1, who, message);
+    refdb_memory_trim(db, entry);
+
+exit:
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+refdb_memory_rename(git_reference **out, git_refdb_backend *backend,
+                    const char *old_name, const char *new_name, int force,
+                    const git_signature *who, const char *message)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_ref *old_entry, *new_entry;
+    git_reference *ref = NULL, *renamed = NULL;
+    int err;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    if ((err = refdb_memory_check_unlocked(refdb_memory_find(db, old_name))) < 0 ||
+        (err = refdb_memory_check_unlocked(refdb_memory_find(db, new_name))) < 0)
+        goto exit;
+
+    if ((err = refdb_memory_read(&ref, db, old_name)) < 0)
+        goto exit;
+
+    if (!force && refdb_memory_exists_unlocked(db, new_name)) {
+        git_error_set(GIT_ERROR_REFERENCE,
+                      "failed to write reference '%s': a reference with "
+                      "that name already exists.", new_name);
+        err = GIT_EEXISTS;
+        goto exit;
+    }
+
+    if (git_reference_type(ref) == GIT_REFERENCE_SYMBOLIC)
+        renamed = git_reference__alloc_symbolic(new_name, git_reference_symbolic_target(ref));
+    else
+        renamed = git_reference__alloc(new_name, git_reference_target(ref), NULL);
+    if (renamed == NULL ||
+        (new_entry = refdb_memory_get(db, new_name)) == NULL ||
+        (old_entry = refdb_memory_get(db, old_name)) == NULL) {
+        git_error_set_oom();
+        err = GIT_ERROR;
+        goto exit;
+    }
+
+    /* The log goes with the reference, like in the files backend */
+    refdb_memory_clear_log(new_entry);
+    new_entry->log = old_entry->log;
+    new_entry->log_count = old_entry->log_count;
+    new_entry->log_alloc = old_entry->log_alloc;
+    new_entry->has_log = old_entry->has_log;
+    old_entry->log = NULL;
+    old_entry->log_count = old_entry->log_alloc = 0;
+    old_entry->has_log = 0;
+
+    if ((err = refdb_memory_write_unlocked(db, new_entry, renamed, 1, who, message)) < 0) {
+        refdb_memory_trim(db, new_entry);
+        goto exit;
+    }
+    refdb_memory_delete_unlocked(db, old_entry);
+
+    *out = renamed;
+    renamed = NULL;
+
+exit:
+    PyThread_release_lock(db->lock);
+    git_reference_free(ref);
+    git_reference_free(renamed);
+    return err;
+}
+
+static int
+refdb_memory_del(git_refdb_backend *backend, const char *name,
+                 const git_oid *old_id, const char *old_target)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_ref *entry;
+    int err;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    entry = refdb_memory_find(db, name);
+    if ((err = refdb_memory_check_unlocked(entry)) < 0 ||
+        (err = refdb_memory_check_old(db, name, old_id, old_target)) < 0)
+        goto exit;
+
+    if (!refdb_memory_exists_unlocked(db, name)) {
+        git_error_set(GIT_ERROR_REFERENCE, "reference '%s' not found", name);
+        err = GIT_ENOTFOUND;
+        goto exit;
+    }
+
+    if ((entry = refdb_memory_get(db, name)) == NULL) {
+        err = GIT_ERROR;
+        goto exit;
+    }
+    refdb_memory_delete_unlocked(db, entry);
+
+exit:
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+refdb_memory_compress(git_refdb_backend *backend)
+{
+    return 0;
+}
+
+static int
+refdb_memory_has_log(git_refdb_backend *backend, const char *name)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_ref *entry;
+    int has_log;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    entry = refdb_memory_find(db, name);
+    has_log = entry && entry->has_log;
+    PyThread_release_lock(db->lock);
+    return has_log;
+}
+
+static int
+refdb_memory_ensure_log(git_refdb_backend *backend, const char *name)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_ref *entry;
+    int err = 0;
+
+    if (!db->reflog)
+        return 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    if ((entry = refdb_memory_get(db, name)) == NULL)
+        err = GIT_ERROR;
+    else
+        entry->has_log = 1;
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+refdb_memory_reflog_read(git_reflog **out, git_refdb_backend *backend, const char *name)
+{
+    /* libgit2 has no public constructor of git_reflog */
+    git_error_set(GIT_ERROR_REFERENCE,
+                  "the logs of an in-memory reference database are read with "
+                  "RefdbMemoryBackend.reflog()");
+    return GIT_ERROR;
+}
+
+static int
+refdb_memory_reflog_write(git_refdb_backend *backend, git_reflog *reflog)
+{
+    git_error_set(GIT_ERROR_REFERENCE,
+                  "the logs of an in-memory reference database cannot be written");
+    return GIT_ERROR;
+}
+
+static int
+refdb_memory_reflog_rename(git_refdb_backend *backend, const char *old_name,
+                           const char *new_name)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_ref *old_entry, *new_entry;
+    int err = 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    old_entry = refdb_memory_find(db, old_name);
+    if (old_entry == NULL || !old_entry->has_log)
+        goto exit;
+
+    if ((new_entry = refdb_memory_get(db, new_name)) == NULL) {
+        err = GIT_ERROR;
+        goto exit;
+    }
+
+    refdb_memory_clear_log(new_entry);
+    new_entry->log = old_entry->log;
+    new_entry->log_count = old_entry->log_count;
+    new_entry->log_alloc = old_entry->log_alloc;
+    new_entry->has_log = 1;
+    old_entry->log = NULL;
+    old_entry->log_count = old_entry->log_alloc = 0;
+    old_entry->has_log = 0;
+    refdb_memory_trim(db, old_entry);
+
+exit:
+    PyThread_release_lock(db->lock);
+    return err;
+}
+
+static int
+refdb_memory_reflog_delete(git_refdb_backend *backend, const char *name)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_ref *entry;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    if ((entry = refdb_memory_find(db, name)) != NULL) {
+        refdb_memory_clear_log(entry);
+        refdb_memory_trim(db, entry);
+    }
+    PyThread_release_lock(db->lock);
+    return 0;
+}
+
+/* Transactions: the payload is the name of the locked reference */
+static int
+refdb_memory_lock(void **payload, git_refdb_backend *backend, const char *name)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_ref *entry;
+    char *locked;
+    int err;
+
+    if ((locked = strdup(name)) == NULL) {
+        git_error_set_oom();
+        return GIT_ERROR;
+    }
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    entry = refdb_memory_get(db, name);
+    if (entry == NULL)
+        err = GIT_ERROR;
+    else if ((err = refdb_memory_check_unlocked(entry)) == 0)
+        entry->locked = 1;
+    PyThread_release_lock(db->lock);
+
+    if (err < 0) {
+        free(locked);
+        return err;
+    }
+    *payload = locked;
+    return 0;
+}
+
+static int
+refdb_memory_unlock(git_refdb_backend *backend, void *payload, int success,
+                    int update_reflog, const git_reference *ref,
+                    const git_signature *sig, const char *message)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+    refdb_memory_ref *entry;
+    char *name = payload;
+    int err = 0;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    entry = refdb_memory_find(db, name);
+    if (entry) {
+        entry->locked = 0;
+        if (success == 2)
+            refdb_memory_delete_unlocked(db, entry);
+        else if (success)
+            err = refdb_memory_write_unlocked(db, entry, ref, update_reflog, sig, message);
+        if (success != 2)
+            refdb_memory_trim(db, entry);
+    }
+    PyThread_release_lock(db->lock);
+
+    free(name);
+    return err;
+}
+
+static void
+refdb_memory_free(git_refdb_backend *backend)
+{
+    refdb_memory_release((refdb_memory *)backend);
+}
+
+static int
+refdb_memory_is(git_refdb_backend *backend)
+{
+    return backend->free == refdb_memory_free;
+}
+
+/* A refdb is given the backend, see Refdb.set_backend */
+void
+refdb_memory_retain(git_refdb_backend *backend)
+{
+    refdb_memory *db = (refdb_memory *)backend;
+
+    if (!refdb_memory_is(backend))
+        return;
+
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    db->refcount++;
+    PyThread_release_lock(db->lock);
+}
+
+
+/*
+ * RefdbMemoryBackend
+ */
+
+PyDoc_STRVAR(RefdbMemoryBackend_reflog__doc__,
+  "reflog(name: str) -> list[RefLogEntry]\n"
+  "\n"
+  "The log of the reference, newest entry first. Only written when the\n"
+  "backend was created with reflog=True.");
+
+PyObject *
+RefdbMemoryBackend_reflog(RefdbMemoryBackend *self, PyObject *py_name)
+{
+    refdb_memory *db = (refdb_memory *)self->super.refdb_backend;
+    refdb_memory_ref *entry;
+    refdb_memory_log_entry *log = NULL;
+    RefLogEntry *py_entry;
+    PyObject *list = NULL;
+    const char *name;
+    size_t i, count = 0;
+    int err = 0;
+
+    if (db == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "RefdbMemoryBackend is not initialized");
+        return NULL;
+    }
+
+    if ((name = PyUnicode_AsUTF8(py_name)) == NULL)
+        return NULL;
+
+    /*
+     * Copy the log, as Python may free a repository using the backend, and
+     * so take the lock, while building the entries.
+     */
+    PyThread_acquire_lock(db->lock, WAIT_LOCK);
+    entry = refdb_memory_find(db, name);
+    if (entry && entry->log_count) {
+        log = calloc(entry->log_count, sizeof(refdb_memory_log_entry));
+        for (; log && count < entry->log_count && err == 0; count++) {
+            log[count] = entry->log[count];
+            log[count].committer = NULL;
+            if (entry->log[count].message &&
+                (log[count].message = strdup(entry->log[count].message)) == NULL)
+                err = -1;
+            else
+                err = git_signature_dup(&log[count].committer, entry->log[count].committer);
+        }
+        if (log == NULL)
+            err = -1;
+    }
+    PyThread_release_lock(db->lock);
+
+    if (err < 0) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+
+    if ((list = PyList_New(count)) == NULL)
+        goto exit;
+
+    for (i = 0; i < count; i++) {
+        py_entry = PyObject_New(RefLogEntry, &RefLogEntryType);
+        if (py_entry == NULL)
+            goto error;
+
+        /* Newest first, like Reference.log() */
+        PyList_SET_ITEM(list, count - i - 1, (PyObject *)py_entry);
+        py_entry->oid_old = git_oid_to_python(&log[i].old);
+        py_entry->oid_new = git_oid_to_python(&log[i].new);
+        py_entry->message = log[i].message;
+        py_entry->signature = log[i].committer;
+        log[i].message = NULL;
+        log[i].committer = NULL;
+        if (py_entry->oid_old == NULL || py_entry->oid_new == NULL)
+            goto error;
+    }
+    goto exit;
+
+error:
+    Py_CLEAR(list);
+exit:
+    for (i = 0; i < count; i++) {
+        free(log[i].message);
+        git_signature_free(log[i].committer);
+    }
+    free(log);
+    return list;
+}
+
+int
+RefdbMemoryBackend_init(RefdbMemoryBackend *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"base", "reflog", NULL};
+    PyObject *py_base = Py_None;
+    git_refdb_backend *base = NULL;
+    refdb_memory *db;
+    int reflog = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Op", keywords, &py_base, &reflog))
+        return -1;
+
+    if (self->super.refdb_backend) {
+        PyErr_SetString(PyExc_RuntimeError, "RefdbMemoryBackend is already initialized");
+        return -1;
+    }
+
+    if (py_base != Py_None) {
+        if (!PyObject_TypeCheck(py_base, &RefdbBackendType) ||
+            (base = ((RefdbBackend *)py_base)->refdb_backend) == NULL) {
+            PyErr_SetString(PyExc_TypeError, "base must be a RefdbBackend");
+            return -1;
+        }
+        /* It would be called without the GIL */
+        if (refdb_backend_is_python(base)) {
+            PyErr_SetString(PyExc_TypeError,
+                            "base must not be implemented in Python");
+            return -1;
+        }
+    }
+
+    db = calloc(1, sizeof(refdb_memory));
+    if (db == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    db->lock = PyThread_allocate_lock();
+    db->buckets = calloc(REFDB_MEMORY_MIN_BUCKETS, sizeof(refdb_memory_ref *));
+    if (db->lock == NULL || db->buckets == NULL) {
+        if (db->lock)
+            PyThread_free_lock(db->lock);
+        free(db->buckets);
+        free(db);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    git_refdb_init_backend(&db->parent, GIT_REFDB_BACKEND_VERSION);
+    db->parent.exists = refdb_memory_exists;
+    db->parent.lookup = refdb_memory_lookup;
+    db->parent.iterator = refdb_memory_iterator_new;
+    db->parent.write = refdb_memory_write;
+    db->parent.rename = refdb_memory_rename;
+    db->parent.del = refdb_memory_del;
+    db->parent.compress = refdb_memory_compress;
+    db->parent.has_log = refdb_memory_has_log;
+    db->parent.ensure_log = refdb_memory_ensure_log;
+    db->parent.free = refdb_memory_free;
+    db->parent.reflog_read = refdb_memory_reflog_read;
+    db->parent.reflog_write = refdb_memory_reflog_write;
+    db->parent.reflog_rename = refdb_memory_reflog_rename;
+    db->parent.reflog_delete = refdb_memory_reflog_delete;
+    db->parent.lock = refdb_memory_lock;
+    db->parent.unlock = refdb_memory_unlock;
+
+    /*
+     * The base is owned from now on, as when given to Refdb.set_backend; a
+     * memory backend is shared instead.
+     */
+    if (base)
+        refdb_memory_retain(base);
+    db->base = base;
+    db->mask = REFDB_MEMORY_MIN_BUCKETS - 1;
+    db->reflog = reflog;
+    db->refcount = 1;
+
+    self->super.refdb_backend = &db->parent;
+    return 0;
+}
+
+void
+RefdbMemoryBackend_dealloc(RefdbMemoryBackend *self)
+{
+    if (self->super.refdb_backend)
+        refdb_memory_release((refdb_memory *)self->super.refdb_backend);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyMethodDef RefdbMemoryBackend_methods[] = {
+    METHOD(RefdbMemoryBackend, reflog, METH_O),
+    {NULL}
+};
+
+PyDoc_STRVAR(RefdbMemoryBackend__doc__,
+  "RefdbMemoryBackend(base: RefdbBackend | None = None, reflog: bool = False)\n"
+  "\n"
+  "Reference database kept in memory, for throwaway repositories. Give it\n"
+  "to a repository with Refdb.set_backend().\n"
+  "\n"
+  "With a base backend, e.g. a RefdbFsBackend, the references are read from\n"
+  "it unless written or deleted in memory, and it is never written to. The\n"
+  "base must be implemented in C, and not be used anywhere else.\n"
+  "\n"
+  "With reflog, the reference logs are kept as well, and read with\n"
+  "reflog(); they are not available through Reference.log().");
+
+PyTypeObject RefdbMemoryBackendType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.RefdbMemoryBackend",              /* tp_name           */
+    sizeof(RefdbMemoryBackend),                /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)RefdbMemoryBackend_dealloc,    /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    RefdbMemoryBackend__doc__,                 /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    RefdbMemoryBackend_methods,                /* tp_methods        */
+    0,                                         /* tp_members        */
+    0,                                         /* tp_getset         */
+    &RefdbBackendType,                         /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    (initproc)RefdbMemoryBackend_init,         /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
@@ -0,0 +1,602 @@
+/*
+ * Copyright 2010-2026 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include <git2.h>
+#include "error.h"
+#include "odb.h"
+#include "refdb_backend.h"
+#include "refs_snapshot.h"
+#include "types.h"
+#include "utils.h"
+
+extern PyTypeObject RefsSnapshotType;
+
+/*
+ * Reading
+ *
+ * The references are read without the GIL into a single string buffer,
+ * sorted by name, then written out as columns. Snapshots being sorted, two
+ * of them are compared with a single merge.
+ */
+typedef struct {
+    size_t name_pos;            /* In the strings buffer, NUL terminated */
+    size_t name_len;
+    size_t symbolic_pos;
+    size_t symbolic_len;        /* 0 for direct references */
+    git_oid target;             /* Zero for symbolic references */
+    git_oid peeled;             /* Zero when not peeled, or not peelable */
+    const char *name;           /* Set once the strings are all read */
+} refs_snapshot_entry;
+
+typedef struct {
+    git_repository *repo;
+    const char *prefix;
+    int peel;
+    pgit_buffer strings;
+    refs_snapshot_entry *entries;
+    size_t count;
+    size_t alloc;
+    int err;                    /* A libgit2 error */
+    int nomem;
+} refs_snapshot_read;
+
+/* Peel the reference until it is not a tag */
+static int
+refs_snapshot_peel(git_oid *out, git_reference *ref)
+{
+    git_object *obj, *target;
+    int err;
+
+    err = git_reference_peel(&obj, ref, GIT_OBJECT_ANY);
+    if (err == 0 && git_object_type(obj) == GIT_OBJECT_TAG) {
+        err = git_tag_peel(&target, (git_tag *)obj);
+        git_object_free(obj);
+        obj = target;
+    }
+
+    if (err == GIT_ENOTFOUND || err == GIT_EPEEL) {
+        /* Dangling references, or tags of nothing, are kept unpeeled */
+        git_error_clear();
+        memset(out, 0, sizeof(*out));
+        return 0;
+    }
+    if (err < 0)
+        return err;
+
+    git_oid_cpy(out, git_object_id(obj));
+    git_object_free(obj);
+    return 0;
+}
+
+static int
+refs_snapshot_add(refs_snapshot_read *read, git_reference *ref)
+{
+    refs_snapshot_entry *entry;
+    const char *name = git_reference_name(ref);
+    const char *symbolic;
+
+    if (read->count == read->alloc) {
+        size_t alloc = read->alloc ? read->alloc * 2 : 256;
+        entry = realloc(read->entries, alloc * sizeof(refs_snapshot_entry));
+        if (entry == NULL)
+            goto nomem;
+        read->entries = entry;
+        read->alloc = alloc;
+    }
+
+    entry = &read->entries[read->count];
+    memset(entry, 0, sizeof(*entry));
+    entry->name_pos = read->strings.size;
+    entry->name_len = strlen(name);
+    if (pgit_buffer_append(&read->strings, name, entry->name_len + 1) < 0)
+        goto nomem;
+
+    if (git_reference_type(ref) == GIT_REFERENCE_SYMBOLIC) {
+        symbolic = git_reference_symbolic_target(ref);
+        entry->symbolic_pos = read->strings.size;
+        entry->symbolic_len = strlen(symbolic);
+        if (pgit_buffer_append(&read->strings, symbolic, entry->symbolic_len + 1) < 0)
+            goto nomem;
+    } else {
+        git_oid_cpy(&entry->target, git_reference_target(ref));
+    }
+
+    if (read->peel && (read->err = refs_snapshot_peel(&entry->peeled, ref)) < 0)
+        return -1;
+
+    read->count++;
+    return 0;
+
+nomem:
+    read->nomem = 1;
+    return -1;
+}
+
+static int
+refs_snapshot_entry_cmp(const void *a, const void *b)
+{
+    return strcmp(((const refs_snapshot_entry *)a)->name,
+                  ((const refs_snapshot_entry *)b)->name);
+}
+
+/* Read and sort the references. Does not need the GIL. */
+static void
+refs_snapshot_read_all(refs_snapshot_read *read, const char *glob)
+{
+    git_reference_iterator *iter;
+    git_reference *ref;
+    size_t i, prefix_len = read->prefix ? strlen(read->prefix) : 0;
+    int err;
+
+    if (glob)
+        err = git_reference_iterator_glob_new(&iter, read->repo, glob);
+    else
+        err = git_reference_iterator_new(&iter, read->repo);
+    if (err < 0) {
+        read->err = err;
+        return;
+    }
+
+    while ((err = git_reference_next(&ref, iter)) == 0) {
+        /* The glob is only a hint to the backend, the prefix decides */
+        if (prefix_len == 0 || strncmp(git_reference_name(ref), read->prefix, prefix_len) == 0)
+            err = refs_snapshot_add(read, ref);
+        git_reference_free(ref);
+        if (err < 0)
+            break;
+    }
+    git_reference_iterator_free(iter);
+
+    if (read->nomem || read->err < 0)
+        return;
+    if (err != GIT_ITEROVER) {
+        read->err = err;
+        return;
+    }
+
+    for (i = 0; i < read->count; i++)
+        read->entries[i].name = read->strings.data + read->entries[i].name_pos;
+    qsort(read->entries, read->count, sizeof(refs_snapshot_entry), refs_snapshot_entry_cmp);
+}
+
+/* The glob to read the references starting with prefix, escaped */
+static char *
+refs_snapshot_glob(const char *prefix)
+{
+    size_t i, j;
+    char *glob = PyMem_Malloc(strlen(prefix) * 2 + 2);
+
+    if (glob == NULL)
+        return NULL;
+
+    for (i = 0, j = 0; prefix[i]; i++) {
+        if (strchr("*?[\\", prefix[i]))
+            glob[j++] = '\\';
+        glob[j++] = prefix[i];
+    }
+    glob[j++] = '*';
+    glob[j] = '\0';
+    return glob;
+}
+
+static int
+refs_snapshot_append_int64(pgit_buffer *buf, int64_t value)
+{
+    return pgit_buffer_append(buf, &value, sizeof(value));
+}
+
+enum {
+    RS_NAMES,
+    RS_NAME_OFFSETS,
+    RS_TARGETS,
+    RS_SYMBOLIC,
+    RS_SYMBOLIC_OFFSETS,
+    RS_PEELED
+};
+
+#define RS_NCOLUMNS REFS_SNAPSHOT_NCOLUMNS
+
+static const char *refs_snapshot_formats[RS_NCOLUMNS] = {"B", "q", "B", "B", "q", "B"};
+
+/* Write the sorted references as columns. Does not need the GIL. */
+static int
+refs_snapshot_columns(pgit_buffer *cols, const refs_snapshot_read *read)
+{
+    const refs_snapshot_entry *entry;
+    size_t i;
+
+    if (refs_snapshot_append_int64(&cols[RS_NAME_OFFSETS], 0) < 0 ||
+        refs_snapshot_append_int64(&cols[RS_SYMBOLIC_OFFSETS], 0) < 0)
+        return -1;
+
+    for (i = 0; i < read->count; i++) {
+        entry = &read->entries[i];
+        if (pgit_buffer_append(&cols[RS_NAMES], entry->name, entry->name_len) < 0 ||
+            refs_snapshot_append_int64(&cols[RS_NAME_OFFSETS], (int64_t)cols[RS_NAMES].size) < 0 ||
+            pgit_buffer_append(&cols[RS_TARGETS], entry->target.id, GIT_OID_RAWSZ) < 0 ||
+            pgit_buffer_append(&cols[RS_SYMBOLIC], read->strings.data + entry->symbolic_pos,
+                               entry->symbolic_len) < 0 ||
+            refs_snapshot_append_int64(&cols[RS_SYMBOLIC_OFFSETS], (int64_t)cols[RS_SYMBOLIC].size) < 0)
+            return -1;
+        if (read->peel &&
+            pgit_buffer_append(&cols[RS_PEELED], entry->peeled.id, GIT_OID_RAWSZ) < 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+PyObject *
+refs_snapshot_new(Repository *repo, const char *prefix, int peel)
+{
+    refs_snapshot_read read;
+    pgit_buffer cols[RS_NCOLUMNS];
+    RefsSnapshot *snapshot = NULL;
+    PyObject *buffers[RS_NCOLUMNS];
+    PyObject *columns[RS_NCOLUMNS];
+    char *glob = NULL;
+    int i, nomem;
+
+    memset(&read, 0, sizeof(read));
+    memset(cols, 0, sizeof(cols));
+    memset(buffers, 0, sizeof(buffers));
+    memset(columns, 0, sizeof(columns));
+    read.repo = repo->repo;
+    read.prefix = prefix && prefix[0] ? prefix : NULL;
+    read.peel = peel;
+
+    if (read.prefix && (glob = refs_snapshot_glob(read.prefix)) == NULL)
+        return PyErr_NoMemory();
+
+    PGIT_BEGIN_ALLOW_THREADS_IF(refdb_allows_threads() &&
+                                (!peel || repository_odb_allows_threads(repo->repo)))
+    refs_snapshot_read_all(&read, glob);
+    nomem = read.nomem;
+    if (!nomem && read.err == 0)
+        nomem = refs_snapshot_columns(cols, &read) < 0;
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (nomem) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+    if (read.err < 0) {
+        Error_set(read.err);
+        goto exit;
+    }
+
+    for (i = 0; i < RS_NCOLUMNS; i++) {
+        if (i == RS_PEELED && !peel) {
+            columns[i] = Py_NewRef(Py_None);
+            continue;
+        }
+        buffers[i] = pgit_buffer_to_object(&cols[i]);
+        if (buffers[i] == NULL)
+            goto exit;
+        columns[i] = pgit_memoryview_from_object(buffers[i], refs_snapshot_formats[i]);
+        if (columns[i] == NULL)
+            goto exit;
+    }
+
+    snapshot = PyObject_New(RefsSnapshot, &RefsSnapshotType);
+    if (snapshot == NULL)
+        goto exit;
+
+    snapshot->count = (Py_ssize_t)read.count;
+    snapshot->names = columns[RS_NAMES];
+    snapshot->name_offsets = columns[RS_NAME_OFFSETS];
+    snapshot->targets = columns[RS_TARGETS];
+    snapshot->symbolic = columns[RS_SYMBOLIC];
+    snapshot->symbolic_offsets = columns[RS_SYMBOLIC_OFFSETS];
+    snapshot->peeled = columns[RS_PEELED];
+    for (i = 0; i < RS_NCOLUMNS; i++) {
+        snapshot->buffers[i] = buffers[i];
+        snapshot->data[i] = buffers[i] ? PyMemoryView_GET_BUFFER(columns[i])->buf : NULL;
+    }
+    memset(buffers, 0, sizeof(buffers));
+    memset(columns, 0, sizeof(columns));
+
+exit:
+    for (i = 0; i < RS_NCOLUMNS; i++) {
+        Py_XDECREF(buffers[i]);
+        Py_XDECREF(columns[i]);
+        free(cols[i].data);
+    }
+    free(read.strings.data);
+    free(read.entries);
+    PyMem_Free(glob);
+    return (PyObject *)snapshot;
+}
+
+
+/*
+ * RefsSnapshot
+ */
+
+/*
+ * The raw columns of a snapshot, read without the GIL. They are read from
+ * the buffers the snapshot holds, not the memoryviews, which may have been
+ * released.
+ */
+typedef struct {
+    size_t count;
+    const char *names;
+    const int64_t *name_offsets;
+    const unsigned char *targets;
+    const char *symbolic;
+    const int64_t *symbolic_offsets;
+    const unsigned char *peeled;    /* NULL unless peeled */
+} refs_snapshot_view;
+
+static void
+refs_snapshot_view_init(refs_snapshot_view *view, const RefsSnapshot *snapshot)
+{
+    view->count = (size_t)snapshot->count;
+    view->names = snapshot->data[RS_NAMES];
+    view->name_offsets = (const int64_t *)snapshot->data[RS_NAME_OFFSETS];
+    view->targets = (const unsigned char *)snapshot->data[RS_TARGETS];
+    view->symbolic = snapshot->data[RS_SYMBOLIC];
+    view->symbolic_offsets = (const int64_t *)snapshot->data[RS_SYMBOLIC_OFFSETS];
+    view->peeled = (const unsigned char *)snapshot->data[RS_PEELED];
+}
+
+static int
+refs_snapshot_name_cmp(const refs_snapshot_view *a, size_t i,
+                       const refs_snapshot_view *b, size_t j)
+{
+    size_t alen = (size_t)(a->name_offsets[i + 1] - a->name_offsets[i]);
+    size_t blen = (size_t)(b->name_offsets[j + 1] - b->name_offsets[j]);
+    int cmp = memcmp(a->names + a->name_offsets[i], b->names + b->name_offsets[j],
+                     alen < blen ? alen : blen);
+
+    if (cmp)
+        return cmp;
+    return alen < blen ? -1 : alen > blen;
+}
+
+/* Whether reference i of a and reference j of b point to different things */
+static int
+refs_snapshot_changed(const refs_snapshot_view *a, size_t i,
+                      const refs_snapshot_view *b, size_t j)
+{
+    size_t alen = (size_t)(a->symbolic_offsets[i + 1] - a->symbolic_offsets[i]);
+    size_t blen = (size_t)(b->symbolic_offsets[j + 1] - b->symbolic_offsets[j]);
+
+    if (memcmp(a->targets + i * GIT_OID_RAWSZ, b->targets + j * GIT_OID_RAWSZ, GIT_OID_RAWSZ))
+        return 1;
+    if (alen != blen ||
+        memcmp(a->symbolic + a->symbolic_offsets[i], b->symbolic + b->symbolic_offsets[j], alen))
+        return 1;
+    /* When both are peeled, a symbolic reference changes with its target */
+    return a->peeled && b->peeled &&
+           memcmp(a->peeled + i * GIT_OID_RAWSZ, b->peeled + j * GIT_OID_RAWSZ, GIT_OID_RAWSZ);
+}
+
+/* The names of the given references of a snapshot, as a list of str */
+static PyObject *
+refs_snapshot_names(const refs_snapshot_view *view, const size_t *rows, size_t n)
+{
+    PyObject *list, *name;
+    size_t i;
+
+    list = PyList_New((Py_ssize_t)n);
+    if (list == NULL)
+        return NULL;
+
+    for (i = 0; i < n; i++) {
+        name = PyUnicode_DecodeFSDefaultAndSize(
+            view->names + view->name_offsets[rows[i]],
+            (Py_ssize_t)(view->name_offsets[rows[i] + 1] - view->name_offsets[rows[i]]));
+        if (name == NULL) {
+            Py_DECREF(list);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, (Py_ssize_t)i, name);
+    }
+
+    return list;
+}
+
+PyDoc_STRVAR(RefsSnapshot_diff__doc__,
+  "diff(other: RefsSnapshot) -> tuple[list[str], list[str], list[str]]\n"
+  "\n"
+  "Compare with a later snapshot. Returns the names of the references\n"
+  "created, updated and deleted since this snapshot, each list sorted.\n"
+  "A reference is updated when its target changed, or, if both snapshots\n"
+  "are peeled, when the object it peels to changed.");
+
+PyObject *
+RefsSnapshot_diff(RefsSnapshot *self, PyObject *py_other)
+{
+    refs_snapshot_view old, new;
+    size_t *created, *updated, *deleted;
+    size_t i = 0, j = 0, ncreated = 0, nupdated = 0, ndeleted = 0;
+    PyObject *lists[3] = {NULL, NULL, NULL};
+    PyObject *result = NULL;
+    int cmp;
+
+    if (!PyObject_TypeCheck(py_other, &RefsSnapshotType)) {
+        PyErr_SetString(PyExc_TypeError, "expected a RefsSnapshot");
+        return NULL;
+    }
+
+    refs_snapshot_view_init(&old, self);
+    refs_snapshot_view_init(&new, (RefsSnapshot *)py_other);
+
+    /* Large enough for every case */
+    created = PyMem_Malloc((new.count + 1) * sizeof(size_t));
+    updated = PyMem_Malloc((new.count + 1) * sizeof(size_t));
+    deleted = PyMem_Malloc((old.count + 1) * sizeof(size_t));
+    if (created == NULL || updated == NULL || deleted == NULL) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+
+    /* The buffers are immutable, and kept alive by the two snapshots */
+    Py_BEGIN_ALLOW_THREADS
+    while (i < old.count || j < new.count) {
+        if (i == old.count)
+            cmp = 1;
+        else if (j == new.count)
+            cmp = -1;
+        else
+            cmp = refs_snapshot_name_cmp(&old, i, &new, j);
+
+        if (cmp < 0) {
+            deleted[ndeleted++] = i++;
+        } else if (cmp > 0) {
+            created[ncreated++] = j++;
+        } else {
+            if (refs_snapshot_changed(&old, i, &new, j))
+                updated[nupdated++] = j;
+            i++;
+            j++;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    lists[0] = refs_snapshot_names(&new, created, ncreated);
+    lists[1] = refs_snapshot_names(&new, updated, nupdated);
+    lists[2] = refs_snapshot_names(&old, deleted, ndeleted);
+    if (lists[0] && lists[1] && lists[2])
+        result = PyTuple_Pack(3, lists[0], lists[1], lists[2]);
+
+exit:
+    Py_XDECREF(lists[0]);
+    Py_XDECREF(lists[1]);
+    Py_XDECREF(lists[2]);
+    PyMem_Free(created);
+    PyMem_Free(updated);
+    PyMem_Free(deleted);
+    return result;
+}
+
+void
+RefsSnapshot_dealloc(RefsSnapshot *self)
+{
+    int i;
+
+    for (i = 0; i < RS_NCOLUMNS; i++)
+        Py_XDECREF(self->buffers[i]);
+    Py_XDECREF(self->names);
+    Py_XDECREF(self->name_offsets);
+    Py_XDECREF(self->targets);
+    Py_XDECREF(self->symbolic);
+    Py_XDECREF(self->symbolic_offsets);
+    Py_XDECREF(self->peeled);
+    PyObject_Del(self);
+}
+
+Py_ssize_t
+RefsSnapshot_len(RefsSnapshot *self)
+{
+    return self->count;
+}
+
+PyMethodDef RefsSnapshot_methods[] = {
+    METHOD(RefsSnapshot, diff, METH_O),
+    {NULL}
+};
+
+PyMemberDef RefsSnapshot_members[] = {
+    RMEMBER(RefsSnapshot, names, T_OBJECT,
+            "The names of the references, one after the other, in byte order.\n"
+            "The name of reference i is bytes name_offsets[i] to name_offsets[i+1]."),
+    RMEMBER(RefsSnapshot, name_offsets, T_OBJECT,
+            "Where every name starts in names, and where the last ends (format 'q')."),
+    RMEMBER(RefsSnapshot, targets, T_OBJECT,
+            "The raw target ids, 20 bytes per reference; zero for symbolic references."),
+    RMEMBER(RefsSnapshot, symbolic, T_OBJECT,
+            "The targets of the symbolic references, one after the other; empty\n"
+            "for direct references. See symbolic_offsets."),
+    RMEMBER(RefsSnapshot, symbolic_offsets, T_OBJECT,
+            "Where every symbolic target starts in symbolic (format 'q')."),
+    RMEMBER(RefsSnapshot, peeled, T_OBJECT,
+            "The raw ids of the objects the references peel to, 20 bytes per\n"
+            "reference and zero when not peelable, or None if not peeled."),
+    {NULL}
+};
+
+PySequenceMethods RefsSnapshot_as_sequence = {
+    (lenfunc)RefsSnapshot_len,      /* sq_length */
+    0,                              /* sq_concat */
+    0,                              /* sq_repeat */
+    0,                              /* sq_item */
+    0,                              /* sq_slice */
+    0,                              /* sq_ass_item */
+    0,                              /* sq_ass_slice */
+    0,                              /* sq_contains */
+};
+
+PyDoc_STRVAR(RefsSnapshot__doc__,
+  "The references of a repository at some point, see\n"
+  "`Repository.refs_snapshot()`. The references are sorted by name, and\n"
+  "stored as flat columns of memoryviews, reference i being row i of each.");
+
+PyTypeObject RefsSnapshotType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.RefsSnapshot",                    /* tp_name           */
+    sizeof(RefsSnapshot),                      /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)RefsSnapshot_dealloc,          /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    &RefsSnapshot_as_sequence,                 /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    RefsSnapshot__doc__,                       /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    RefsSnapshot_methods,                      /* tp_methods        */
+    RefsSnapshot_members,                      /* tp_members        */
+    0,                                         /* tp_getset         */
+    0,                                         /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    0,                                         /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
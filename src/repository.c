@@ -38,12 +38,15 @@
 #include "oid.h"
 #include "note.h"
 #include "refdb.h"
+#include "refdb_backend.h"
+#include "refs_snapshot.h"
 #include "repository.h"
 #include "diff.h"
 #include "branch.h"
 #include "signature.h"
 #include "worktree.h"
 #include <git2/odb_backend.h>
+#include <git2/sys/errors.h>
 #include <git2/sys/repository.h>
 
 // TODO: remove this function when Python 3.13 becomes the minimum supported version
@@ -323,6 +326,91 @@ Repository_git_object_lookup_prefix(Repository *self, PyObject *key)
 }
 
 
+PyDoc_STRVAR(Repository_lookup_many__doc__,
+  "lookup_many(oids: Iterable[Oid | str], type: ObjectType | None = None) -> list[Object | None]\n"
+  "\n"
+  "Look up several objects at once. Returns a list with the object for every\n"
+  "id, in the order given, or None where the object does not exist or is not\n"
+  "of the requested type.\n"
+  "\n"
+  "The objects are looked up ordered by id, and without holding the GIL unless\n"
+  "the object database has a backend implemented in Python.");
+
+PyObject *
+Repository_lookup_many(Repository *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"oids", "type", NULL};
+    PyObject *py_oids, *py_type = Py_None;
+    pgit_oid_request *requests;
+    git_object *obj;
+    git_otype otype;
+    Py_ssize_t i, n;
+    PyObject *list = NULL;
+    PyObject *item;
+    int err = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O", keywords,
+                                     &py_oids, &py_type))
+        return NULL;
+
+    otype = py_object_to_otype(py_type);
+    if (otype == GIT_OBJECT_INVALID)
+        return NULL;
+
+    requests = py_oids_to_git_requests(py_oids, &n);
+    if (requests == NULL)
+        return NULL;
+
+    PGIT_BEGIN_ALLOW_THREADS_IF(repository_odb_allows_threads(self->repo))
+    for (i = 0; i < n; i++) {
+        requests[i].err = git_object_lookup_prefix(&obj, self->repo,
+                                                   &requests[i].oid,
+                                                   requests[i].len, otype);
+        requests[i].result = requests[i].err < 0 ? NULL : obj;
+        if (requests[i].err < 0 && requests[i].err != GIT_ENOTFOUND) {
+            err = requests[i].err;
+            break;
+        }
+    }
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (err < 0) {
+        if (err != GIT_EUSER || !PyErr_Occurred())
+            Error_set_oid(err, &requests[i].oid, requests[i].len);
+        goto exit;
+    }
+
+    list = PyList_New(n);
+    if (list == NULL)
+        goto exit;
+
+    for (i = 0; i < n; i++) {
+        obj = requests[i].result;
+        if (obj == NULL) {
+            Py_INCREF(Py_None);
+            PyList_SET_ITEM(list, requests[i].pos, Py_None);
+            continue;
+        }
+
+        item = wrap_object(obj, self, NULL);
+        if (item == NULL) {
+            Py_CLEAR(list);
+            goto exit;
+        }
+        requests[i].result = NULL;
+        PyList_SET_ITEM(list, requests[i].pos, item);
+    }
+
+exit:
+    /* Not found errors are expected, do not leave them behind */
+    git_error_clear();
+    for (i = 0; i < n; i++)
+        git_object_free(requests[i].result);
+    PyMem_Free(requests);
+    return list;
+}
+
+
 PyDoc_STRVAR(Repository_lookup_branch__doc__,
   "lookup_branch(branch_name: str, branch_type: BranchType = BranchType.LOCAL) -> Branch\n"
   "\n"
@@ -786,7 +874,7 @@ Repository_cherrypick(Repository *self, PyObject *py_oid)
 }
 
 PyDoc_STRVAR(Repository_walk__doc__,
-    "walk(oid: Oid | None, sort_mode: enums.SortMode = enums.SortMode.NONE) -> Walker\n"
+    "walk(oid: Oid | None, sort_mode: enums.SortMode = enums.SortMode.NONE, yield_ids: bool = False) -> Walker\n"
     "\n"
     "Start traversing the history from the given commit.\n"
     "The following SortMode values can be used to control the walk:\n"
@@ -802,6 +890,9 @@ PyDoc_STRVAR(Repository_walk__doc__,
     "* REVERSE.  Iterate through the repository contents in reverse\n"
     "  order; this sorting mode can be combined with any of the above.\n"
     "\n"
+    "If yield_ids is true the walker yields the ids of the commits instead of\n"
+    "the commits themselves, see Walker.oids().\n"
+    "\n"
     "Example:\n"
     "\n"
     "  >>> from pygit2 import Repository\n"
@@ -814,16 +905,19 @@ PyDoc_STRVAR(Repository_walk__doc__,
     "  >>>\n");
 
 PyObject *
-Repository_walk(Repository *self, PyObject *args)
+Repository_walk(Repository *self, PyObject *args, PyObject *kwds)
 {
+    char *keywords[] = {"oid", "sort_mode", "yield_ids", NULL};
     PyObject *value;
     unsigned int sort = GIT_SORT_NONE;
+    int yield_ids = 0;
     int err;
     git_oid oid;
     git_revwalk *walk;
     Walker *py_walker;
 
-    if (!PyArg_ParseTuple(args, "O|I", &value, &sort))
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|Ip", keywords,
+                                     &value, &sort, &yield_ids))
         return NULL;
 
     err = git_revwalk_new(&walk, self->repo);
@@ -851,6 +945,7 @@ Repository_walk(Repository *self, PyObject *args)
         Py_INCREF(self);
         py_walker->repo = self;
         py_walker->walk = walk;
+        py_walker->yield_ids = yield_ids;
         return (PyObject*)py_walker;
     }
 
@@ -860,6 +955,690 @@ error:
 }
 
 
+/*
+ * Commit table, see Repository.commit_table
+ *
+ * Every column is filled in a growing C buffer while walking, then handed
+ * out as a memoryview with the right format, so the data can be consumed
+ * as is by numpy, pandas or Arrow.
+ */
+enum {
+    CT_ID,
+    CT_TREE,
+    CT_PARENTS,
+    CT_PARENT_OFFSETS,
+    CT_AUTHOR_TIME,
+    CT_AUTHOR_OFFSET,
+    CT_COMMITTER_TIME,
+    CT_COMMITTER_OFFSET,
+    CT_AUTHOR_NAME,
+    CT_AUTHOR_NAME_OFFSETS,
+    CT_AUTHOR_EMAIL,
+    CT_AUTHOR_EMAIL_OFFSETS,
+    CT_COMMITTER_NAME,
+    CT_COMMITTER_NAME_OFFSETS,
+    CT_COMMITTER_EMAIL,
+    CT_COMMITTER_EMAIL_OFFSETS,
+    CT_NCOLUMNS
+};
+
+static const struct {
+    const char *name;
+    const char *format;
+} commit_table_columns[CT_NCOLUMNS] = {
+    {"id", "B"},
+    {"tree", "B"},
+    {"parents", "B"},
+    {"parent_offsets", "q"},
+    {"author_time", "q"},
+    {"author_offset", "i"},
+    {"committer_time", "q"},
+    {"committer_offset", "i"},
+    {"author_name", "B"},
+    {"author_name_offsets", "q"},
+    {"author_email", "B"},
+    {"author_email_offsets", "q"},
+    {"committer_name", "B"},
+    {"committer_name_offsets", "q"},
+    {"committer_email", "B"},
+    {"committer_email_offsets", "q"},
+};
+
+static int
+commit_table_append_int64(pgit_buffer *buf, int64_t value)
+{
+    return pgit_buffer_append(buf, &value, sizeof(value));
+}
+
+static int
+commit_table_append_int32(pgit_buffer *buf, int32_t value)
+{
+    return pgit_buffer_append(buf, &value, sizeof(value));
+}
+
+/* Append a string to a data column, and its end to the offsets column */
+static int
+commit_table_append_str(pgit_buffer *cols, int column, const char *value)
+{
+    if (pgit_buffer_append(&cols[column], value, strlen(value)) < 0)
+        return -1;
+
+    return commit_table_append_int64(&cols[column + 1], (int64_t)cols[column].size);
+}
+
+/* Add a row. Does not need the GIL, returns -1 on out of memory. */
+static int
+commit_table_add(pgit_buffer *cols, const git_commit *commit)
+{
+    const git_signature *author = git_commit_author(commit);
+    const git_signature *committer = git_commit_committer(commit);
+    unsigned int i, nparents = git_commit_parentcount(commit);
+
+    if (pgit_buffer_append(&cols[CT_ID], git_commit_id(commit)->id, GIT_OID_RAWSZ) < 0 ||
+        pgit_buffer_append(&cols[CT_TREE], git_commit_tree_id(commit)->id, GIT_OID_RAWSZ) < 0)
+        return -1;
+
+    for (i = 0; i < nparents; i++) {
+        if (pgit_buffer_append(&cols[CT_PARENTS], git_commit_parent_id(commit, i)->id, GIT_OID_RAWSZ) < 0)
+            return -1;
+    }
+
+    if (commit_table_append_int64(&cols[CT_PARENT_OFFSETS], (int64_t)(cols[CT_PARENTS].size / GIT_OID_RAWSZ)) < 0 ||
+        commit_table_append_int64(&cols[CT_AUTHOR_TIME], author->when.time) < 0 ||
+        commit_table_append_int32(&cols[CT_AUTHOR_OFFSET], author->when.offset) < 0 ||
+        commit_table_append_int64(&cols[CT_COMMITTER_TIME], committer->when.time) < 0 ||
+        commit_table_append_int32(&cols[CT_COMMITTER_OFFSET], committer->when.offset) < 0 ||
+        commit_table_append_str(cols, CT_AUTHOR_NAME, author->name) < 0 ||
+        commit_table_append_str(cols, CT_AUTHOR_EMAIL, author->email) < 0 ||
+        commit_table_append_str(cols, CT_COMMITTER_NAME, committer->name) < 0 ||
+        commit_table_append_str(cols, CT_COMMITTER_EMAIL, committer->email) < 0)
+        return -1;
+
+    return 0;
+}
+
+PyDoc_STRVAR(Repository_commit_table__doc__,
+  "commit_table(commits: Walker | Iterable[Oid | str]) -> dict[str, memoryview]\n"
+  "\n"
+  "Read the metadata of many commits into flat columns. The commits are\n"
+  "given as a Walker, which is consumed, or as a sequence of ids. Returns a\n"
+  "dictionary of memoryviews, with one row per commit in the order walked:\n"
+  "\n"
+  "id, tree\n"
+  "    Raw ids, 20 bytes per commit, one after the other.\n"
+  "\n"
+  "parents, parent_offsets\n"
+  "    The raw ids of the parents of all commits, one after the other; the\n"
+  "    parents of commit i are ids parent_offsets[i] to parent_offsets[i+1]\n"
+  "    (format 'q').\n"
+  "\n"
+  "author_time, committer_time, author_offset, committer_offset\n"
+  "    Time in seconds since the epoch (format 'q') and timezone offset in\n"
+  "    minutes (format 'i').\n"
+  "\n"
+  "author_name, author_email, committer_name, committer_email\n"
+  "    The raw bytes of every string, one after the other; the string of\n"
+  "    commit i is bytes X_offsets[i] to X_offsets[i+1] (format 'q').\n"
+  "\n"
+  "The commits are read without holding the GIL, unless the object database\n"
+  "has a backend implemented in Python. For example, to build a DataFrame:\n"
+  "\n"
+  "  >>> table = repo.commit_table(repo.walk(repo.head.target))\n"
+  "  >>> times = numpy.frombuffer(table['committer_time'], dtype=numpy.int64)\n");
+
+PyObject *
+Repository_commit_table(Repository *self, PyObject *py_commits)
+{
+    pgit_buffer cols[CT_NCOLUMNS];
+    git_oid *oids = NULL;
+    size_t *lens = NULL;
+    Py_ssize_t i, n = 0;
+    git_revwalk *walk = NULL;
+    git_commit *commit;
+    git_oid oid;
+    PyObject *result = NULL;
+    PyObject *column;
+    int err = 0, nomem = 0;
+
+    memset(cols, 0, sizeof(cols));
+
+    if (PyObject_TypeCheck(py_commits, &WalkerType)) {
+        walk = ((Walker *)py_commits)->walk;
+    }
+    else {
+        PyObject *seq = PySequence_Fast(py_commits, "expected a Walker or an iterable of oids");
+        if (seq == NULL)
+            return NULL;
+
+        n = PySequence_Fast_GET_SIZE(seq);
+        oids = PyMem_Malloc((n > 0 ? n : 1) * sizeof(git_oid));
+        lens = PyMem_Malloc((n > 0 ? n : 1) * sizeof(size_t));
+        if (oids == NULL || lens == NULL) {
+            Py_DECREF(seq);
+            PyErr_NoMemory();
+            goto exit;
+        }
+
+        for (i = 0; i < n; i++) {
+            lens[i] = py_oid_to_git_oid(PySequence_Fast_GET_ITEM(seq, i), &oids[i]);
+            if (lens[i] == 0) {
+                Py_DECREF(seq);
+                goto exit;
+            }
+        }
+        Py_DECREF(seq);
+    }
+
+    /* The offset columns start at 0 */
+    if (commit_table_append_int64(&cols[CT_PARENT_OFFSETS], 0) < 0 ||
+        commit_table_append_int64(&cols[CT_AUTHOR_NAME_OFFSETS], 0) < 0 ||
+        commit_table_append_int64(&cols[CT_AUTHOR_EMAIL_OFFSETS], 0) < 0 ||
+        commit_table_append_int64(&cols[CT_COMMITTER_NAME_OFFSETS], 0) < 0 ||
+        commit_table_append_int64(&cols[CT_COMMITTER_EMAIL_OFFSETS], 0) < 0) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+
+    PGIT_BEGIN_ALLOW_THREADS_IF(repository_odb_allows_threads(self->repo))
+    for (i = 0; walk || i < n; i++) {
+        if (walk) {
+            err = git_revwalk_next(&oid, walk);
+            if (err == GIT_ITEROVER) {
+                err = 0;
+                break;
+            }
+            if (err == 0)
+                err = git_commit_lookup(&commit, self->repo, &oid);
+        }
+        else {
+            err = git_commit_lookup_prefix(&commit, self->repo, &oids[i], lens[i]);
+        }
+        if (err < 0)
+            break;
+
+        nomem = commit_table_add(cols, commit) < 0;
+        git_commit_free(commit);
+        if (nomem)
+            break;
+    }
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (nomem) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+    if (err < 0) {
+        if (walk)
+            Error_set(err);
+        else
+            Error_set_oid(err, &oids[i], lens[i]);
+        goto exit;
+    }
+
+    result = PyDict_New();
+    if (result == NULL)
+        goto exit;
+
+    for (i = 0; i < CT_NCOLUMNS; i++) {
+        column = pgit_buffer_to_memoryview(&cols[i], commit_table_columns[i].format);
+        if (column == NULL ||
+            PyDict_SetItemString(result, commit_table_columns[i].name, column) < 0) {
+            Py_XDECREF(column);
+            Py_CLEAR(result);
+            goto exit;
+        }
+        Py_DECREF(column);
+    }
+
+exit:
+    for (i = 0; i < CT_NCOLUMNS; i++)
+        free(cols[i].data);
+    PyMem_Free(oids);
+    PyMem_Free(lens);
+    return result;
+}
+
+
+/*
+ * Changed paths, see Repository.changed_paths
+ *
+ * The commits are split between native worker threads, commit i going to
+ * worker i % nworkers. Every worker diffs its commits against their first
+ * parent and appends the paths and statuses to its own buffers; once they
+ * are done the paths are interned into a single table, in commit order.
+ * None of this touches Python, so buffers are allocated with malloc.
+ *
+ * Worker 0 uses the shared repository, the others a handle of their own,
+ * opened before any thread starts; there are only as many workers as
+ * handles, so without any the diffs are serial.
+ */
+typedef struct {
+    git_repository *repo;
+    git_repository *own;        /* Owned by the worker, NULL for worker 0 */
+    const git_oid *oids;
+    const size_t *lens;
+    size_t n;
+    size_t first;
+    size_t stride;
+    git_oid *ids;               /* Full commit ids, shared by all workers */
+    size_t *starts;             /* First entry of every commit, in its worker */
+    size_t *counts;             /* Number of entries of every commit */
+    pgit_buffer paths;     /* NUL terminated paths */
+    pgit_buffer offsets;   /* size_t, where every entry's path starts */
+    pgit_buffer status;    /* git_delta_t of every entry, one byte */
+    int err;
+    size_t err_index;
+    char *err_msg;
+    pgit_thread thread;
+    int started;
+} changed_paths_worker;
+
+static int
+changed_paths_diff(changed_paths_worker *w, git_repository *repo, size_t i)
+{
+    git_diff_options opts = GIT_DIFF_OPTIONS_INIT;
+    git_commit *commit = NULL, *parent = NULL;
+    git_tree *tree = NULL, *parent_tree = NULL;
+    git_diff *diff = NULL;
+    const git_diff_delta *delta;
+    const char *path;
+    size_t k, ndeltas, offset;
+    unsigned char status;
+    int err;
+
+    opts.flags |= GIT_DIFF_SKIP_BINARY_CHECK;
+
+    err = git_commit_lookup_prefix(&commit, repo, &w->oids[i], w->lens[i]);
+    if (err == 0)
+        err = git_commit_tree(&tree, commit);
+    if (err == 0 && git_commit_parentcount(commit) > 0) {
+        err = git_commit_parent(&parent, commit, 0);
+        if (err == 0)
+            err = git_commit_tree(&parent_tree, parent);
+    }
+    if (err == 0)
+        err = git_diff_tree_to_tree(&diff, repo, parent_tree, tree, &opts);
+    if (err < 0)
+        goto exit;
+
+    git_oid_cpy(&w->ids[i], git_commit_id(commit));
+    ndeltas = git_diff_num_deltas(diff);
+    w->starts[i] = w->status.size;
+    w->counts[i] = ndeltas;
+    for (k = 0; k < ndeltas; k++) {
+        delta = git_diff_get_delta(diff, k);
+        path = delta->status == GIT_DELTA_DELETED ? delta->old_file.path
+                                                  : delta->new_file.path;
+        offset = w->paths.size;
+        status = (unsigned char)delta->status;
+        if (pgit_buffer_append(&w->paths, path, strlen(path) + 1) < 0 ||
+            pgit_buffer_append(&w->offsets, &offset, sizeof(offset)) < 0 ||
+            pgit_buffer_append(&w->status, &status, 1) < 0) {
+            git_error_set_oom();
+            err = GIT_ERROR;
+            break;
+        }
+    }
+
+exit:
+    git_diff_free(diff);
+    git_tree_free(parent_tree);
+    git_tree_free(tree);
+    git_commit_free(parent);
+    git_commit_free(commit);
+    return err;
+}
+
+static void
+changed_paths_run(void *payload)
+{
+    changed_paths_worker *w = payload;
+    const git_error *error;
+    size_t i;
+    int err;
+
+    for (i = w->first; i < w->n; i += w->stride) {
+        err = changed_paths_diff(w, w->repo, i);
+        if (err < 0) {
+            /* Error messages are per thread, keep ours for the caller */
+            error = git_error_last();
+            w->err = err;
+            w->err_index = i;
+            w->err_msg = strdup(error && error->message ? error->message : "");
+            break;
+        }
+    }
+}
+
+/* Intern the paths, with open addressing on a FNV-1a hash */
+typedef struct {
+    pgit_buffer paths;     /* NUL terminated paths */
+    pgit_buffer offsets;   /* size_t, where every path starts */
+    size_t *slots;              /* path id + 1, 0 for empty */
+    size_t mask;
+    size_t count;
+} changed_paths_table;
+
+static size_t
+changed_paths_hash(const char *path)
+{
+    size_t hash = (size_t)14695981039346656037ULL;
+    for (; *path; path++) {
+        hash ^= (unsigned char)*path;
+        hash *= (size_t)1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Returns the id of path, or -1 on out of memory */
+static int64_t
+changed_paths_intern(changed_paths_table *table, const char *path)
+{
+    size_t i, j, id, offset, *slots;
+    const size_t *offsets;
+
+    if ((table->count + 1) * 2 > table->mask + 1) {
+        size_t capacity = table->mask ? (table->mask + 1) * 2 : 1024;
+        slots = calloc(capacity, sizeof(size_t));
+        if (slots == NULL)
+            return -1;
+        offsets = (const size_t *)table->offsets.data;
+        for (id = 0; id < table->count; id++) {
+            j = changed_paths_hash(table->paths.data + offsets[id]) & (capacity - 1);
+            while (slots[j])
+                j = (j + 1) & (capacity - 1);
+            slots[j] = id + 1;
+        }
+        free(table->slots);
+        table->slots = slots;
+        table->mask = capacity - 1;
+    }
+
+    offsets = (const size_t *)table->offsets.data;
+    for (i = changed_paths_hash(path) & table->mask; table->slots[i];
+         i = (i + 1) & table->mask) {
+        id = table->slots[i] - 1;
+        if (strcmp(table->paths.data + offsets[id], path) == 0)
+            return (int64_t)id;
+    }
+
+    offset = table->paths.size;
+    if (pgit_buffer_append(&table->paths, path, strlen(path) + 1) < 0 ||
+        pgit_buffer_append(&table->offsets, &offset, sizeof(offset)) < 0)
+        return -1;
+
+    table->slots[i] = ++table->count;
+    return (int64_t)(table->count - 1);
+}
+
+PyDoc_STRVAR(Repository_changed_paths__doc__,
+  "changed_paths(commits: Walker | Iterable[Oid | str], threads: int = 1) -> dict[str, memoryview | list[str]]\n"
+  "\n"
+  "Find the paths changed by many commits, compared to their first parent\n"
+  "(or to the empty tree for root commits), as `git log --name-status`\n"
+  "does. The commits are given as a Walker, which is consumed, or as a\n"
+  "sequence of ids. Returns a dictionary with:\n"
+  "\n"
+  "id\n"
+  "    Raw ids of the commits, 20 bytes per commit, in the order given.\n"
+  "\n"
+  "offsets\n"
+  "    The changes of commit i are entries offsets[i] to offsets[i+1]\n"
+  "    (format 'q').\n"
+  "\n"
+  "path_ids, status\n"
+  "    For every entry, the index of its path in `paths` (format 'i') and\n"
+  "    its status, a DeltaStatus value (format 'B').\n"
+  "\n"
+  "paths\n"
+  "    The distinct paths, each one appears once.\n"
+  "\n"
+  "The diffs are computed without holding the GIL, split between `threads`\n"
+  "native threads, unless the object database has a backend implemented\n"
+  "in Python (then a single thread is used, with the GIL).\n"
+  "\n"
+  "Example::\n"
+  "\n"
+  "  >>> changes = repo.changed_paths(repo.walk(repo.head.target), threads=8)\n"
+  "  >>> offsets, path_ids = changes['offsets'], changes['path_ids']\n"
+  "  >>> first = [changes['paths'][path_ids[j]] for j in range(offsets[0], offsets[1])]\n");
+
+PyObject *
+Repository_changed_paths(Repository *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"commits", "threads", NULL};
+    PyObject *py_commits;
+    int threads = 1;
+    git_oid *oids = NULL;
+    size_t *lens = NULL;
+    git_oid *ids = NULL;
+    size_t *starts = NULL, *counts = NULL;
+    size_t i, k, n = 0, nworkers;
+    changed_paths_worker *workers = NULL, *w;
+    changed_paths_worker *failed = NULL;
+    changed_paths_table table;
+    pgit_buffer cols[4];   /* id, offsets, path_ids, status */
+    int allow_threads, nomem = 0;
+    int64_t id, end = 0;
+    int32_t path_id;
+    PyObject *result = NULL, *column, *py_paths;
+    static const struct {
+        const char *name;
+        const char *format;
+    } columns[4] = {{"id", "B"}, {"offsets", "q"}, {"path_ids", "i"}, {"status", "B"}};
+
+    memset(&table, 0, sizeof(table));
+    memset(cols, 0, sizeof(cols));
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i", keywords, &py_commits, &threads))
+        return NULL;
+
+    if (threads < 1) {
+        PyErr_SetString(PyExc_ValueError, "threads must be at least 1");
+        return NULL;
+    }
+
+    allow_threads = repository_odb_allows_threads(self->repo);
+
+    /* Collect the ids of the commits */
+    if (PyObject_TypeCheck(py_commits, &WalkerType)) {
+        git_revwalk *walk = ((Walker *)py_commits)->walk;
+        pgit_buffer buf = {NULL, 0, 0};
+        git_oid oid;
+        int err;
+
+        PGIT_BEGIN_ALLOW_THREADS_IF(allow_threads)
+        while ((err = git_revwalk_next(&oid, walk)) == 0) {
+            if (pgit_buffer_append(&buf, &oid, sizeof(oid)) < 0) {
+                nomem = 1;
+                break;
+            }
+        }
+        PGIT_END_ALLOW_THREADS_IF
+
+        if (nomem) {
+            free(buf.data);
+            return PyErr_NoMemory();
+        }
+        if (err != GIT_ITEROVER) {
+            free(buf.data);
+            return Error_set(err);
+        }
+
+        oids = (git_oid *)buf.data;
+        n = buf.size / sizeof(git_oid);
+        lens = malloc((n > 0 ? n : 1) * sizeof(size_t));
+        if (lens == NULL) {
+            PyErr_NoMemory();
+            goto exit;
+        }
+        for (i = 0; i < n; i++)
+            lens[i] = GIT_OID_HEXSZ;
+    }
+    else {
+        PyObject *seq = PySequence_Fast(py_commits, "expected a Walker or an iterable of oids");
+        if (seq == NULL)
+            return NULL;
+
+        n = (size_t)PySequence_Fast_GET_SIZE(seq);
+        oids = malloc((n > 0 ? n : 1) * sizeof(git_oid));
+        lens = malloc((n > 0 ? n : 1) * sizeof(size_t));
+        if (oids == NULL || lens == NULL) {
+            Py_DECREF(seq);
+            PyErr_NoMemory();
+            goto exit;
+        }
+
+        for (i = 0; i < n; i++) {
+            lens[i] = py_oid_to_git_oid(PySequence_Fast_GET_ITEM(seq, i), &oids[i]);
+            if (lens[i] == 0) {
+                Py_DECREF(seq);
+                goto exit;
+            }
+        }
+        Py_DECREF(seq);
+    }
+
+    nworkers = allow_threads ? (size_t)threads : 1;
+    if (nworkers > n)
+        nworkers = n > 0 ? n : 1;
+
+    ids = malloc((n > 0 ? n : 1) * sizeof(git_oid));
+    starts = malloc((n > 0 ? n : 1) * sizeof(size_t));
+    counts = malloc((n > 0 ? n : 1) * sizeof(size_t));
+    workers = calloc(nworkers, sizeof(changed_paths_worker));
+    if (ids == NULL || starts == NULL || counts == NULL || workers == NULL) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+
+    PGIT_BEGIN_ALLOW_THREADS_IF(allow_threads)
+
+    for (i = 1; i < nworkers; i++) {
+        workers[i].own = repository_open_thread_handle(self->repo);
+        if (workers[i].own == NULL) {
+            nworkers = i;
+            break;
+        }
+    }
+
+    for (i = 0; i < nworkers; i++) {
+        w = &workers[i];
+        w->repo = w->own ? w->own : self->repo;
+        w->oids = oids;
+        w->lens = lens;
+        w->n = n;
+        w->first = i;
+        w->stride = nworkers;
+        w->ids = ids;
+        w->starts = starts;
+        w->counts = counts;
+    }
+
+    /* The calling thread is worker 0, and takes over workers which could
+     * not be started */
+    for (i = 1; i < nworkers; i++)
+        workers[i].started = pgit_thread_start(&workers[i].thread, changed_paths_run, &workers[i]) == 0;
+    changed_paths_run(&workers[0]);
+    for (i = 1; i < nworkers; i++) {
+        if (workers[i].started)
+            pgit_thread_join(&workers[i].thread);
+        else
+            changed_paths_run(&workers[i]);
+    }
+
+    /* Report the error of the first commit that failed */
+    for (i = 0; i < nworkers; i++) {
+        if (workers[i].err < 0 && (failed == NULL || workers[i].err_index < failed->err_index))
+            failed = &workers[i];
+    }
+
+    /* Gather the results in commit order */
+    if (failed == NULL) {
+        nomem = pgit_buffer_append(&cols[1], &end, sizeof(end)) < 0;
+        for (i = 0; i < n && !nomem; i++) {
+            w = &workers[i % nworkers];
+            nomem = pgit_buffer_append(&cols[0], ids[i].id, GIT_OID_RAWSZ) < 0;
+            for (k = starts[i]; k < starts[i] + counts[i] && !nomem; k++) {
+                id = changed_paths_intern(&table, w->paths.data + ((size_t *)w->offsets.data)[k]);
+                path_id = (int32_t)id;
+                nomem = id < 0 ||
+                        pgit_buffer_append(&cols[2], &path_id, sizeof(path_id)) < 0 ||
+                        pgit_buffer_append(&cols[3], w->status.data + k, 1) < 0;
+            }
+            end += (int64_t)counts[i];
+            nomem = nomem || pgit_buffer_append(&cols[1], &end, sizeof(end)) < 0;
+        }
+    }
+
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (failed) {
+        git_error_set_str(GIT_ERROR_INVALID, failed->err_msg ? failed->err_msg : "");
+        Error_set_oid(failed->err, &oids[failed->err_index], lens[failed->err_index]);
+        goto exit;
+    }
+    if (nomem) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+
+    result = PyDict_New();
+    if (result == NULL)
+        goto exit;
+
+    for (i = 0; i < 4; i++) {
+        column = pgit_buffer_to_memoryview(&cols[i], columns[i].format);
+        if (column == NULL || PyDict_SetItemString(result, columns[i].name, column) < 0) {
+            Py_XDECREF(column);
+            Py_CLEAR(result);
+            goto exit;
+        }
+        Py_DECREF(column);
+    }
+
+    py_paths = PyList_New(table.count);
+    if (py_paths == NULL) {
+        Py_CLEAR(result);
+        goto exit;
+    }
+    for (i = 0; i < table.count; i++) {
+        PyObject *py_path = PyUnicode_DecodeFSDefault(
+            table.paths.data + ((size_t *)table.offsets.data)[i]);
+        if (py_path == NULL) {
+            Py_DECREF(py_paths);
+            Py_CLEAR(result);
+            goto exit;
+        }
+        PyList_SET_ITEM(py_paths, i, py_path);
+    }
+    if (PyDict_SetItemString(result, "paths", py_paths) < 0)
+        Py_CLEAR(result);
+    Py_DECREF(py_paths);
+
+exit:
+    for (i = 0; workers && i < nworkers; i++) {
+        free(workers[i].paths.data);
+        free(workers[i].offsets.data);
+        free(workers[i].status.data);
+        free(workers[i].err_msg);
+        git_repository_free(workers[i].own);
+    }
+    for (i = 0; i < 4; i++)
+        free(cols[i].data);
+    free(table.paths.data);
+    free(table.offsets.data);
+    free(table.slots);
+    free(workers);
+    free(counts);
+    free(starts);
+    free(ids);
+    free(lens);
+    free(oids);
+    return result;
+}
+
+
 PyDoc_STRVAR(Repository_create_blob__doc__,
     "create_blob(data: bytes) -> Oid\n"
     "\n"
@@ -1351,25 +2130,38 @@ References_iterator_dealloc(RefsIterator *iter)
 }
 
 PyDoc_STRVAR(Repository_references_iterator_init__doc__,
-  "references_iterator_init() -> git_reference_iterator\n"
+  "references_iterator_init(glob: str | None = None) -> git_reference_iterator\n"
   "\n"
-  "Creates and returns an iterator for references.");
+  "Creates and returns an iterator for references. With a glob, only the\n"
+  "references whose name matches it are returned; the reference database\n"
+  "uses it to skip the others, e.g. the files backend only reads the\n"
+  "directories where they may be.");
 
 PyObject *
-Repository_references_iterator_init(Repository *self, PyObject *args)
+Repository_references_iterator_init(Repository *self, PyObject *args, PyObject *kwds)
 {
+    char *keywords[] = {"glob", NULL};
+    const char *glob = NULL;
     int err;
     git_reference_iterator *iter;
     RefsIterator *refs_iter;
 
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|z", keywords, &glob))
+        return NULL;
+
+    if (glob)
+        err = git_reference_iterator_glob_new(&iter, self->repo, glob);
+    else
+        err = git_reference_iterator_new(&iter, self->repo);
+    if (err < 0)
+        return Error_set(err);
+
     refs_iter = PyObject_New(RefsIterator, &RefsIteratorType);
     if (refs_iter == NULL) {
+        git_reference_iterator_free(iter);
         return NULL;
     }
 
-    if ((err = git_reference_iterator_new(&iter, self->repo)) < 0)
-        return Error_set(err);
-
     refs_iter->iterator = iter;
     return (PyObject*)refs_iter;
 }
@@ -1420,6 +2212,356 @@ Repository_references_iterator_next(Repository *self, PyObject *args)
     return Error_set(err);
 }
 
+PyDoc_STRVAR(Repository_refs_snapshot__doc__,
+  "refs_snapshot(prefix: str | None = None, peel: bool = False) -> RefsSnapshot\n"
+  "\n"
+  "Read all the references, or those whose name starts with prefix, with\n"
+  "their targets, in a single pass without the GIL (unless the reference\n"
+  "or object database has a backend implemented in Python). With peel, the\n"
+  "id of the object every reference peels to is read as well.\n"
+  "\n"
+  "Snapshots are compared with RefsSnapshot.diff():\n"
+  "\n"
+  "  >>> before = repo.refs_snapshot('refs/heads/')\n"
+  "  >>> ...\n"
+  "  >>> created, updated, deleted = before.diff(repo.refs_snapshot('refs/heads/'))\n");
+
+PyObject *
+Repository_refs_snapshot(Repository *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"prefix", "peel", NULL};
+    const char *prefix = NULL;
+    int peel = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|zp", keywords, &prefix, &peel))
+        return NULL;
+
+    return refs_snapshot_new(self, prefix, peel);
+}
+
+/*
+ * Batch reference updates, see Repository.update_refs
+ *
+ * All the references are locked in a single transaction, in name order,
+ * before their current values are compared with the expected ones; so no
+ * other writer may change them in between.
+ */
+typedef struct {
+    char *name;
+    git_oid old;
+    git_oid new;
+    int has_old;                /* Otherwise it must not exist */
+    int has_new;                /* Otherwise it is deleted */
+    int rejected;
+} update_refs_entry;
+
+static int
+update_refs_entry_cmp(const void *a, const void *b)
+{
+    return strcmp(((const update_refs_entry *)a)->name,
+                  ((const update_refs_entry *)b)->name);
+}
+
+/* Whether the reference is at its expected value. Does not need the GIL. */
+static int
+update_refs_check(git_repository *repo, const update_refs_entry *entry)
+{
+    git_reference *ref;
+    int err, matches;
+
+    err = git_reference_lookup(&ref, repo, entry->name);
+    if (err == GIT_ENOTFOUND) {
+        git_error_clear();
+        return !entry->has_old;
+    }
+    if (err < 0)
+        return err;
+
+    matches = entry->has_old &&
+              git_reference_type(ref) == GIT_REFERENCE_DIRECT &&
+              git_oid_equal(git_reference_target(ref), &entry->old);
+    git_reference_free(ref);
+    return matches;
+}
+
+/* Apply the updates, sorted by name. Does not need the GIL. */
+static int
+update_refs_run(git_repository *repo, update_refs_entry *entries, size_t n,
+                int atomic, const char *message)
+{
+    git_transaction *tx;
+    size_t i;
+    int err;
+
+    err = git_transaction_new(&tx, repo);
+    if (err < 0)
+        return err;
+
+    for (i = 0; i < n; i++) {
+        err = git_transaction_lock_ref(tx, entries[i].name);
+        if (err == GIT_ELOCKED && !atomic) {
+            git_error_clear();
+            entries[i].rejected = 1;
+            continue;
+        }
+        if (err < 0)
+            goto exit;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (entries[i].rejected)
+            continue;
+        err = update_refs_check(repo, &entries[i]);
+        if (err < 0)
+            goto exit;
+        if (err == 0) {
+            entries[i].rejected = 1;
+            if (atomic) {
+                git_error_set(GIT_ERROR_REFERENCE,
+                              "reference '%s' is not at the expected value",
+                              entries[i].name);
+                err = GIT_EMODIFIED;
+                goto exit;
+            }
+        }
+    }
+
+    /* Rejected references stay locked, and are released on commit */
+    for (i = 0; i < n; i++) {
+        if (entries[i].rejected)
+            continue;
+        if (entries[i].has_new)
+            err = git_transaction_set_target(tx, entries[i].name, &entries[i].new,
+                                             NULL, message);
+        else if (entries[i].has_old)
+            err = git_transaction_remove(tx, entries[i].name);
+        else
+            err = 0;
+        if (err < 0)
+            goto exit;
+    }
+
+    err = git_transaction_commit(tx);
+
+exit:
+    git_transaction_free(tx);
+    return err;
+}
+
+PyDoc_STRVAR(Repository_update_refs__doc__,
+  "update_refs(updates: Iterable[tuple[str, Oid | str | None, Oid | str | None]], atomic: bool = True, message: str | None = None) -> list[str]\n"
+  "\n"
+  "Update many references at once, each only if it is at the expected\n"
+  "value. Every update is a tuple (name, old, new): old is the id the\n"
+  "reference must point to, or None if it must not exist; new is the id to\n"
+  "point it to, or None to delete it.\n"
+  "\n"
+  "All the references are locked first, then checked, then written, with a\n"
+  "single transaction and without the GIL (unless the reference or object\n"
+  "database has a backend implemented in Python).\n"
+  "\n"
+  "If atomic is True, nothing is updated unless every reference is at its\n"
+  "expected value, otherwise a GitError is raised. If it is False, the\n"
+  "references which are not at their expected value, or are locked by\n"
+  "someone else, are left alone and the others updated.\n"
+  "\n"
+  "Returns the names of the references left alone.\n"
+  "\n"
+  "message\n"
+  "    Optional message for the reflogs.\n"
+  "\n"
+  "Example::\n"
+  "\n"
+  "    repo.update_refs([\n"
+  "        ('refs/heads/main', old_main, new_main),\n"
+  "        ('refs/tags/v1.0', None, commit_id),\n"
+  "        ('refs/heads/topic', topic_id, None),\n"
+  "    ])");
+
+PyObject *
+Repository_update_refs(Repository *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"updates", "atomic", "message", NULL};
+    PyObject *py_updates, *seq, *item, *py_name, *py_old, *py_new;
+    PyObject *result = NULL, *name;
+    update_refs_entry *entries = NULL;
+    const char *message = NULL, *c_name;
+    int atomic = 1, err;
+    Py_ssize_t i, n = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|pz", keywords,
+                                     &py_updates, &atomic, &message))
+        return NULL;
+
+    seq = PySequence_Fast(py_updates, "updates must be an iterable of tuples");
+    if (seq == NULL)
+        return NULL;
+
+    n = PySequence_Fast_GET_SIZE(seq);
+    entries = calloc(n > 0 ? n : 1, sizeof(update_refs_entry));
+    if (entries == NULL) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+
+    for (i = 0; i < n; i++) {
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (!PyTuple_Check(item) || PyTuple_GET_SIZE(item) != 3) {
+            PyErr_SetString(PyExc_TypeError, "updates must be (name, old, new) tuples");
+            goto exit;
+        }
+        py_name = PyTuple_GET_ITEM(item, 0);
+        py_old = PyTuple_GET_ITEM(item, 1);
+        py_new = PyTuple_GET_ITEM(item, 2);
+
+        if (!PyUnicode_Check(py_name)) {
+            PyErr_SetString(PyExc_TypeError, "reference names must be str");
+            goto exit;
+        }
+        if ((c_name = PyUnicode_AsUTF8(py_name)) == NULL)
+            goto exit;
+        if ((entries[i].name = strdup(c_name)) == NULL) {
+            PyErr_NoMemory();
+            goto exit;
+        }
+
+        entries[i].has_old = py_old != Py_None;
+        if (entries[i].has_old &&
+            py_oid_to_git_oid_expand(self->repo, py_old, &entries[i].old) < 0)
+            goto exit;
+        entries[i].has_new = py_new != Py_None;
+        if (entries[i].has_new &&
+            py_oid_to_git_oid_expand(self->repo, py_new, &entries[i].new) < 0)
+            goto exit;
+    }
+
+    qsort(entries, n, sizeof(update_refs_entry), update_refs_entry_cmp);
+    for (i = 1; i < n; i++) {
+        if (strcmp(entries[i - 1].name, entries[i].name) == 0) {
+            PyErr_Format(PyExc_ValueError, "reference '%s' is updated twice", entries[i].name);
+            goto exit;
+        }
+    }
+
+    PGIT_BEGIN_ALLOW_THREADS_IF(refdb_allows_threads() &&
+                                repository_odb_allows_threads(self->repo))
+    err = update_refs_run(self->repo, entries, n, atomic, message);
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (err < 0) {
+        Error_set(err);
+        goto exit;
+    }
+
+    result = PyList_New(0);
+    if (result == NULL)
+        goto exit;
+    for (i = 0; i < n; i++) {
+        if (!entries[i].rejected)
+            continue;
+        name = PyUnicode_FromString(entries[i].name);
+        if (name == NULL || PyList_Append(result, name) < 0) {
+            Py_XDECREF(name);
+            Py_CLEAR(result);
+            goto exit;
+        }
+        Py_DECREF(name);
+    }
+
+exit:
+    if (entries) {
+        for (i = 0; i < n; i++)
+            free(entries[i].name);
+        free(entries);
+    }
+    Py_DECREF(seq);
+    return result;
+}
+
+/* Whether the reference is of the given ReferenceFilter type */
+static int
+reference_name_has_type(const char *name, int references_return_type)
+{
+    switch (references_return_type) {
+        case GIT_REFERENCES_ALL:
+            return 1;
+        case GIT_REFERENCES_BRANCHES:
+            return strncmp(name, "refs/heads/", 11) == 0;
+        case GIT_REFERENCES_TAGS:
+            return strncmp(name, "refs/tags/", 10) == 0;
+    }
+    return 0;
+}
+
+PyDoc_STRVAR(Repository_references_iterator_next_many__doc__,
+  "references_iterator_next_many(iter: Iterator[Reference], n: int, references_return_type: ReferenceFilter = ReferenceFilter.ALL, names_only: bool = False) -> list[Reference] | list[str]\n"
+  "\n"
+  "Returns the next n references of the iterator (fewer at the end, and\n"
+  "an empty list once it is exhausted), filtered as with\n"
+  "references_iterator_next. With names_only, returns their names instead:\n"
+  "then no reference is loaded, only the names are read.");
+
+PyObject *
+Repository_references_iterator_next_many(Repository *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"iter", "n", "references_return_type", "names_only", NULL};
+    git_reference_iterator *git_iter;
+    git_reference *ref;
+    const char *name;
+    PyObject *iter, *list, *item;
+    Py_ssize_t n;
+    int references_return_type = GIT_REFERENCES_ALL, names_only = 0;
+    int err = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O!n|ip", keywords,
+                                     &RefsIteratorType, &iter, &n,
+                                     &references_return_type, &names_only))
+        return NULL;
+
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "n must not be negative");
+        return NULL;
+    }
+
+    git_iter = ((RefsIterator *) iter)->iterator;
+    list = PyList_New(0);
+    if (list == NULL)
+        return NULL;
+
+    while (PyList_GET_SIZE(list) < n) {
+        if (names_only) {
+            err = git_reference_next_name(&name, git_iter);
+            if (err < 0)
+                break;
+            if (!reference_name_has_type(name, references_return_type))
+                continue;
+            item = PyUnicode_DecodeFSDefault(name);
+        } else {
+            err = git_reference_next(&ref, git_iter);
+            if (err < 0)
+                break;
+            if (!reference_name_has_type(git_reference_name(ref), references_return_type)) {
+                git_reference_free(ref);
+                continue;
+            }
+            item = wrap_reference(ref, self);
+        }
+
+        if (item == NULL || PyList_Append(list, item) < 0) {
+            Py_XDECREF(item);
+            Py_DECREF(list);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+
+    if (PyList_GET_SIZE(list) < n && err != GIT_ITEROVER) {
+        Py_DECREF(list);
+        return Error_set(err);
+    }
+    return list;
+}
+
 static PyObject *
 Repository_listall_branches_impl(Repository *self, PyObject *args, PyObject *(*item_trans)(const char *))
 {
@@ -1714,7 +2856,7 @@ Repository_compress_references(Repository *self)
 }
 
 PyDoc_STRVAR(Repository_status__doc__,
-  "status(untracked_files: str = \"all\", ignored: bool = False) -> dict[str, enums.FileStatus]\n"
+  "status(untracked_files: str = \"all\", ignored: bool = False, pathspec: Iterable[str] | None = None, raw: bool = False) -> dict[str, enums.FileStatus] | list[tuple[bytes, int]]\n"
   "\n"
   "Reads the status of the repository and returns a dictionary with file\n"
   "paths as keys and FileStatus flags as values.\n"
@@ -1733,21 +2875,43 @@ PyDoc_STRVAR(Repository_status__doc__,
   "\n"
   "ignored\n"
   "    Whether to show ignored files with untracked files. Ignored when untracked_files == \"no\"\n"
-  "    Defaults to False.\n");
+  "    Defaults to False.\n"
+  "\n"
+  "pathspec\n"
+  "    Restrict the status to the paths matching these patterns (a directory\n"
+  "    matches everything below it). Only those parts of the worktree are\n"
+  "    scanned.\n"
+  "\n"
+  "raw\n"
+  "    If True, return a list of (path, flags) tuples instead, with the\n"
+  "    paths as bytes and the flags as plain integers. This avoids decoding\n"
+  "    every path and building FileStatus objects.\n");
+
+/* Number of distinct FileStatus objects reused while building the result */
+#define STATUS_ENUM_CACHE_SIZE 16
 
 PyObject *
 Repository_status(Repository *self, PyObject *args, PyObject *kw)
 {
     int err;
-    size_t len, i;
-    git_status_list *list;
+    size_t len, i, j, n_cached = 0;
+    git_status_list *list = NULL;
+    git_strarray pathspec = {NULL, 0};
+    PyObject *result = NULL;
+    struct {
+        unsigned int value;
+        PyObject *status;
+    } cache[STATUS_ENUM_CACHE_SIZE];
 
     char *untracked_files = "all";
-    static char *kwlist[] = {"untracked_files", "ignored", NULL};
+    static char *kwlist[] = {"untracked_files", "ignored", "pathspec", "raw", NULL};
 
     PyObject* ignored = Py_False;
+    PyObject *py_pathspec = Py_None;
+    int raw = 0;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kw, "|sO", kwlist, &untracked_files, &ignored))
+    if (!PyArg_ParseTupleAndKeywords(args, kw, "|sOOp", kwlist, &untracked_files,
+                                     &ignored, &py_pathspec, &raw))
         return NULL;
 
     git_status_options opts = GIT_STATUS_OPTIONS_INIT;
@@ -1770,19 +2934,30 @@ Repository_status(Repository *self, PyObject *args, PyObject *kw)
         opts.flags &= ~GIT_STATUS_OPT_INCLUDE_IGNORED;
     }
 
+    if (py_pathspec != Py_None) {
+        if (py_paths_to_git_strarray(py_pathspec, &pathspec) < 0)
+            return NULL;
+        opts.pathspec = pathspec;
+    }
+
+    /* HEAD is resolved through the refdb */
+    PGIT_BEGIN_ALLOW_THREADS_IF(refdb_allows_threads() &&
+                                repository_odb_allows_threads(self->repo))
     err = git_status_list_new(&list, self->repo, &opts);
+    PGIT_END_ALLOW_THREADS_IF
+    pgit_strarray_free(&pathspec);
     if (err < 0)
         return Error_set(err);
 
-    PyObject *dict = PyDict_New();
-    if (dict == NULL)
+    len = git_status_list_entrycount(list);
+    result = raw ? PyList_New(len) : PyDict_New();
+    if (result == NULL)
         goto error;
 
-    len = git_status_list_entrycount(list);
     for (i = 0; i < len; i++) {
         const git_status_entry *entry;
         const char *path;
-        PyObject *status;
+        PyObject *status = NULL;
 
         entry = git_status_byindex(list, i);
         if (entry == NULL)
@@ -1794,10 +2969,34 @@ Repository_status(Repository *self, PyObject *args, PyObject *kw)
         else
             path = entry->index_to_workdir->old_file.path;
 
-        /* Get corresponding entry in enums.FileStatus for status int */
-        status = pygit2_enum(FileStatusEnum, entry->status);
-        if (status == NULL)
-            goto error;
+        if (raw) {
+            PyObject *item = Py_BuildValue("(yI)", path, (unsigned int)entry->status);
+            if (item == NULL)
+                goto error;
+            PyList_SET_ITEM(result, i, item);
+            continue;
+        }
+
+        /* Get corresponding entry in enums.FileStatus for status int, only
+         * a handful of combinations show up so reuse them */
+        for (j = 0; j < n_cached; j++) {
+            if (cache[j].value == (unsigned int)entry->status) {
+                status = cache[j].status;
+                Py_INCREF(status);
+                break;
+            }
+        }
+        if (status == NULL) {
+            status = pygit2_enum(FileStatusEnum, entry->status);
+            if (status == NULL)
+                goto error;
+            if (n_cached < STATUS_ENUM_CACHE_SIZE) {
+                cache[n_cached].value = (unsigned int)entry->status;
+                cache[n_cached].status = status;
+                Py_INCREF(status);
+                n_cached++;
+            }
+        }
 
         PyObject *py_path = PyUnicode_DecodeFSDefault(path);
         if (py_path == NULL) {
@@ -1805,7 +3004,7 @@ Repository_status(Repository *self, PyObject *args, PyObject *kw)
             goto error;
         }
 
-        err = PyDict_SetItem(dict, py_path, status);
+        err = PyDict_SetItem(result, py_path, status);
         Py_DECREF(py_path);
         Py_CLEAR(status);
 
@@ -1813,13 +3012,15 @@ Repository_status(Repository *self, PyObject *args, PyObject *kw)
             goto error;
     }
 
-    git_status_list_free(list);
-    return dict;
+    goto cleanup;
 
 error:
+    Py_CLEAR(result);
+cleanup:
+    for (j = 0; j < n_cached; j++)
+        Py_DECREF(cache[j].status);
     git_status_list_free(list);
-    Py_CLEAR(dict);
-    return NULL;
+    return result;
 }
 
 
@@ -1926,13 +3127,22 @@ PyObject *
 Repository_odb__get__(Repository *self)
 {
     git_odb *odb;
+    git_buf path = {NULL};
+    PyObject *py_odb;
     int err;
 
     err = git_repository_odb(&odb, self->repo);
     if (err < 0)
         return Error_set(err);
 
-    return wrap_odb(odb);
+    /* Repositories without a path (e.g. in memory) have no objects dir */
+    err = git_repository_item_path(&path, self->repo, GIT_REPOSITORY_ITEM_OBJECTS);
+    if (err < 0)
+        git_error_clear();
+
+    py_odb = wrap_odb(odb, err < 0 ? NULL : path.ptr);
+    git_buf_dispose(&path);
+    return py_odb;
 }
 
 PyDoc_STRVAR(Repository_refdb__doc__, "Return the reference database for this repository");
@@ -2244,6 +3454,9 @@ Repository_apply(Repository *self, PyObject *args, PyObject *kwds)
                                      &location))
         return NULL;
 
+    if (diff_check_busy(py_diff) < 0)
+        return NULL;
+
     int err = git_apply(self->repo, py_diff->diff, location, &options);
     if (err != 0)
         return Error_set(err);
@@ -2286,6 +3499,9 @@ Repository_applies(Repository *self, PyObject *args, PyObject *kwds)
                                      &location, &raise_error))
         return NULL;
 
+    if (diff_check_busy(py_diff) < 0)
+        return NULL;
+
     int err = git_apply(self->repo, ((Diff*)py_diff)->diff, location, &options);
     if (err != 0) {
         if (raise_error)
@@ -2442,7 +3658,9 @@ static PyMethodDef Repository_methods[] = {
     METHOD(Repository, create_commit_with_signature, METH_VARARGS),
     METHOD(Repository, create_tag, METH_VARARGS),
     METHOD(Repository, TreeBuilder, METH_VARARGS),
-    METHOD(Repository, walk, METH_VARARGS),
+    METHOD(Repository, walk, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Repository, changed_paths, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Repository, commit_table, METH_O),
     METHOD(Repository, descendant_of, METH_VARARGS),
     METHOD(Repository, merge_base, METH_VARARGS),
     METHOD(Repository, merge_base_many, METH_VARARGS),
@@ -2455,8 +3673,11 @@ static PyMethodDef Repository_methods[] = {
     METHOD(Repository, create_reference_symbolic, METH_VARARGS | METH_KEYWORDS),
     METHOD(Repository, compress_references, METH_NOARGS),
     METHOD(Repository, raw_listall_references, METH_NOARGS),
-    METHOD(Repository, references_iterator_init, METH_NOARGS),
+    METHOD(Repository, references_iterator_init, METH_VARARGS | METH_KEYWORDS),
     METHOD(Repository, references_iterator_next, METH_VARARGS),
+    METHOD(Repository, references_iterator_next_many, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Repository, refs_snapshot, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Repository, update_refs, METH_VARARGS | METH_KEYWORDS),
     METHOD(Repository, listall_submodules, METH_NOARGS),
     METHOD(Repository, lookup_reference, METH_O),
     METHOD(Repository, lookup_reference_dwim, METH_O),
@@ -2469,6 +3690,7 @@ static PyMethodDef Repository_methods[] = {
     METHOD(Repository, create_note, METH_VARARGS),
     METHOD(Repository, lookup_note, METH_VARARGS),
     METHOD(Repository, git_object_lookup_prefix, METH_O),
+    METHOD(Repository, lookup_many, METH_VARARGS | METH_KEYWORDS),
     METHOD(Repository, lookup_branch, METH_VARARGS),
     METHOD(Repository, path_is_ignored, METH_VARARGS),
     METHOD(Repository, listall_branches, METH_VARARGS),
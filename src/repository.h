@@ -45,7 +45,7 @@ int  Repository_init(Repository *self, PyObject *args, PyObject *kwds);
 int  Repository_traverse(Repository *self, visitproc visit, void *arg);
 int  Repository_clear(Repository *self);
 
-PyObject* Repository_walk(Repository *self, PyObject *args);
+PyObject* Repository_walk(Repository *self, PyObject *args, PyObject *kwds);
 PyObject* Repository_create_blob(Repository *self, PyObject *args);
 PyObject* Repository_create_blob_fromdisk(Repository *self, PyObject *args);
 PyObject* Repository_create_commit(Repository *self, PyObject *args);
@@ -53,8 +53,11 @@ PyObject* Repository_create_commit_string(Repository *self, PyObject *args);
 PyObject* Repository_create_commit_with_signature(Repository *self, PyObject *args);
 PyObject* Repository_create_tag(Repository *self, PyObject *args);
 PyObject* Repository_create_branch(Repository *self, PyObject *args);
-PyObject* Repository_references_iterator_init(Repository *self, PyObject *args);
+PyObject* Repository_references_iterator_init(Repository *self, PyObject *args, PyObject *kwds);
 PyObject* Repository_references_iterator_next(Repository *self, PyObject *args);
+PyObject* Repository_references_iterator_next_many(Repository *self, PyObject *args, PyObject *kwds);
+PyObject* Repository_refs_snapshot(Repository *self, PyObject *args, PyObject *kwds);
+PyObject* Repository_update_refs(Repository *self, PyObject *args, PyObject *kwds);
 PyObject* Repository_listall_branches(Repository *self, PyObject *args);
 PyObject* Repository_lookup_reference(Repository *self, PyObject *py_name);
 PyObject* Repository_add_worktree(Repository *self, PyObject *args);
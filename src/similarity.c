@@ -0,0 +1,503 @@
+/*
+ * Copyright 2010-2026 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <structmember.h>
+#include <git2.h>
+#include <git2/sys/errors.h>
+#include <git2/sys/hashsig.h>
+#include "error.h"
+#include "similarity.h"
+#include "types.h"
+#include "utils.h"
+
+extern PyTypeObject SimilarityCacheType;
+
+/*
+ * Signatures
+ *
+ * A signature is shared by the cache and the diffs being searched, and
+ * freed when none uses it anymore. Signatures of files without a known
+ * id, or computed without a cache, are not cached.
+ */
+
+#define SIMILARITY_CACHE_MIN_BUCKETS 16
+
+struct pgit_signature {
+    git_hashsig *sig;           /* NULL if the file is too small */
+    git_oid id;
+    int options;
+    long refcount;              /* The cache counts as one user */
+    int cached;
+    pgit_signature *next;       /* In the bucket */
+    pgit_signature *newer;
+    pgit_signature *older;
+};
+
+static pgit_signature *
+signature_new(git_hashsig *sig)
+{
+    pgit_signature *signature = calloc(1, sizeof(*signature));
+
+    if (signature == NULL) {
+        git_hashsig_free(sig);
+        return NULL;
+    }
+
+    signature->sig = sig;
+    signature->refcount = 1;
+    return signature;
+}
+
+/* Release a user of the signature, with the lock of the cache held if any */
+static void
+signature_release(pgit_signature *signature)
+{
+    if (--signature->refcount > 0)
+        return;
+
+    git_hashsig_free(signature->sig);
+    free(signature);
+}
+
+/* Compute a signature, which is NULL when the file is too small */
+static int
+signature_create(git_hashsig **out, const char *buf, size_t len, const char *path,
+                 int options)
+{
+    int err;
+
+    *out = NULL;
+    if (path)
+        err = git_hashsig_create_fromfile(out, path, (git_hashsig_option_t)options);
+    else
+        err = git_hashsig_create(out, buf, len, (git_hashsig_option_t)options);
+
+    /* Too small to compare, like libgit2's own metric */
+    if (err == GIT_EBUFS) {
+        git_error_clear();
+        *out = NULL;
+        err = 0;
+    }
+    return err;
+}
+
+
+/*
+ * The cache: a hash table with chaining, and a list from the most to the
+ * least recently used signature. Everything happens with the lock held,
+ * as the diffs are searched without the GIL.
+ */
+
+static size_t
+similarity_cache_hash(const SimilarityCache *cache, const git_oid *id, int options)
+{
+    size_t hash;
+
+    memcpy(&hash, id->id, sizeof(hash));
+    return (hash ^ (size_t)options) & cache->mask;
+}
+
+static void
+similarity_cache_unlink(SimilarityCache *cache, pgit_signature *signature)
+{
+    if (signature->newer)
+        signature->newer->older = signature->older;
+    else
+        cache->newest = signature->older;
+
+    if (signature->older)
+        signature->older->newer = signature->newer;
+    else
+        cache->oldest = signature->newer;
+
+    signature->newer = signature->older = NULL;
+}
+
+static void
+similarity_cache_link(SimilarityCache *cache, pgit_signature *signature)
+{
+    signature->older = cache->newest;
+    signature->newer = NULL;
+    if (cache->newest)
+        cache->newest->newer = signature;
+    cache->newest = signature;
+    if (cache->oldest == NULL)
+        cache->oldest = signature;
+}
+
+static void
+similarity_cache_evict(SimilarityCache *cache, pgit_signature *signature)
+{
+    pgit_signature **link;
+
+    link = &cache->buckets[similarity_cache_hash(cache, &signature->id, signature->options)];
+    while (*link != signature)
+        link = &(*link)->next;
+    *link = signature->next;
+
+    similarity_cache_unlink(cache, signature);
+    signature->cached = 0;
+    cache->size--;
+    signature_release(signature);
+}
+
+/* Return a new reference to the cached signature, or NULL */
+static pgit_signature *
+similarity_cache_get(SimilarityCache *cache, const git_oid *id, int options)
+{
+    pgit_signature *signature;
+
+    signature = cache->buckets[similarity_cache_hash(cache, id, options)];
+    for (; signature; signature = signature->next) {
+        if (signature->options == options && git_oid_equal(&signature->id, id)) {
+            similarity_cache_unlink(cache, signature);
+            similarity_cache_link(cache, signature);
+            signature->refcount++;
+            cache->hits++;
+            return signature;
+        }
+    }
+
+    cache->misses++;
+    return NULL;
+}
+
+static void
+similarity_cache_put(SimilarityCache *cache, pgit_signature *signature,
+                     const git_oid *id, int options)
+{
+    size_t i = similarity_cache_hash(cache, id, options);
+
+    git_oid_cpy(&signature->id, id);
+    signature->options = options;
+    signature->cached = 1;
+    signature->refcount++;
+    signature->next = cache->buckets[i];
+    cache->buckets[i] = signature;
+    similarity_cache_link(cache, signature);
+    cache->size++;
+
+    while (cache->size > cache->maxsize)
+        similarity_cache_evict(cache, cache->oldest);
+}
+
+
+/*
+ * The metric
+ */
+
+/*
+ * Given for every file once the budget is spent: libgit2 keeps the
+ * signatures it is given, but asks again for a NULL one, reading the file
+ * again for every pair. It has no hashsig, so it scores 0, and it is
+ * never freed.
+ */
+static pgit_signature similarity_exhausted_signature;
+
+/* Whether the budget is spent, then only identical files are matched */
+static int
+similarity_run_exhausted(similarity_run *run)
+{
+    if (!run->exhausted && run->deadline > 0 && pgit_monotonic() > run->deadline)
+        run->exhausted = 1;
+    return run->exhausted;
+}
+
+static int
+similarity_signature(void **out, const git_diff_file *file, const char *buf,
+                     size_t len, const char *path, similarity_run *run)
+{
+    SimilarityCache *cache = run->cache;
+    pgit_signature *signature = NULL;
+    git_hashsig *sig;
+    int use_cache, err;
+
+    *out = NULL;
+    if (similarity_run_exhausted(run)) {
+        *out = &similarity_exhausted_signature;
+        return 0;
+    }
+
+    use_cache = cache && (file->flags & GIT_DIFF_FLAG_VALID_ID) && !git_oid_is_zero(&file->id);
+    if (use_cache) {
+        PyThread_acquire_lock(cache->lock, WAIT_LOCK);
+        signature = similarity_cache_get(cache, &file->id, run->options);
+        PyThread_release_lock(cache->lock);
+        if (signature) {
+            *out = signature;
+            return 0;
+        }
+    }
+
+    err = signature_create(&sig, buf, len, path, run->options);
+    if (err < 0)
+        return err;
+
+    signature = signature_new(sig);
+    if (signature == NULL) {
+        git_error_set_oom();
+        return -1;
+    }
+
+    if (use_cache) {
+        PyThread_acquire_lock(cache->lock, WAIT_LOCK);
+        similarity_cache_put(cache, signature, &file->id, run->options);
+        PyThread_release_lock(cache->lock);
+    }
+
+    *out = signature;
+    return 0;
+}
+
+static int
+similarity_file_signature(void **out, const git_diff_file *file, const char *path,
+                          void *payload)
+{
+    return similarity_signature(out, file, NULL, 0, path, payload);
+}
+
+static int
+similarity_buffer_signature(void **out, const git_diff_file *file, const char *buf,
+                            size_t len, void *payload)
+{
+    return similarity_signature(out, file, buf, len, NULL, payload);
+}
+
+static void
+similarity_free_signature(void *sig, void *payload)
+{
+    similarity_run *run = payload;
+    pgit_signature *signature = sig;
+
+    if (signature == NULL || signature == &similarity_exhausted_signature)
+        return;
+
+    if (run->cache) {
+        PyThread_acquire_lock(run->cache->lock, WAIT_LOCK);
+        signature_release(signature);
+        PyThread_release_lock(run->cache->lock);
+    } else {
+        signature_release(signature);
+    }
+}
+
+static int
+similarity_compare(int *score, void *siga, void *sigb, void *payload)
+{
+    similarity_run *run = payload;
+    pgit_signature *a = siga, *b = sigb;
+
+    *score = 0;
+    if (run->max_pairs && ++run->pairs > run->max_pairs)
+        run->exhausted = 1;
+    if (similarity_run_exhausted(run) || a->sig == NULL || b->sig == NULL)
+        return 0;
+
+    *score = git_hashsig_compare(a->sig, b->sig);
+    return *score < 0 ? *score : 0;
+}
+
+void
+similarity_run_init(similarity_run *run, SimilarityCache *cache, uint32_t flags,
+                    size_t max_pairs, double timeout)
+{
+    memset(run, 0, sizeof(*run));
+    run->metric.file_signature = similarity_file_signature;
+    run->metric.buffer_signature = similarity_buffer_signature;
+    run->metric.free_signature = similarity_free_signature;
+    run->metric.similarity = similarity_compare;
+    run->metric.payload = run;
+    run->cache = cache;
+    run->max_pairs = max_pairs;
+    run->deadline = timeout > 0 ? pgit_monotonic() + timeout : 0;
+
+    /* The same options as libgit2's own metric */
+    if (flags & GIT_DIFF_FIND_IGNORE_WHITESPACE)
+        run->options = GIT_HASHSIG_IGNORE_WHITESPACE;
+    else if (flags & GIT_DIFF_FIND_DONT_IGNORE_WHITESPACE)
+        run->options = GIT_HASHSIG_NORMAL;
+    else
+        run->options = GIT_HASHSIG_SMART_WHITESPACE;
+}
+
+
+/*
+ * SimilarityCache
+ */
+
+static void
+similarity_cache_clear(SimilarityCache *cache)
+{
+    PyThread_acquire_lock(cache->lock, WAIT_LOCK);
+    while (cache->oldest)
+        similarity_cache_evict(cache, cache->oldest);
+    cache->hits = 0;
+    cache->misses = 0;
+    PyThread_release_lock(cache->lock);
+}
+
+PyDoc_STRVAR(SimilarityCache_clear__doc__,
+  "clear()\n"
+  "\n"
+  "Drop all the signatures, and reset the counters.");
+
+PyObject *
+SimilarityCache_clear(SimilarityCache *self)
+{
+    if (self->lock)
+        similarity_cache_clear(self);
+    Py_RETURN_NONE;
+}
+
+int
+SimilarityCache_init(SimilarityCache *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"maxsize", NULL};
+    Py_ssize_t maxsize = 4096;
+    size_t nbuckets = SIMILARITY_CACHE_MIN_BUCKETS;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|n", keywords, &maxsize))
+        return -1;
+
+    if (maxsize < 1) {
+        PyErr_SetString(PyExc_ValueError, "maxsize must be at least 1");
+        return -1;
+    }
+
+    if (self->lock) {
+        PyErr_SetString(PyExc_RuntimeError, "SimilarityCache is already initialized");
+        return -1;
+    }
+
+    while (nbuckets < (size_t)maxsize)
+        nbuckets *= 2;
+
+    self->lock = PyThread_allocate_lock();
+    self->buckets = calloc(nbuckets, sizeof(pgit_signature *));
+    if (self->lock == NULL || self->buckets == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    self->mask = nbuckets - 1;
+    self->maxsize = maxsize;
+    return 0;
+}
+
+void
+SimilarityCache_dealloc(SimilarityCache *self)
+{
+    if (self->lock) {
+        similarity_cache_clear(self);
+        PyThread_free_lock(self->lock);
+    }
+    free(self->buckets);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+Py_ssize_t
+SimilarityCache_len(SimilarityCache *self)
+{
+    return self->size;
+}
+
+PyMethodDef SimilarityCache_methods[] = {
+    METHOD(SimilarityCache, clear, METH_NOARGS),
+    {NULL}
+};
+
+PyMemberDef SimilarityCache_members[] = {
+    RMEMBER(SimilarityCache, maxsize, T_PYSSIZET, "Maximum number of signatures kept."),
+    RMEMBER(SimilarityCache, hits, T_PYSSIZET, "Number of signatures found in the cache."),
+    RMEMBER(SimilarityCache, misses, T_PYSSIZET, "Number of signatures computed."),
+    {NULL}
+};
+
+PySequenceMethods SimilarityCache_as_sequence = {
+    (lenfunc)SimilarityCache_len,   /* sq_length */
+    0,                              /* sq_concat */
+    0,                              /* sq_repeat */
+    0,                              /* sq_item */
+    0,                              /* sq_slice */
+    0,                              /* sq_ass_item */
+    0,                              /* sq_ass_slice */
+    0,                              /* sq_contains */
+};
+
+PyDoc_STRVAR(SimilarityCache__doc__,
+  "SimilarityCache(maxsize: int = 4096)\n"
+  "\n"
+  "Least recently used cache of the similarity signatures of blobs, used\n"
+  "by `Diff.find_similar()` to detect renames and copies. Computing the\n"
+  "signatures is most of the work of rename detection, and the same blobs\n"
+  "come again in diffs of nearby commits. Set it as the\n"
+  "`similarity_cache` of a repository, or pass it to `find_similar()`.\n"
+  "It may be shared by threads.");
+
+PyTypeObject SimilarityCacheType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.SimilarityCache",                 /* tp_name           */
+    sizeof(SimilarityCache),                   /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)SimilarityCache_dealloc,       /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    &SimilarityCache_as_sequence,              /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    0,                                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    SimilarityCache__doc__,                    /* tp_doc            */
+    0,                                         /* tp_traverse       */
+    0,                                         /* tp_clear          */
+    0,                                         /* tp_richcompare    */
+    0,                                         /* tp_weaklistoffset */
+    0,                                         /* tp_iter           */
+    0,                                         /* tp_iternext       */
+    SimilarityCache_methods,                   /* tp_methods        */
+    SimilarityCache_members,                   /* tp_members        */
+    0,                                         /* tp_getset         */
+    0,                                         /* tp_base           */
+    0,                                         /* tp_dict           */
+    0,                                         /* tp_descr_get      */
+    0,                                         /* tp_descr_set      */
+    0,                                         /* tp_dictoffset     */
+    (initproc)SimilarityCache_init,            /* tp_init           */
+    0,                                         /* tp_alloc          */
+    0,                                         /* tp_new            */
+};
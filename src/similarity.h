@@ -0,0 +1,55 @@
+/*
+ * Copyright 2010-2026 The pygit2 contributors
+ *
+ * This file is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License, version 2,
+ * as published by the Free Software Foundation.
+ *
+ * In addition to the permissions in the GNU General Public License,
+ * the authors give you unlimited permission to link the compiled
+ * version of this file into combinations with other programs,
+ * and to distribute those combinations without any restriction
+ * coming from the use of this file.  (The General Public License
+ * restrictions do apply in other respects; for example, they cover
+ * modification of the file, and distribution when not linked into
+ * a combined executable.)
+ *
+ * This file is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDE_pygit2_similarity_h
+#define INCLUDE_pygit2_similarity_h
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <git2.h>
+#include "types.h"
+
+/*
+ * A similarity metric for git_diff_find_similar, with the signatures of
+ * the blobs taken from a cache (when not NULL), and a budget: once
+ * max_pairs pairs of files have been compared, or the deadline has passed,
+ * the remaining files only match when their ids are the same.
+ */
+typedef struct {
+    git_diff_similarity_metric metric;
+    SimilarityCache *cache;
+    int options;                /* git_hashsig_option_t */
+    size_t max_pairs;           /* 0 for no limit */
+    double deadline;            /* 0 for no limit */
+    size_t pairs;
+    int exhausted;
+} similarity_run;
+
+void similarity_run_init(similarity_run *run, SimilarityCache *cache, uint32_t flags,
+                         size_t max_pairs, double timeout);
+
+#endif
@@ -27,6 +27,7 @@
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
+#include <git2/sys/errors.h>
 #include <string.h>
 #include "error.h"
 #include "utils.h"
@@ -35,6 +36,8 @@
 #include "oid.h"
 #include "tree.h"
 #include "diff.h"
+#include "odb.h"
+#include "wildmatch.h"
 
 extern PyTypeObject TreeType;
 extern PyTypeObject DiffType;
@@ -203,6 +206,228 @@ Tree_divide(Tree *self, PyObject *value)
 }
 
 
+/*
+ * Tree.lookup_paths: the paths are sorted, so paths in the same directory
+ * come together, and the trees of the current directory are kept on a
+ * stack. Every subtree is then read once, however many paths it has.
+ */
+typedef struct {
+    const char *path;
+    size_t index;
+} tree_lookup_path;
+
+typedef struct {
+    git_repository *repo;
+    const git_tree *root;
+    git_tree **trees;           /* trees[0] is the root, not owned */
+    size_t *ends;               /* Where the directory of trees[i] ends */
+    size_t depth;
+    size_t alloc;
+    const char *dir;            /* A path in the current directory */
+    char *name;                 /* A component of the path, NUL terminated */
+    git_oid *ids;
+    uint32_t *modes;
+    char *found;
+    int nomem;
+} tree_lookup;
+
+static int
+tree_lookup_path_cmp(const void *a, const void *b)
+{
+    return strcmp(((const tree_lookup_path *)a)->path, ((const tree_lookup_path *)b)->path);
+}
+
+static int
+tree_lookup_push(tree_lookup *l, git_tree *tree, size_t end)
+{
+    git_tree **trees;
+    size_t *ends, alloc;
+
+    if (l->depth + 1 == l->alloc) {
+        alloc = l->alloc * 2;
+        trees = realloc(l->trees, alloc * sizeof(*trees));
+        if (trees == NULL)
+            goto nomem;
+        l->trees = trees;
+        ends = realloc(l->ends, alloc * sizeof(*ends));
+        if (ends == NULL)
+            goto nomem;
+        l->ends = ends;
+        l->alloc = alloc;
+    }
+
+    l->depth++;
+    l->trees[l->depth] = tree;
+    l->ends[l->depth] = end;
+    return 0;
+
+nomem:
+    git_tree_free(tree);
+    l->nomem = 1;
+    return -1;
+}
+
+/* Look up one path, the result is left in l->ids, l->modes and l->found */
+static int
+tree_lookup_path_run(tree_lookup *l, const char *path, size_t index)
+{
+    const git_tree_entry *entry;
+    const char *slash;
+    git_tree *tree;
+    size_t pos, len;
+    int err;
+
+    /* Leave the directories the path is not in */
+    while (l->depth > 0 && strncmp(path, l->dir, l->ends[l->depth]) != 0)
+        git_tree_free(l->trees[l->depth--]);
+    l->dir = path;
+
+    for (pos = l->ends[l->depth]; ; pos = slash - path + 1) {
+        slash = strchr(path + pos, '/');
+        len = slash ? (size_t)(slash - path) - pos : strlen(path + pos);
+        if (len == 0)
+            return 0;
+
+        memcpy(l->name, path + pos, len);
+        l->name[len] = '\0';
+        entry = git_tree_entry_byname(l->trees[l->depth], l->name);
+        if (entry == NULL)
+            return 0;
+
+        if (slash == NULL) {
+            git_oid_cpy(&l->ids[index], git_tree_entry_id(entry));
+            l->modes[index] = (uint32_t)git_tree_entry_filemode(entry);
+            l->found[index] = 1;
+            return 0;
+        }
+
+        if (git_tree_entry_type(entry) != GIT_OBJECT_TREE)
+            return 0;
+
+        err = git_tree_lookup(&tree, l->repo, git_tree_entry_id(entry));
+        if (err < 0)
+            return err;
+        if (tree_lookup_push(l, tree, (size_t)(slash - path) + 1) < 0)
+            return -1;
+    }
+}
+
+PyDoc_STRVAR(Tree_lookup_paths__doc__,
+  "lookup_paths(paths: Iterable[str | bytes]) -> list[tuple[Oid, int] | None]\n"
+  "\n"
+  "Look up many paths at once, and return for each the `(oid, filemode)`\n"
+  "of its entry, or None if there is none. This is much faster than\n"
+  "looking them up one by one, as the subtrees shared by the paths are\n"
+  "only read once. The trees are read without the GIL, unless the object\n"
+  "database has a backend implemented in Python.\n"
+  "\n"
+  "Example::\n"
+  "\n"
+  "  >>> tree.lookup_paths(['README.md', 'src/main.c', 'missing'])\n"
+  "  [(<pygit2.Oid ...>, 33188), (<pygit2.Oid ...>, 33188), None]\n");
+
+PyObject *
+Tree_lookup_paths(Tree *self, PyObject *py_paths)
+{
+    tree_lookup l;
+    tree_lookup_path *sorted = NULL;
+    git_strarray paths = {NULL, 0};
+    PyObject *result = NULL, *item, *py_id;
+    size_t i, n, max_len = 0;
+    int err = 0;
+
+    if (Object__load((Object*)self) == NULL) { return NULL; } // Lazy load
+
+    if (PyUnicode_Check(py_paths) || PyBytes_Check(py_paths)) {
+        PyErr_SetString(PyExc_TypeError, "paths must be an iterable of paths");
+        return NULL;
+    }
+    if (py_paths_to_git_strarray(py_paths, &paths) < 0)
+        return NULL;
+
+    memset(&l, 0, sizeof(l));
+    n = paths.count;
+    for (i = 0; i < n; i++) {
+        size_t len = strlen(paths.strings[i]);
+        if (len > max_len)
+            max_len = len;
+    }
+
+    l.repo = self->repo->repo;
+    l.alloc = 16;
+    l.trees = malloc(l.alloc * sizeof(*l.trees));
+    l.ends = malloc(l.alloc * sizeof(*l.ends));
+    l.name = malloc(max_len + 1);
+    l.ids = malloc((n ? n : 1) * sizeof(git_oid));
+    l.modes = malloc((n ? n : 1) * sizeof(uint32_t));
+    l.found = calloc(n ? n : 1, 1);
+    sorted = malloc((n ? n : 1) * sizeof(*sorted));
+    if (l.trees == NULL || l.ends == NULL || l.name == NULL || l.ids == NULL ||
+        l.modes == NULL || l.found == NULL || sorted == NULL) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+    l.trees[0] = self->tree;
+    l.ends[0] = 0;
+
+    for (i = 0; i < n; i++) {
+        sorted[i].path = paths.strings[i];
+        sorted[i].index = i;
+    }
+
+    PGIT_BEGIN_ALLOW_THREADS_IF(repository_odb_allows_threads(l.repo))
+    qsort(sorted, n, sizeof(*sorted), tree_lookup_path_cmp);
+    for (i = 0; i < n && err == 0; i++)
+        err = tree_lookup_path_run(&l, sorted[i].path, sorted[i].index);
+    while (l.depth > 0)
+        git_tree_free(l.trees[l.depth--]);
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (l.nomem) {
+        PyErr_NoMemory();
+        goto exit;
+    }
+    if (err < 0) {
+        Error_set(err);
+        goto exit;
+    }
+
+    result = PyList_New(n);
+    if (result == NULL)
+        goto exit;
+
+    for (i = 0; i < n; i++) {
+        if (!l.found[i]) {
+            Py_INCREF(Py_None);
+            PyList_SET_ITEM(result, i, Py_None);
+            continue;
+        }
+
+        py_id = git_oid_to_python(&l.ids[i]);
+        if (py_id == NULL)
+            goto error;
+        item = Py_BuildValue("(Nk)", py_id, (unsigned long)l.modes[i]);
+        if (item == NULL)
+            goto error;
+        PyList_SET_ITEM(result, i, item);
+    }
+    goto exit;
+
+error:
+    Py_CLEAR(result);
+exit:
+    pgit_strarray_free(&paths);
+    free(sorted);
+    free(l.trees);
+    free(l.ends);
+    free(l.name);
+    free(l.ids);
+    free(l.modes);
+    free(l.found);
+    return result;
+}
+
+
 PyDoc_STRVAR(Tree_diff_to_workdir__doc__,
   "diff_to_workdir(flags: enums.DiffOption = enums.DiffOption.NORMAL, context_lines: int = 3, interhunk_lines: int = 0) -> Diff\n"
   "\n"
@@ -236,7 +461,9 @@ Tree_diff_to_workdir(Tree *self, PyObject *args, PyObject *kwds)
 
     if (Object__load((Object*)self) == NULL) { return NULL; } // Lazy load
 
+    PGIT_BEGIN_ALLOW_THREADS_IF(repository_odb_allows_threads(self->repo->repo))
     err = git_diff_tree_to_workdir(&diff, self->repo->repo, self->tree, &opts);
+    PGIT_END_ALLOW_THREADS_IF
     if (err < 0)
         return Error_set(err);
 
@@ -310,7 +537,9 @@ Tree_diff_to_index(Tree *self, PyObject *args, PyObject *kwds)
     /* Call git_diff_tree_to_index */
     if (Object__load((Object*)self) == NULL) { goto error; } // Lazy load
 
+    PGIT_BEGIN_ALLOW_THREADS_IF(repository_odb_allows_threads(self->repo->repo))
     err = git_diff_tree_to_index(&diff, self->repo->repo, self->tree, index, &opts);
+    PGIT_END_ALLOW_THREADS_IF
     Py_DECREF(py_idx_ptr);
 
     if (err < 0)
@@ -380,7 +609,9 @@ Tree_diff_to_tree(Tree *self, PyObject *args, PyObject *kwds)
         to = tmp;
     }
 
+    PGIT_BEGIN_ALLOW_THREADS_IF(repository_odb_allows_threads(self->repo->repo))
     err = git_diff_tree_to_tree(&diff, self->repo->repo, from, to, &opts);
+    PGIT_END_ALLOW_THREADS_IF
     if (err < 0)
         return Error_set(err);
 
@@ -388,6 +619,1200 @@ Tree_diff_to_tree(Tree *self, PyObject *args, PyObject *kwds)
 }
 
 
+/*
+ * Tree.walk: the tree is walked depth first, without the GIL unless the
+ * object database has Python backends, and the entries are gathered into
+ * flat buffers. The Python objects are only built at the end.
+ */
+typedef struct {
+    pgit_buffer paths;          /* Paths of the entries, concatenated */
+    pgit_buffer offsets;        /* int64, 0 then where every path ends */
+    pgit_buffer modes;          /* uint32 */
+    pgit_buffer ids;            /* Raw ids */
+} tree_walk_entries;
+
+typedef struct {
+    git_strarray patterns;
+    size_t *pattern_lens;       /* Without trailing slashes */
+    size_t *literal_lens;       /* Up to the first wildcard */
+} tree_walk_pathspec;
+
+typedef struct tree_walk tree_walk;
+struct tree_walk {
+    git_repository *repo;
+    int mode;                   /* GIT_TREEWALK_PRE or GIT_TREEWALK_POST */
+    int include_blobs;
+    const tree_walk_pathspec *pathspec; /* NULL means everything */
+    pgit_buffer path;           /* Path of the current entry */
+    tree_walk_entries *entries;
+    /* Called to walk subtrees instead of tree_walk_subtree, if set */
+    int (*descend)(tree_walk *w, const git_tree_entry *entry, size_t len, int covered);
+    void *payload;
+    int nomem;
+};
+
+static int
+tree_walk_entries_init(tree_walk_entries *entries)
+{
+    int64_t zero = 0;
+
+    memset(entries, 0, sizeof(*entries));
+    return pgit_buffer_append(&entries->offsets, &zero, sizeof(zero));
+}
+
+static void
+tree_walk_entries_free(tree_walk_entries *entries)
+{
+    free(entries->paths.data);
+    free(entries->offsets.data);
+    free(entries->modes.data);
+    free(entries->ids.data);
+}
+
+/* Append the entries of src to dst, returns -1 on out of memory */
+static int
+tree_walk_entries_extend(tree_walk_entries *dst, const tree_walk_entries *src)
+{
+    const int64_t *offsets = (const int64_t *)src->offsets.data;
+    size_t i, n = src->modes.size / sizeof(uint32_t);
+    int64_t offset, base = (int64_t)dst->paths.size;
+
+    for (i = 1; i <= n; i++) {
+        offset = base + offsets[i];
+        if (pgit_buffer_append(&dst->offsets, &offset, sizeof(offset)) < 0)
+            return -1;
+    }
+
+    if (pgit_buffer_append(&dst->paths, src->paths.data, src->paths.size) < 0 ||
+        pgit_buffer_append(&dst->modes, src->modes.data, src->modes.size) < 0 ||
+        pgit_buffer_append(&dst->ids, src->ids.data, src->ids.size) < 0)
+        return -1;
+
+    return 0;
+}
+
+/* Read the patterns, returns -1 with an exception set on failure */
+static int
+tree_walk_pathspec_init(tree_walk_pathspec *spec, PyObject *py_pathspec)
+{
+    const char *pattern;
+    size_t i, len;
+
+    memset(spec, 0, sizeof(*spec));
+    if (py_paths_to_git_strarray(py_pathspec, &spec->patterns) < 0)
+        return -1;
+
+    spec->pattern_lens = PyMem_Malloc((spec->patterns.count + 1) * sizeof(size_t));
+    spec->literal_lens = PyMem_Malloc((spec->patterns.count + 1) * sizeof(size_t));
+    if (spec->pattern_lens == NULL || spec->literal_lens == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (i = 0; i < spec->patterns.count; i++) {
+        pattern = spec->patterns.strings[i];
+        len = strlen(pattern);
+        while (len > 0 && pattern[len - 1] == '/')
+            len--;
+        spec->pattern_lens[i] = len;
+        spec->literal_lens[i] = strcspn(pattern, "*?[\\");
+    }
+    return 0;
+}
+
+static void
+tree_walk_pathspec_free(tree_walk_pathspec *spec)
+{
+    pgit_strarray_free(&spec->patterns);
+    PyMem_Free(spec->pattern_lens);
+    PyMem_Free(spec->literal_lens);
+}
+
+/* Whether path is matched by a pattern, or is inside a matched directory */
+static int
+tree_walk_matches(const tree_walk *w, const char *path, size_t len)
+{
+    size_t i, n;
+
+    if (w->pathspec == NULL)
+        return 1;
+
+    for (i = 0; i < w->pathspec->patterns.count; i++) {
+        n = w->pathspec->pattern_lens[i];
+        if (len > n && path[n] == '/' &&
+            strncmp(path, w->pathspec->patterns.strings[i], n) == 0)
+            return 1;
+        if (wildmatch(w->pathspec->patterns.strings[i], path, 0) == WM_MATCH)
+            return 1;
+    }
+
+    return 0;
+}
+
+/* Whether entries in directory dir may be matched, so it must be walked */
+static int
+tree_walk_may_contain(const tree_walk *w, const char *dir, size_t len)
+{
+    const char *pattern;
+    size_t i, n;
+
+    for (i = 0; i < w->pathspec->patterns.count; i++) {
+        pattern = w->pathspec->patterns.strings[i];
+        n = w->pathspec->literal_lens[i];
+        /* Either the pattern goes below dir/, or its wildcards start in it */
+        if (strncmp(dir, pattern, n < len ? n : len) == 0 &&
+            (n <= len || pattern[len] == '/'))
+            return 1;
+    }
+
+    return 0;
+}
+
+static int
+tree_walk_emit(tree_walk *w, size_t len, const git_tree_entry *entry)
+{
+    tree_walk_entries *entries = w->entries;
+    int64_t offset;
+    uint32_t mode = (uint32_t)git_tree_entry_filemode(entry);
+
+    if (pgit_buffer_append(&entries->paths, w->path.data, len) < 0)
+        return -1;
+
+    offset = (int64_t)entries->paths.size;
+    if (pgit_buffer_append(&entries->offsets, &offset, sizeof(offset)) < 0 ||
+        pgit_buffer_append(&entries->modes, &mode, sizeof(mode)) < 0 ||
+        pgit_buffer_append(&entries->ids, git_tree_entry_id(entry)->id, GIT_OID_RAWSZ) < 0)
+        return -1;
+
+    return 0;
+}
+
+static int tree_walk_tree(tree_walk *w, const git_tree *tree, int covered);
+
+/* Walk the subtree entry, whose path is the first len bytes of w->path */
+static int
+tree_walk_subtree(tree_walk *w, const git_tree_entry *entry, size_t len, int covered)
+{
+    git_tree *subtree;
+    int err;
+
+    err = git_tree_lookup(&subtree, w->repo, git_tree_entry_id(entry));
+    if (err < 0)
+        return err;
+
+    w->path.data[len] = '/';
+    err = tree_walk_tree(w, subtree, covered);
+    git_tree_free(subtree);
+    w->path.size = len + 1;
+    w->path.data[len] = '\0';
+    return err;
+}
+
+/* Walk the entries of tree, whose path (with a trailing slash) is in w->path */
+static int
+tree_walk_tree(tree_walk *w, const git_tree *tree, int covered)
+{
+    const git_tree_entry *entry;
+    const char *name;
+    size_t i, n, len, base = w->path.size;
+    int is_tree, match, emit, err;
+
+    n = git_tree_entrycount(tree);
+    for (i = 0; i < n; i++) {
+        entry = git_tree_entry_byindex(tree, i);
+        name = git_tree_entry_name(entry);
+        is_tree = git_tree_entry_type(entry) == GIT_OBJECT_TREE;
+
+        w->path.size = base;
+        if (pgit_buffer_append(&w->path, name, strlen(name) + 1) < 0)
+            goto nomem;
+        len = w->path.size - 1;
+
+        match = covered || tree_walk_matches(w, w->path.data, len);
+        emit = match && (is_tree || w->include_blobs);
+
+        if (emit && w->mode == GIT_TREEWALK_PRE && tree_walk_emit(w, len, entry) < 0)
+            goto nomem;
+
+        if (is_tree && (match || tree_walk_may_contain(w, w->path.data, len))) {
+            if (w->descend)
+                err = w->descend(w, entry, len, match);
+            else
+                err = tree_walk_subtree(w, entry, len, match);
+            if (err < 0)
+                return err;
+        }
+
+        if (emit && w->mode == GIT_TREEWALK_POST && tree_walk_emit(w, len, entry) < 0)
+            goto nomem;
+    }
+
+    w->path.size = base;
+    return 0;
+
+nomem:
+    w->nomem = 1;
+    return -1;
+}
+
+/*
+ * Parallel walk. The top of the tree is walked first, down to a depth
+ * where there are enough subtrees to keep the threads busy, giving a
+ * sequence of segments: entries already listed, and subtrees to walk. The
+ * threads take the subtrees one at a time from a shared counter, each
+ * with its own repository handle, and finally the segments are concatenated
+ * in order, which gives the same result as a serial walk. Without handles of
+ * their own there are no extra threads, the walk is serial.
+ */
+#define TREE_WALK_TREES_PER_THREAD 8
+#define TREE_WALK_MAX_SPLIT_DEPTH 6
+
+typedef struct {
+    tree_walk_entries entries;
+    int is_tree;
+    git_oid id;
+    int covered;
+    char *path;                 /* With a trailing slash */
+    size_t path_len;
+    int err;
+    int nomem;
+    char *err_msg;
+} tree_walk_segment;
+
+typedef struct {
+    tree_walk_segment **items;
+    size_t count;
+    size_t alloc;
+    size_t ntrees;
+    size_t depth;               /* Depth at which subtrees are split off */
+} tree_walk_segments;
+
+typedef struct {
+    const tree_walk *options;
+    tree_walk_segment **trees;
+    long ntrees;
+    volatile long next;
+} tree_walk_worker;
+
+typedef struct {
+    tree_walk_worker *worker;
+    git_repository *repo;       /* Owned by this thread */
+    pgit_thread handle;
+} tree_walk_thread;
+
+static tree_walk_segment *
+tree_walk_segment_new(tree_walk_segments *segments)
+{
+    tree_walk_segment *segment, **items;
+
+    if (segments->count == segments->alloc) {
+        size_t alloc = segments->alloc ? segments->alloc * 2 : 64;
+        items = realloc(segments->items, alloc * sizeof(*items));
+        if (items == NULL)
+            return NULL;
+        segments->items = items;
+        segments->alloc = alloc;
+    }
+
+    segment = calloc(1, sizeof(*segment));
+    if (segment == NULL)
+        return NULL;
+    if (tree_walk_entries_init(&segment->entries) < 0) {
+        free(segment);
+        return NULL;
+    }
+
+    segments->items[segments->count++] = segment;
+    return segment;
+}
+
+static void
+tree_walk_segments_free(tree_walk_segments *segments)
+{
+    tree_walk_segment *segment;
+    size_t i;
+
+    for (i = 0; i < segments->count; i++) {
+        segment = segments->items[i];
+        tree_walk_entries_free(&segment->entries);
+        free(segment->path);
+        free(segment->err_msg);
+        free(segment);
+    }
+    free(segments->items);
+    memset(segments, 0, sizeof(*segments));
+}
+
+/* Descend callback: walk the top levels, and split off the deeper trees */
+static int
+tree_walk_split(tree_walk *w, const git_tree_entry *entry, size_t len, int covered)
+{
+    tree_walk_segments *segments = w->payload;
+    tree_walk_segment *tree, *next;
+    size_t i, depth = 1;
+
+    for (i = 0; i < len; i++)
+        depth += w->path.data[i] == '/';
+    if (depth < segments->depth)
+        return tree_walk_subtree(w, entry, len, covered);
+
+    tree = tree_walk_segment_new(segments);
+    if (tree == NULL)
+        goto nomem;
+
+    tree->is_tree = 1;
+    git_oid_cpy(&tree->id, git_tree_entry_id(entry));
+    tree->covered = covered;
+    tree->path_len = len + 1;
+    tree->path = malloc(len + 2);
+    if (tree->path == NULL)
+        goto nomem;
+    memcpy(tree->path, w->path.data, len);
+    tree->path[len] = '/';
+    tree->path[len + 1] = '\0';
+    segments->ntrees++;
+
+    next = tree_walk_segment_new(segments);
+    if (next == NULL)
+        goto nomem;
+    w->entries = &next->entries;
+    return 0;
+
+nomem:
+    w->nomem = 1;
+    return -1;
+}
+
+/* Walk a subtree split off into its segment */
+static void
+tree_walk_segment_walk(const tree_walk *options, git_repository *repo,
+                       tree_walk_segment *segment)
+{
+    tree_walk w = *options;
+    git_tree *tree;
+    const git_error *error;
+    int err;
+
+    w.repo = repo;
+    w.entries = &segment->entries;
+    w.descend = NULL;
+    memset(&w.path, 0, sizeof(w.path));
+    if (pgit_buffer_append(&w.path, segment->path, segment->path_len + 1) < 0) {
+        segment->err = -1;
+        segment->nomem = 1;
+        return;
+    }
+    w.path.size = segment->path_len;
+
+    err = git_tree_lookup(&tree, repo, &segment->id);
+    if (err == 0) {
+        err = tree_walk_tree(&w, tree, segment->covered);
+        git_tree_free(tree);
+    }
+    free(w.path.data);
+
+    if (err < 0) {
+        /* Error messages are per thread, keep ours for the caller */
+        error = git_error_last();
+        segment->err = err;
+        segment->nomem = w.nomem;
+        segment->err_msg = strdup(error && error->message ? error->message : "");
+    }
+}
+
+static void
+tree_walk_worker_run(tree_walk_worker *worker, git_repository *repo)
+{
+    long i;
+
+    while ((i = pgit_atomic_fetch_inc(&worker->next)) < worker->ntrees)
+        tree_walk_segment_walk(worker->options, repo, worker->trees[i]);
+}
+
+static void
+tree_walk_thread_run(void *payload)
+{
+    tree_walk_thread *thread = payload;
+
+    tree_walk_worker_run(thread->worker, thread->repo);
+}
+
+/* Split the walk of root at the given depth, into segments */
+static int
+tree_walk_split_at(tree_walk *w, const git_tree *root, size_t depth,
+                   tree_walk_segments *segments)
+{
+    tree_walk_entries *entries = w->entries;
+    tree_walk_segment *segment;
+    int err;
+
+    tree_walk_segments_free(segments);
+    segments->depth = depth;
+    segment = tree_walk_segment_new(segments);
+    if (segment == NULL) {
+        w->nomem = 1;
+        return -1;
+    }
+
+    w->entries = &segment->entries;
+    w->descend = tree_walk_split;
+    w->payload = segments;
+    w->path.size = 0;
+    err = tree_walk_tree(w, root, 0);
+    w->entries = entries;
+    w->descend = NULL;
+    w->payload = NULL;
+    return err;
+}
+
+static int
+tree_walk_parallel(tree_walk *w, const git_tree *root, int threads)
+{
+    tree_walk_segments segments = {NULL, 0, 0, 0, 0};
+    tree_walk_segment *segment, **trees = NULL;
+    tree_walk_worker worker;
+    tree_walk_thread *pool = NULL;
+    size_t i, k, depth, opened = 0, started = 0, ntrees = 0;
+    int nthreads, err;
+
+    /* Split deeper until there are enough subtrees, or no more */
+    for (depth = 1; depth <= TREE_WALK_MAX_SPLIT_DEPTH; depth++) {
+        err = tree_walk_split_at(w, root, depth, &segments);
+        if (err < 0)
+            goto exit;
+        if (segments.ntrees >= (size_t)threads * TREE_WALK_TREES_PER_THREAD ||
+            segments.ntrees <= ntrees)
+            break;
+        ntrees = segments.ntrees;
+    }
+
+    ntrees = segments.ntrees;
+    trees = malloc((ntrees ? ntrees : 1) * sizeof(*trees));
+    if (trees == NULL)
+        goto nomem;
+    for (i = 0, k = 0; i < segments.count; i++) {
+        if (segments.items[i]->is_tree)
+            trees[k++] = segments.items[i];
+    }
+
+    worker.options = w;
+    worker.trees = trees;
+    worker.ntrees = (long)ntrees;
+    worker.next = 0;
+
+    /*
+     * The calling thread is a worker too, with the shared handle. Handles
+     * are opened here, a thread is only started with one of its own.
+     */
+    nthreads = (size_t)threads < ntrees ? threads : (int)ntrees;
+    if (nthreads > 1) {
+        pool = malloc((nthreads - 1) * sizeof(*pool));
+        if (pool == NULL)
+            goto nomem;
+    }
+    for (i = 0; i + 1 < (size_t)nthreads; i++) {
+        pool[i].worker = &worker;
+        pool[i].repo = repository_open_thread_handle(w->repo);
+        if (pool[i].repo == NULL)
+            break;
+        opened++;
+    }
+    for (i = 0; i < opened; i++) {
+        if (pgit_thread_start(&pool[i].handle, tree_walk_thread_run,
+                              &pool[i]) < 0)
+            break;
+        started++;
+    }
+    if (ntrees > 0)
+        tree_walk_worker_run(&worker, w->repo);
+    for (i = 0; i < started; i++)
+        pgit_thread_join(&pool[i].handle);
+    for (i = 0; i < opened; i++)
+        git_repository_free(pool[i].repo);
+
+    /* Report the first error, as a serial walk would */
+    for (i = 0; i < ntrees; i++) {
+        segment = trees[i];
+        if (segment->err < 0) {
+            err = segment->err;
+            w->nomem = segment->nomem;
+            if (!segment->nomem)
+                git_error_set_str(GIT_ERROR_INVALID, segment->err_msg);
+            goto exit;
+        }
+    }
+
+    for (i = 0; i < segments.count; i++) {
+        if (tree_walk_entries_extend(w->entries, &segments.items[i]->entries) < 0)
+            goto nomem;
+    }
+    err = 0;
+    goto exit;
+
+nomem:
+    w->nomem = 1;
+    err = -1;
+exit:
+    free(pool);
+    free(trees);
+    tree_walk_segments_free(&segments);
+    return err;
+}
+
+/*
+ * Set up a walk from the repository, with the given pathspec (may be None).
+ * Returns -1 with an exception set on failure, in any case the walk must
+ * be freed with tree_walk_clear.
+ */
+static int
+tree_walk_init(tree_walk *w, tree_walk_entries *entries, tree_walk_pathspec *pathspec,
+               git_repository *repo, PyObject *py_pathspec)
+{
+    memset(w, 0, sizeof(*w));
+    memset(pathspec, 0, sizeof(*pathspec));
+    w->repo = repo;
+    w->mode = GIT_TREEWALK_PRE;
+    w->include_blobs = 1;
+    w->entries = entries;
+
+    if (tree_walk_entries_init(entries) < 0 || pgit_buffer_append(&w->path, "", 1) < 0) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    w->path.size = 0;
+
+    if (py_pathspec != Py_None) {
+        if (tree_walk_pathspec_init(pathspec, py_pathspec) < 0)
+            return -1;
+        /* An empty pathspec means everything */
+        if (pathspec->patterns.count > 0)
+            w->pathspec = pathspec;
+    }
+
+    return 0;
+}
+
+static void
+tree_walk_clear(tree_walk *w, tree_walk_entries *entries, tree_walk_pathspec *pathspec)
+{
+    tree_walk_pathspec_free(pathspec);
+    tree_walk_entries_free(entries);
+    free(w->path.data);
+}
+
+static PyObject *
+tree_walk_result(tree_walk_entries *entries, int columns)
+{
+    PyObject *result, *item, *py_path, *py_id;
+    const int64_t *offsets = (const int64_t *)entries->offsets.data;
+    const uint32_t *modes = (const uint32_t *)entries->modes.data;
+    git_oid oid;
+    size_t i, n = entries->modes.size / sizeof(uint32_t);
+    static const struct {
+        const char *name;
+        const char *format;
+    } names[3] = {{"path_offsets", "q"}, {"mode", "I"}, {"id", "B"}};
+    pgit_buffer *bufs[3] = {&entries->offsets, &entries->modes, &entries->ids};
+
+    if (columns) {
+        result = PyDict_New();
+        if (result == NULL)
+            return NULL;
+
+        item = PyBytes_FromStringAndSize(entries->paths.data, entries->paths.size);
+        if (item == NULL || PyDict_SetItemString(result, "path", item) < 0)
+            goto error;
+        Py_DECREF(item);
+
+        for (i = 0; i < 3; i++) {
+            item = pgit_buffer_to_memoryview(bufs[i], names[i].format);
+            if (item == NULL || PyDict_SetItemString(result, names[i].name, item) < 0)
+                goto error;
+            Py_DECREF(item);
+        }
+        return result;
+    }
+
+    result = PyList_New(n);
+    if (result == NULL)
+        return NULL;
+
+    for (i = 0; i < n; i++) {
+        py_path = PyBytes_FromStringAndSize(entries->paths.data + offsets[i],
+                                            offsets[i + 1] - offsets[i]);
+        git_oid_fromraw(&oid, (const unsigned char *)entries->ids.data + i * GIT_OID_RAWSZ);
+        py_id = git_oid_to_python(&oid);
+        if (py_path == NULL || py_id == NULL) {
+            Py_XDECREF(py_path);
+            Py_XDECREF(py_id);
+            Py_DECREF(result);
+            return NULL;
+        }
+
+        item = Py_BuildValue("(NkN)", py_path, (unsigned long)modes[i], py_id);
+        if (item == NULL) {
+            Py_DECREF(result);
+            return NULL;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+    return result;
+
+error:
+    Py_XDECREF(item);
+    Py_DECREF(result);
+    return NULL;
+}
+
+PyDoc_STRVAR(Tree_walk__doc__,
+  "walk(mode: enums.TreeWalkMode = enums.TreeWalkMode.PRE, include_blobs: bool = True, pathspec: str | bytes | Iterable[str | bytes] | None = None, columns: bool = False, threads: int = 1) -> list[tuple[bytes, int, Oid]] | dict[str, bytes | memoryview]\n"
+  "\n"
+  "Walk the tree recursively and return all its entries, as\n"
+  "`(path, mode, oid)` tuples where path is relative to this tree, in bytes.\n"
+  "The trees are read and walked without the GIL, unless the object\n"
+  "database has a backend implemented in Python.\n"
+  "\n"
+  "Parameters:\n"
+  "\n"
+  "mode\n"
+  "    With TreeWalkMode.PRE (the default) trees come before their\n"
+  "    entries, with TreeWalkMode.POST they come after.\n"
+  "\n"
+  "include_blobs\n"
+  "    If False only the trees are returned.\n"
+  "\n"
+  "pathspec\n"
+  "    Patterns restricting the entries returned, as in `git ls-tree`: an\n"
+  "    entry is returned if a pattern matches its path (wildcards match\n"
+  "    slashes) or the path of one of its parent trees. Trees which cannot\n"
+  "    contain a match are not read.\n"
+  "\n"
+  "columns\n"
+  "    If True, return a dictionary of flat columns instead: 'path', the\n"
+  "    paths concatenated (bytes), 'path_offsets' (format 'q'), where entry\n"
+  "    i's path is path[path_offsets[i]:path_offsets[i+1]], 'mode' (format\n"
+  "    'I') and 'id', the raw ids (format 'B', 20 bytes per entry).\n"
+  "\n"
+  "threads\n"
+  "    The number of native threads walking the subtrees, the result is\n"
+  "    the same whatever the number. Only one is used if the object\n"
+  "    database has a backend implemented in Python.\n"
+  "\n"
+  "Example::\n"
+  "\n"
+  "  >>> for path, mode, oid in tree.walk(pathspec='src/*.c'):\n"
+  "  ...     print(path.decode(), oid)\n");
+
+PyObject *
+Tree_walk(Tree *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"mode", "include_blobs", "pathspec", "columns", "threads", NULL};
+    tree_walk w;
+    tree_walk_entries entries;
+    tree_walk_pathspec pathspec;
+    PyObject *py_pathspec = Py_None, *result = NULL;
+    int include_blobs = 1, columns = 0, mode = GIT_TREEWALK_PRE, threads = 1;
+    int allow_threads, err;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|ipOpi", keywords,
+                                     &mode, &include_blobs, &py_pathspec, &columns,
+                                     &threads))
+        return NULL;
+
+    if (mode != GIT_TREEWALK_PRE && mode != GIT_TREEWALK_POST) {
+        PyErr_SetString(PyExc_ValueError, "mode must be TreeWalkMode.PRE or TreeWalkMode.POST");
+        return NULL;
+    }
+
+    if (threads < 1) {
+        PyErr_SetString(PyExc_ValueError, "threads must be at least 1");
+        return NULL;
+    }
+
+    if (Object__load((Object*)self) == NULL) { return NULL; } // Lazy load
+
+    if (tree_walk_init(&w, &entries, &pathspec, self->repo->repo, py_pathspec) < 0)
+        goto exit;
+    w.mode = mode;
+    w.include_blobs = include_blobs;
+
+    allow_threads = repository_odb_allows_threads(w.repo);
+    PGIT_BEGIN_ALLOW_THREADS_IF(allow_threads)
+    if (threads > 1 && allow_threads)
+        err = tree_walk_parallel(&w, self->tree, threads);
+    else
+        err = tree_walk_tree(&w, self->tree, 0);
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (w.nomem)
+        PyErr_NoMemory();
+    else if (err < 0)
+        Error_set(err);
+    else
+        result = tree_walk_result(&entries, columns);
+
+exit:
+    tree_walk_clear(&w, &entries, &pathspec);
+    return result;
+}
+
+/*
+ * Tree._grep: the blobs listed by a walk are searched for a literal by
+ * native threads, taking them one at a time from a shared counter. The
+ * lines found are kept per blob, so they come in the order of the walk.
+ * Tree._grep_lines is the same search with an empty literal, every line
+ * is kept.
+ */
+typedef struct {
+    pgit_buffer lines;          /* Matching lines, concatenated */
+    pgit_buffer ends;           /* int64, where every line ends */
+    pgit_buffer linenos;        /* int64, from 1 */
+    int err;
+    int nomem;
+    char *err_msg;
+} tree_grep_blob;
+
+typedef struct {
+    git_repository *repo;
+    const char *literal;        /* In lower case if ignore_case */
+    size_t literal_len;
+    int ignore_case;            /* Of ASCII letters, as re.IGNORECASE */
+    const tree_walk_entries *entries;
+    size_t *blobs;              /* Indexes of the blobs in the entries */
+    tree_grep_blob *results;
+    long nblobs;
+    volatile long next;
+    int nomem;
+} tree_grep;
+
+typedef struct {
+    tree_grep *grep;
+    git_repository *repo;       /* Owned by this thread */
+    pgit_thread handle;
+} tree_grep_thread;
+
+/* Find needle in the n bytes at s, memchr looks for the candidates */
+static const char *
+tree_grep_find(const char *s, size_t n, const char *needle, size_t len)
+{
+    const char *end = s + n, *p;
+
+    if (len == 0)
+        return s;
+
+    while ((size_t)(end - s) >= len) {
+        p = memchr(s, needle[0], (end - s) - len + 1);
+        if (p == NULL)
+            return NULL;
+        if (memcmp(p + 1, needle + 1, len - 1) == 0)
+            return p;
+        s = p + 1;
+    }
+
+    return NULL;
+}
+
+#define TREE_GREP_LOWER(c) ((c) >= 'A' && (c) <= 'Z' ? (c) - 'A' + 'a' : (c))
+
+/* As tree_grep_find, ignoring the case of ASCII letters, needle is lower case */
+static const char *
+tree_grep_find_icase(const char *s, size_t n, const char *needle, size_t len)
+{
+    const char *end = s + n;
+    size_t i;
+
+    for (; (size_t)(end - s) >= len; s++) {
+        for (i = 0; i < len && TREE_GREP_LOWER(s[i]) == needle[i]; i++)
+            ;
+        if (i == len)
+            return s;
+    }
+
+    return NULL;
+}
+
+/* Record the lines of data with the literal, returns -1 on out of memory */
+static int
+tree_grep_search(const tree_grep *g, const char *data, size_t size,
+                 tree_grep_blob *result)
+{
+    const char *end = data + size, *line = data, *match, *eol, *p;
+    int64_t lineno = 1, offset;
+
+    while (line < end) {
+        if (g->ignore_case)
+            match = tree_grep_find_icase(line, end - line, g->literal, g->literal_len);
+        else
+            match = tree_grep_find(line, end - line, g->literal, g->literal_len);
+        if (match == NULL)
+            break;
+
+        /* Count the lines skipped */
+        while ((p = memchr(line, '\n', match - line)) != NULL) {
+            line = p + 1;
+            lineno++;
+        }
+
+        eol = memchr(match, '\n', end - match);
+        if (eol == NULL)
+            eol = end;
+
+        if (pgit_buffer_append(&result->lines, line, eol - line) < 0)
+            return -1;
+        offset = (int64_t)result->lines.size;
+        if (pgit_buffer_append(&result->ends, &offset, sizeof(offset)) < 0 ||
+            pgit_buffer_append(&result->linenos, &lineno, sizeof(lineno)) < 0)
+            return -1;
+
+        if (eol == end)
+            break;
+        line = eol + 1;
+        lineno++;
+    }
+
+    return 0;
+}
+
+static void
+tree_grep_worker_run(tree_grep *g, git_repository *repo)
+{
+    const git_error *error;
+    tree_grep_blob *result;
+    git_blob *blob;
+    git_oid oid;
+    long i;
+    int err;
+
+    while ((i = pgit_atomic_fetch_inc(&g->next)) < g->nblobs) {
+        result = &g->results[i];
+        git_oid_fromraw(&oid, (const unsigned char *)g->entries->ids.data +
+                              g->blobs[i] * GIT_OID_RAWSZ);
+
+        err = git_blob_lookup(&blob, repo, &oid);
+        if (err == 0) {
+            if (!git_blob_is_binary(blob) &&
+                tree_grep_search(g, git_blob_rawcontent(blob),
+                                 (size_t)git_blob_rawsize(blob), result) < 0) {
+                result->nomem = 1;
+                err = -1;
+            }
+            git_blob_free(blob);
+        }
+
+        if (err < 0) {
+            result->err = err;
+            if (!result->nomem) {
+                /* Error messages are per thread, keep ours for the caller */
+                error = git_error_last();
+                result->err_msg = strdup(error && error->message ? error->message : "");
+            }
+        }
+    }
+}
+
+static void
+tree_grep_thread_run(void *payload)
+{
+    tree_grep_thread *thread = payload;
+
+    tree_grep_worker_run(thread->grep, thread->repo);
+}
+
+/* Search the blobs of the walk, returns the first error of the walk order */
+static int
+tree_grep_run(tree_grep *g, int threads)
+{
+    tree_grep_thread *pool = NULL;
+    tree_grep_blob *result;
+    long i, opened = 0, started = 0;
+
+    if (threads > g->nblobs)
+        threads = g->nblobs > 0 ? (int)g->nblobs : 1;
+
+    /* As in tree_walk_parallel, threads only run with a handle of their own */
+    if (threads > 1) {
+        pool = malloc((threads - 1) * sizeof(*pool));
+        if (pool == NULL)
+            threads = 1;
+    }
+    for (i = 0; i + 1 < threads; i++) {
+        pool[i].grep = g;
+        pool[i].repo = repository_open_thread_handle(g->repo);
+        if (pool[i].repo == NULL)
+            break;
+        opened++;
+    }
+    for (i = 0; i < opened; i++) {
+        if (pgit_thread_start(&pool[i].handle, tree_grep_thread_run, &pool[i]) < 0)
+            break;
+        started++;
+    }
+    tree_grep_worker_run(g, g->repo);
+    for (i = 0; i < started; i++)
+        pgit_thread_join(&pool[i].handle);
+    for (i = 0; i < opened; i++)
+        git_repository_free(pool[i].repo);
+    free(pool);
+
+    for (i = 0; i < g->nblobs; i++) {
+        result = &g->results[i];
+        if (result->err < 0) {
+            g->nomem = result->nomem;
+            if (!result->nomem)
+                git_error_set_str(GIT_ERROR_INVALID, result->err_msg);
+            return result->err;
+        }
+    }
+
+    return 0;
+}
+
+static PyObject *
+tree_grep_result(const tree_grep *g)
+{
+    const int64_t *paths = (const int64_t *)g->entries->offsets.data;
+    const int64_t *ends, *linenos;
+    const tree_grep_blob *blob;
+    PyObject *result, *item;
+    size_t k, n, path;
+    long i;
+    int64_t start;
+
+    result = PyList_New(0);
+    if (result == NULL)
+        return NULL;
+
+    for (i = 0; i < g->nblobs; i++) {
+        blob = &g->results[i];
+        ends = (const int64_t *)blob->ends.data;
+        linenos = (const int64_t *)blob->linenos.data;
+        n = blob->linenos.size / sizeof(int64_t);
+        path = g->blobs[i];
+
+        for (k = 0, start = 0; k < n; start = ends[k++]) {
+            item = Py_BuildValue("(y#Ly#)",
+                                 g->entries->paths.data + paths[path],
+                                 (Py_ssize_t)(paths[path + 1] - paths[path]),
+                                 (long long)linenos[k],
+                                 blob->lines.data + start,
+                                 (Py_ssize_t)(ends[k] - start));
+            if (item == NULL || PyList_Append(result, item) < 0) {
+                Py_XDECREF(item);
+                Py_DECREF(result);
+                return NULL;
+            }
+            Py_DECREF(item);
+        }
+    }
+
+    return result;
+}
+
+/* The lines of every blob, as (path, [line, ...]) */
+static PyObject *
+tree_grep_lines_result(const tree_grep *g)
+{
+    const int64_t *paths = (const int64_t *)g->entries->offsets.data;
+    const int64_t *ends;
+    const tree_grep_blob *blob;
+    PyObject *result, *lines, *line, *item;
+    size_t k, n, path;
+    long i;
+    int64_t start;
+
+    result = PyList_New(0);
+    if (result == NULL)
+        return NULL;
+
+    for (i = 0; i < g->nblobs; i++) {
+        blob = &g->results[i];
+        ends = (const int64_t *)blob->ends.data;
+        n = blob->ends.size / sizeof(int64_t);
+        path = g->blobs[i];
+
+        lines = PyList_New((Py_ssize_t)n);
+        if (lines == NULL)
+            goto error;
+        for (k = 0, start = 0; k < n; start = ends[k++]) {
+            line = PyBytes_FromStringAndSize(blob->lines.data + start,
+                                             (Py_ssize_t)(ends[k] - start));
+            if (line == NULL) {
+                Py_DECREF(lines);
+                goto error;
+            }
+            PyList_SET_ITEM(lines, k, line);
+        }
+
+        item = Py_BuildValue("(y#N)", g->entries->paths.data + paths[path],
+                             (Py_ssize_t)(paths[path + 1] - paths[path]), lines);
+        if (item == NULL || PyList_Append(result, item) < 0) {
+            Py_XDECREF(item);
+            goto error;
+        }
+        Py_DECREF(item);
+    }
+
+    return result;
+
+error:
+    Py_DECREF(result);
+    return NULL;
+}
+
+/*
+ * Search the blobs of the tree for literal, the result is built by
+ * tree_grep_result, or tree_grep_lines_result if by_blob is set.
+ */
+static PyObject *
+tree_grep_tree(Tree *self, const char *literal, Py_ssize_t literal_len,
+               int ignore_case, PyObject *py_pathspec, int threads, int by_blob)
+{
+    tree_walk w;
+    tree_walk_entries entries;
+    tree_walk_pathspec pathspec;
+    tree_grep g;
+    PyObject *result = NULL;
+    const uint32_t *modes;
+    char *folded = NULL;
+    size_t i, n;
+    int allow_threads, err;
+
+    if (memchr(literal, '\n', literal_len) != NULL) {
+        PyErr_SetString(PyExc_ValueError, "literal must not contain a newline");
+        return NULL;
+    }
+
+    if (threads < 1) {
+        PyErr_SetString(PyExc_ValueError, "threads must be at least 1");
+        return NULL;
+    }
+
+    if (Object__load((Object*)self) == NULL) { return NULL; } // Lazy load
+
+    memset(&g, 0, sizeof(g));
+    if (tree_walk_init(&w, &entries, &pathspec, self->repo->repo, py_pathspec) < 0)
+        goto exit;
+
+    if (ignore_case) {
+        folded = malloc(literal_len ? literal_len : 1);
+        if (folded == NULL) {
+            PyErr_NoMemory();
+            goto exit;
+        }
+        for (i = 0; i < (size_t)literal_len; i++)
+            folded[i] = TREE_GREP_LOWER(literal[i]);
+        literal = folded;
+    }
+
+    g.repo = w.repo;
+    g.literal = literal;
+    g.literal_len = (size_t)literal_len;
+    g.ignore_case = ignore_case;
+    g.entries = &entries;
+
+    allow_threads = repository_odb_allows_threads(w.repo);
+    if (!allow_threads)
+        threads = 1;
+
+    PGIT_BEGIN_ALLOW_THREADS_IF(allow_threads)
+    if (threads > 1)
+        err = tree_walk_parallel(&w, self->tree, threads);
+    else
+        err = tree_walk_tree(&w, self->tree, 0);
+
+    if (err == 0) {
+        /* Only regular files, not links nor submodules */
+        modes = (const uint32_t *)entries.modes.data;
+        n = entries.modes.size / sizeof(uint32_t);
+        g.blobs = malloc((n ? n : 1) * sizeof(size_t));
+        g.results = calloc(n ? n : 1, sizeof(tree_grep_blob));
+        if (g.blobs == NULL || g.results == NULL) {
+            w.nomem = 1;
+            err = -1;
+        } else {
+            for (i = 0; i < n; i++) {
+                if (modes[i] == GIT_FILEMODE_BLOB || modes[i] == GIT_FILEMODE_BLOB_EXECUTABLE)
+                    g.blobs[g.nblobs++] = i;
+            }
+            err = tree_grep_run(&g, threads);
+            w.nomem = g.nomem;
+        }
+    }
+    PGIT_END_ALLOW_THREADS_IF
+
+    if (w.nomem)
+        PyErr_NoMemory();
+    else if (err < 0)
+        Error_set(err);
+    else if (by_blob)
+        result = tree_grep_lines_result(&g);
+    else
+        result = tree_grep_result(&g);
+
+exit:
+    if (g.results) {
+        for (i = 0; i < (size_t)g.nblobs; i++) {
+            free(g.results[i].lines.data);
+            free(g.results[i].ends.data);
+            free(g.results[i].linenos.data);
+            free(g.results[i].err_msg);
+        }
+    }
+    free(g.results);
+    free(g.blobs);
+    free(folded);
+    tree_walk_clear(&w, &entries, &pathspec);
+    return result;
+}
+
+PyDoc_STRVAR(Tree__grep__doc__,
+  "_grep(literal: bytes, pathspec: str | bytes | Iterable[str | bytes] | None = None, threads: int = 1, ignore_case: bool = False) -> list[tuple[bytes, int, bytes]]\n"
+  "\n"
+  "Return the lines containing literal in the blobs of the tree, as\n"
+  "`(path, line_number, line)` tuples, without the end of line. Binary\n"
+  "blobs are skipped. With ignore_case the case of ASCII letters is\n"
+  "ignored, as by `re.IGNORECASE` on bytes. Used by `Repository.grep()`.");
+
+PyObject *
+Tree__grep(Tree *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"literal", "pathspec", "threads", "ignore_case", NULL};
+    PyObject *py_pathspec = Py_None;
+    const char *literal;
+    Py_ssize_t literal_len;
+    int threads = 1, ignore_case = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y#|Oip", keywords,
+                                     &literal, &literal_len, &py_pathspec,
+                                     &threads, &ignore_case))
+        return NULL;
+
+    return tree_grep_tree(self, literal, literal_len, ignore_case, py_pathspec,
+                          threads, 0);
+}
+
+PyDoc_STRVAR(Tree__grep_lines__doc__,
+  "_grep_lines(pathspec: str | bytes | Iterable[str | bytes] | None = None, threads: int = 1) -> list[tuple[bytes, list[bytes]]]\n"
+  "\n"
+  "Return the lines of the blobs of the tree, as `(path, lines)` tuples,\n"
+  "without the ends of line. The blobs are read and split without the GIL,\n"
+  "binary blobs are skipped. Used by `Repository.grep()` for the patterns\n"
+  "without a literal.");
+
+PyObject *
+Tree__grep_lines(Tree *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"pathspec", "threads", NULL};
+    PyObject *py_pathspec = Py_None;
+    int threads = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|Oi", keywords,
+                                     &py_pathspec, &threads))
+        return NULL;
+
+    return tree_grep_tree(self, "", 0, 0, py_pathspec, threads, 1);
+}
+
 PySequenceMethods Tree_as_sequence = {
     0,                          /* sq_length */
     0,                          /* sq_concat */
@@ -409,6 +1834,10 @@ static PyMethodDef Tree_methods[] = {
     METHOD(Tree, diff_to_tree, METH_VARARGS | METH_KEYWORDS),
     METHOD(Tree, diff_to_workdir, METH_VARARGS | METH_KEYWORDS),
     METHOD(Tree, diff_to_index, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Tree, walk, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Tree, lookup_paths, METH_O),
+    METHOD(Tree, _grep, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Tree, _grep_lines, METH_VARARGS | METH_KEYWORDS),
     {NULL}
 };
 
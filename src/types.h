@@ -55,13 +55,77 @@ typedef struct {
 typedef struct {
     PyObject_HEAD
     git_oid oid;
+    Py_hash_t hash;  /* -1 until computed */
 } Oid;
 
+/* Hash table keyed by oid with open addressing, see oidset.c */
+typedef struct {
+    git_oid *keys;
+    PyObject **values;     /* NULL for sets */
+    unsigned char *used;
+    size_t mask;           /* capacity - 1, the capacity is a power of 2 */
+    size_t size;
+    size_t version;        /* Bumped on every insertion or removal */
+} OidTable;
+
+typedef struct {
+    PyObject_HEAD
+    OidTable table;
+} OidSet;
+
+typedef OidSet OidMap;
+
+/* Cache of similarity signatures keyed by blob id, see similarity.c */
+typedef struct pgit_signature pgit_signature;
+
+typedef struct {
+    PyObject_HEAD
+    PyThread_type_lock lock;    /* Used without the GIL */
+    pgit_signature **buckets;
+    size_t mask;
+    pgit_signature *newest;
+    pgit_signature *oldest;
+    Py_ssize_t size;
+    Py_ssize_t maxsize;
+    Py_ssize_t hits;
+    Py_ssize_t misses;
+} SimilarityCache;
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *owner;
+    size_t pos;
+    size_t version;
+    int kind;
+} OidTableIter;
+
 typedef struct {
     PyObject_HEAD
     git_odb *odb;
+    PyObject *paths;  /* On-disk object directories (bytes), NULL if unknown */
 } Odb;
 
+typedef struct odb_iter_producer odb_iter_producer;
+
+typedef struct {
+    PyObject_HEAD
+    Odb *odb;
+    unsigned int kinds;
+    PyObject *packs;      /* Pack indexes to restrict to, NULL for all */
+    Py_ssize_t pack_i;
+    size_t backend_i;
+    PyObject *py_iter;    /* Iterator of a backend implemented in Python */
+    git_oid *batch;
+    size_t batch_len;
+    size_t batch_pos;
+    odb_iter_producer *producer;  /* Reading a native backend, or NULL */
+} OdbIter;
+
+typedef struct {
+    PyObject_HEAD
+    git_odb_object *obj;
+} OdbObject;
+
 typedef struct {
     PyObject_HEAD
     git_odb_backend *odb_backend;
@@ -75,6 +139,10 @@ typedef struct {
     OdbBackend super;
 } OdbBackendLoose;
 
+typedef struct {
+    OdbBackend super;
+} OdbBackendMemory;
+
 typedef struct {
     PyObject_HEAD
     git_refdb *refdb;
@@ -89,11 +157,31 @@ typedef struct {
     RefdbBackend super;
 } RefdbFsBackend;
 
+typedef struct {
+    RefdbBackend super;
+} RefdbMemoryBackend;
+
 typedef struct {
     PyObject_HEAD
     git_reference_iterator *iterator;
 } RefsIterator;
 
+#define REFS_SNAPSHOT_NCOLUMNS 6
+
+typedef struct {
+    PyObject_HEAD
+    Py_ssize_t count;
+    PyObject *names;            /* memoryview of the columns */
+    PyObject *name_offsets;
+    PyObject *targets;
+    PyObject *symbolic;
+    PyObject *symbolic_offsets;
+    PyObject *peeled;           /* None unless peeled */
+    /* The memory of the columns, kept even if the memoryviews are released */
+    PyObject *buffers[REFS_SNAPSHOT_NCOLUMNS];
+    const char *data[REFS_SNAPSHOT_NCOLUMNS];
+} RefsSnapshot;
+
 #define SIMPLE_TYPE(_name, _ptr_type, _ptr_name) \
         typedef struct {\
             PyObject_HEAD\
@@ -120,6 +208,16 @@ OBJECT_TYPE(Tree, git_tree, tree)
 OBJECT_TYPE(Blob, git_blob, blob)
 OBJECT_TYPE(Tag, git_tag, tag)
 
+typedef struct {
+    PyObject_HEAD
+    Blob *blob;
+    git_buf filtered;   /* Filtered contents, empty when reading raw */
+    const char *data;
+    size_t size;
+    size_t pos;
+    int closed;
+} BlobReader;
+
 SIMPLE_TYPE(Worktree, git_worktree, worktree)
 
 /* git_note */
@@ -148,7 +246,14 @@ typedef struct {
 } Patch;
 
 /* git_diff */
-SIMPLE_TYPE(Diff, git_diff, diff)
+typedef struct {
+    PyObject_HEAD
+    Repository *repo;
+    git_diff *diff;
+    PyObject *stats;    /* Computed once, cleared when the diff changes */
+    PyObject *patchid;  /* Idem */
+    int busy;           /* In use without the GIL, see diff_check_busy */
+} Diff;
 
 typedef struct {
     PyObject_HEAD
@@ -200,6 +305,13 @@ typedef struct {
     const git_diff_line *line;
 } DiffLine;
 
+typedef struct {
+    PyObject_HEAD
+    DiffHunk *hunk;
+    size_t i;
+    size_t n;
+} DiffLinesIter;
+
 SIMPLE_TYPE(DiffStats, git_diff_stats, stats);
 
 /* git_tree_walk , git_treebuilder*/
@@ -220,7 +332,12 @@ typedef struct {
 
 
 /* git_reference, git_reflog */
-SIMPLE_TYPE(Walker, git_revwalk, walk)
+typedef struct {
+    PyObject_HEAD
+    Repository *repo;
+    git_revwalk *walk;
+    int yield_ids;  /* Yield Oid instead of Commit objects */
+} Walker;
 
 SIMPLE_TYPE(Reference, git_reference, reference)
 
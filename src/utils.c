@@ -30,6 +30,12 @@
 #include "error.h"
 #include "utils.h"
 
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
 extern PyTypeObject ReferenceType;
 extern PyTypeObject TreeType;
 extern PyTypeObject CommitType;
@@ -180,6 +186,74 @@ pgit_strdup(PyObject *value)
 }
 
 
+/**
+ * Fill 'array' with the paths in 'py_paths', a path or an iterable of paths
+ * (str, bytes or path-like objects), encoded with the file system encoding.
+ * Release it with pgit_strarray_free.
+ */
+int
+py_paths_to_git_strarray(PyObject *py_paths, git_strarray *array)
+{
+    PyObject *py_seq, *py_bytes;
+    Py_ssize_t i, n;
+    char *path;
+
+    array->strings = NULL;
+    array->count = 0;
+
+    if (PyUnicode_Check(py_paths) || PyBytes_Check(py_paths) ||
+        PyObject_HasAttrString(py_paths, "__fspath__"))
+        py_seq = PyTuple_Pack(1, py_paths);
+    else
+        py_seq = PySequence_Fast(py_paths, "paths must be a path or an iterable of paths");
+    if (py_seq == NULL)
+        return -1;
+
+    n = PySequence_Fast_GET_SIZE(py_seq);
+    array->strings = PyMem_Calloc(n ? n : 1, sizeof(char *));
+    if (array->strings == NULL) {
+        Py_DECREF(py_seq);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    for (i = 0; i < n; i++) {
+        if (!PyUnicode_FSConverter(PySequence_Fast_GET_ITEM(py_seq, i), &py_bytes))
+            goto error;
+
+        path = PyMem_Malloc(PyBytes_GET_SIZE(py_bytes) + 1);
+        if (path == NULL) {
+            Py_DECREF(py_bytes);
+            PyErr_NoMemory();
+            goto error;
+        }
+        memcpy(path, PyBytes_AS_STRING(py_bytes), PyBytes_GET_SIZE(py_bytes) + 1);
+        Py_DECREF(py_bytes);
+        array->strings[array->count++] = path;
+    }
+
+    Py_DECREF(py_seq);
+    return 0;
+
+error:
+    Py_DECREF(py_seq);
+    pgit_strarray_free(array);
+    return -1;
+}
+
+void
+pgit_strarray_free(git_strarray *array)
+{
+    size_t i;
+
+    for (i = 0; i < array->count; i++)
+        PyMem_Free(array->strings[i]);
+    PyMem_Free(array->strings);
+    array->strings = NULL;
+    array->count = 0;
+}
+
+
 static git_otype
 py_type_to_git_type(PyTypeObject *py_type)
 {
@@ -234,3 +308,237 @@ pygit2_enum(PyObject *enum_type, int value)
     PyObject *enum_instance = PyObject_CallFunction(enum_type, "(i)", value);
     return enum_instance;
 }
+
+
+/**
+ * Start a native thread running fn(arg). Returns -1 if the thread could not
+ * be created, the caller may then run fn itself.
+ */
+#ifdef _WIN32
+static DWORD WINAPI
+pgit_thread_main(LPVOID payload)
+{
+    pgit_thread *thread = payload;
+    thread->fn(thread->arg);
+    return 0;
+}
+
+int
+pgit_thread_start(pgit_thread *thread, void (*fn)(void *), void *arg)
+{
+    thread->fn = fn;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, pgit_thread_main, thread, 0, NULL);
+    return thread->handle == NULL ? -1 : 0;
+}
+
+void
+pgit_thread_join(pgit_thread *thread)
+{
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+#else
+static void *
+pgit_thread_main(void *payload)
+{
+    pgit_thread *thread = payload;
+    thread->fn(thread->arg);
+    return NULL;
+}
+
+int
+pgit_thread_start(pgit_thread *thread, void (*fn)(void *), void *arg)
+{
+    thread->fn = fn;
+    thread->arg = arg;
+    return pthread_create(&thread->handle, NULL, pgit_thread_main, thread) ? -1 : 0;
+}
+
+void
+pgit_thread_join(pgit_thread *thread)
+{
+    pthread_join(thread->handle, NULL);
+}
+#endif
+
+
+/**
+ * Atomically increment *value, returning its previous value. Used by
+ * native workers to take the next item of a shared queue.
+ */
+long
+pgit_atomic_fetch_inc(volatile long *value)
+{
+#ifdef _WIN32
+    return InterlockedIncrement(value) - 1;
+#else
+    return __atomic_fetch_add(value, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/**
+ * Seconds from an arbitrary point, which never goes backwards. Unlike
+ * time.monotonic() it can be called without the GIL.
+ */
+double
+pgit_monotonic(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+/**
+ * Append len bytes to the buffer. Returns -1 on out of memory, without
+ * setting a Python exception, so it can be called without the GIL.
+ */
+int
+pgit_buffer_append(pgit_buffer *buf, const void *data, size_t len)
+{
+    if (buf->size + len > buf->alloc) {
+        size_t alloc = buf->alloc ? buf->alloc : 1024;
+        while (alloc < buf->size + len)
+            alloc *= 2;
+
+        char *new_data = realloc(buf->data, alloc);
+        if (new_data == NULL)
+            return -1;
+
+        buf->data = new_data;
+        buf->alloc = alloc;
+    }
+
+    memcpy(buf->data + buf->size, data, len);
+    buf->size += len;
+    return 0;
+}
+
+/*
+ * The memory of a pgit_buffer, handed over to Python: it frees it, and
+ * exports it (read-only) through the buffer protocol.
+ */
+typedef struct {
+    PyObject_HEAD
+    char *data;
+    Py_ssize_t size;
+} Buffer;
+
+static int
+Buffer_getbuffer(Buffer *self, Py_buffer *view, int flags)
+{
+    return PyBuffer_FillInfo(view, (PyObject *)self, self->data, self->size, 1, flags);
+}
+
+static void
+Buffer_dealloc(Buffer *self)
+{
+    free(self->data);
+    PyObject_Del(self);
+}
+
+static PyBufferProcs Buffer_as_buffer = {
+    (getbufferproc)Buffer_getbuffer,
+    NULL,
+};
+
+PyDoc_STRVAR(Buffer__doc__, "Memory owned by a memoryview.");
+
+PyTypeObject BufferType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "_pygit2.Buffer",                          /* tp_name           */
+    sizeof(Buffer),                            /* tp_basicsize      */
+    0,                                         /* tp_itemsize       */
+    (destructor)Buffer_dealloc,                /* tp_dealloc        */
+    0,                                         /* tp_print          */
+    0,                                         /* tp_getattr        */
+    0,                                         /* tp_setattr        */
+    0,                                         /* tp_compare        */
+    0,                                         /* tp_repr           */
+    0,                                         /* tp_as_number      */
+    0,                                         /* tp_as_sequence    */
+    0,                                         /* tp_as_mapping     */
+    0,                                         /* tp_hash           */
+    0,                                         /* tp_call           */
+    0,                                         /* tp_str            */
+    0,                                         /* tp_getattro       */
+    0,                                         /* tp_setattro       */
+    &Buffer_as_buffer,                         /* tp_as_buffer      */
+    Py_TPFLAGS_DEFAULT,                        /* tp_flags          */
+    Buffer__doc__,                             /* tp_doc            */
+};
+
+/**
+ * Hand the memory of the buffer over to a new _pygit2.Buffer, which frees
+ * it, without copying it. The buffer is left empty.
+ */
+PyObject *
+pgit_buffer_to_object(pgit_buffer *buf)
+{
+    Buffer *owner;
+    char *data;
+
+    /* Give back what the doubling reserved, it is not going to grow */
+    if (buf->size > 0 && buf->size < buf->alloc) {
+        data = realloc(buf->data, buf->size);
+        if (data)
+            buf->data = data;
+    } else if (buf->data == NULL && (buf->data = malloc(1)) == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    owner = PyObject_New(Buffer, &BufferType);
+    if (owner == NULL)
+        return NULL;
+
+    owner->data = buf->data;
+    owner->size = (Py_ssize_t)buf->size;
+    buf->data = NULL;
+    buf->size = 0;
+    buf->alloc = 0;
+    return (PyObject *)owner;
+}
+
+/**
+ * A memoryview of the object's buffer, with the given struct format.
+ */
+PyObject *
+pgit_memoryview_from_object(PyObject *obj, const char *format)
+{
+    PyObject *view, *result;
+
+    view = PyMemoryView_FromObject(obj);
+    if (view == NULL || format[0] == 'B')
+        return view;
+
+    result = PyObject_CallMethod(view, "cast", "s", format);
+    Py_DECREF(view);
+    return result;
+}
+
+/**
+ * Hand the memory of the buffer over to a memoryview with the given struct
+ * format, without copying it. The buffer is left empty.
+ */
+PyObject *
+pgit_buffer_to_memoryview(pgit_buffer *buf, const char *format)
+{
+    PyObject *owner, *view;
+
+    owner = pgit_buffer_to_object(buf);
+    if (owner == NULL)
+        return NULL;
+
+    view = pgit_memoryview_from_object(owner, format);
+    Py_DECREF(owner);
+    return view;
+}
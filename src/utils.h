@@ -33,6 +33,10 @@
 #include <git2.h>
 #include "types.h"
 
+#ifndef _WIN32
+#  include <pthread.h>
+#endif
+
 #ifdef __GNUC__
 #  define PYGIT2_FN_UNUSED __attribute__((unused))
 #else
@@ -59,6 +63,43 @@
     }
 
 
+/* Like Py_BEGIN/END_ALLOW_THREADS, but only release the GIL if the condition
+ * holds, e.g. when libgit2 will not call back into a backend written in
+ * Python. */
+#define PGIT_BEGIN_ALLOW_THREADS_IF(cond) \
+    { PyThreadState *_save = (cond) ? PyEval_SaveThread() : NULL;
+#define PGIT_END_ALLOW_THREADS_IF \
+    if (_save) PyEval_RestoreThread(_save); }
+
+/* Native worker threads, which must not call into Python */
+typedef struct {
+#ifdef _WIN32
+    void *handle;
+#else
+    pthread_t handle;
+#endif
+    void (*fn)(void *);
+    void *arg;
+} pgit_thread;
+
+int pgit_thread_start(pgit_thread *thread, void (*fn)(void *), void *arg);
+void pgit_thread_join(pgit_thread *thread);
+long pgit_atomic_fetch_inc(volatile long *value);
+double pgit_monotonic(void);
+
+/* Growable buffers allocated with malloc, usable without the GIL */
+typedef struct {
+    char *data;
+    size_t size;
+    size_t alloc;
+} pgit_buffer;
+
+int pgit_buffer_append(pgit_buffer *buf, const void *data, size_t len);
+PyObject *pgit_buffer_to_object(pgit_buffer *buf);
+PyObject *pgit_memoryview_from_object(PyObject *obj, const char *format);
+PyObject *pgit_buffer_to_memoryview(pgit_buffer *buf, const char *format);
+
+
 /* Utilities */
 #define to_unicode(x, encoding, errors) to_unicode_n(x, strlen(x), encoding, errors)
 
@@ -95,6 +136,8 @@ char* pgit_strdup(PyObject *value);
 
 //PyObject * get_pylist_from_git_strarray(git_strarray *strarray);
 //int get_strarraygit_from_pylist(git_strarray *array, PyObject *pylist);
+int py_paths_to_git_strarray(PyObject *py_paths, git_strarray *array);
+void pgit_strarray_free(git_strarray *array);
 
 git_otype py_object_to_otype(PyObject *py_type);
 
@@ -29,11 +29,15 @@
 #include <Python.h>
 #include "error.h"
 #include "object.h"
+#include "odb.h"
 #include "oid.h"
 #include "tree.h"
 #include "utils.h"
 #include "walker.h"
 
+/* Ids reserved up front by next_batch, before the walk shows its length */
+#define WALKER_BATCH 1024
+
 extern PyTypeObject CommitType;
 
 void
@@ -135,6 +139,119 @@ Walker_simplify_first_parent(Walker *self)
     Py_RETURN_NONE;
 }
 
+PyDoc_STRVAR(Walker_oids__doc__,
+  "oids() -> Walker\n"
+  "\n"
+  "Make the walker yield the ids of the commits instead of the commits\n"
+  "themselves, and return it. This avoids reading and parsing every commit\n"
+  "when only the ids are needed.\n"
+  "\n"
+  "Example:\n"
+  "\n"
+  "  >>> for oid in repo.walk(repo.head.target).oids():\n"
+  "  ...     print(oid)\n");
+
+PyObject *
+Walker_oids(Walker *self)
+{
+    self->yield_ids = 1;
+    Py_INCREF(self);
+    return (PyObject*)self;
+}
+
+PyDoc_STRVAR(Walker_next_batch__doc__,
+  "next_batch(n: int, raw: bool = False) -> list[Oid] | bytes\n"
+  "\n"
+  "Return the ids of the next (up to) n commits of the walk, as a list of\n"
+  "Oid objects, or as a bytes string of consecutive raw 20 byte ids if raw\n"
+  "is true. An empty result means the walk is over.\n"
+  "\n"
+  "The commits are walked in one go, without holding the GIL unless the\n"
+  "object database has a backend implemented in Python.");
+
+PyObject *
+Walker_next_batch(Walker *self, PyObject *args, PyObject *kwds)
+{
+    char *keywords[] = {"n", "raw", NULL};
+    Py_ssize_t n, i, alloc, count = 0;
+    int raw = 0, allow_threads;
+    int err = 0;
+    git_oid *oids, *grown;
+    PyObject *result;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "n|p", keywords, &n, &raw))
+        return NULL;
+
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "n must not be negative");
+        return NULL;
+    }
+
+    /* The raw result must fit in a bytes object */
+    if (n > PY_SSIZE_T_MAX / GIT_OID_RAWSZ) {
+        PyErr_SetString(PyExc_ValueError, "n is too large");
+        return NULL;
+    }
+
+    /* The walk may end early, so grow the buffer as it goes */
+    alloc = n < WALKER_BATCH ? (n > 0 ? n : 1) : WALKER_BATCH;
+    oids = PyMem_New(git_oid, alloc);
+    if (oids == NULL)
+        return PyErr_NoMemory();
+
+    allow_threads = repository_odb_allows_threads(self->repo->repo);
+    for (;;) {
+        PGIT_BEGIN_ALLOW_THREADS_IF(allow_threads)
+        while (count < n && count < alloc) {
+            err = git_revwalk_next(&oids[count], self->walk);
+            if (err < 0)
+                break;
+            count++;
+        }
+        PGIT_END_ALLOW_THREADS_IF
+
+        if (err < 0 || count == n)
+            break;
+
+        alloc = alloc > n - alloc ? n : alloc * 2;
+        grown = oids;
+        PyMem_Resize(grown, git_oid, alloc);
+        if (grown == NULL) {
+            PyMem_Free(oids);
+            return PyErr_NoMemory();
+        }
+        oids = grown;
+    }
+
+    if (err < 0 && err != GIT_ITEROVER) {
+        PyMem_Free(oids);
+        return Error_set(err);
+    }
+
+    if (raw) {
+        result = PyBytes_FromStringAndSize(NULL, count * GIT_OID_RAWSZ);
+        if (result) {
+            char *buffer = PyBytes_AS_STRING(result);
+            for (i = 0; i < count; i++)
+                memcpy(buffer + i * GIT_OID_RAWSZ, oids[i].id, GIT_OID_RAWSZ);
+        }
+    }
+    else {
+        result = PyList_New(count);
+        for (i = 0; result && i < count; i++) {
+            PyObject *py_oid = git_oid_to_python(&oids[i]);
+            if (py_oid == NULL) {
+                Py_CLEAR(result);
+                break;
+            }
+            PyList_SET_ITEM(result, i, py_oid);
+        }
+    }
+
+    PyMem_Free(oids);
+    return result;
+}
+
 PyObject *
 Walker_iter(Walker *self)
 {
@@ -156,6 +273,9 @@ Walker_iternext(Walker *self)
     if (err < 0)
         return Error_set(err);
 
+    if (self->yield_ids)
+        return git_oid_to_python(&oid);
+
     err = git_commit_lookup(&commit, self->repo->repo, &oid);
     if (err < 0)
         return Error_set(err);
@@ -165,6 +285,8 @@ Walker_iternext(Walker *self)
 
 static PyMethodDef Walker_methods[] = {
     METHOD(Walker, hide, METH_O),
+    METHOD(Walker, next_batch, METH_VARARGS | METH_KEYWORDS),
+    METHOD(Walker, oids, METH_NOARGS),
     METHOD(Walker, push, METH_O),
     METHOD(Walker, reset, METH_NOARGS),
     METHOD(Walker, simplify_first_parent, METH_NOARGS),
@@ -38,6 +38,8 @@ PyObject* Walker_hide(Walker *self, PyObject *py_hex);
 PyObject* Walker_push(Walker *self, PyObject *py_hex);
 PyObject* Walker_sort(Walker *self, PyObject *py_sort_mode);
 PyObject* Walker_reset(Walker *self);
+PyObject* Walker_oids(Walker *self);
+PyObject* Walker_next_batch(Walker *self, PyObject *args, PyObject *kwds);
 PyObject* Walker_iter(Walker *self);
 PyObject* Walker_iternext(Walker *self);
 
@@ -24,9 +24,10 @@
 # Boston, MA 02110-1301, USA.
 
 import tarfile
+import zipfile
 from pathlib import Path
 
-from pygit2 import Index, Object, Oid, Repository, Tree
+from pygit2 import Blob, Index, Object, Oid, Repository, Tree
 
 TREE_HASH = 'fd937514cb799514d4b81bb24c5fcfeb6472b245'
 COMMIT_HASH = '2be5719152d4f82c7302b1c0932d8e5f0a4a0e98'
@@ -69,3 +70,31 @@ def test_write_commit(testrepo: Repository, tmp_path: Path) -> None:
     check_writing(testrepo, COMMIT_HASH, tmp_path, commit_timestamp)
     check_writing(testrepo, Oid(hex=COMMIT_HASH), tmp_path, commit_timestamp)
     check_writing(testrepo, testrepo[COMMIT_HASH], tmp_path, commit_timestamp)
+
+
+def test_write_contents(testrepo: Repository, tmp_path: Path) -> None:
+    index = Index()
+    index.read_tree(testrepo[COMMIT_HASH].peel(Tree))
+    expected = {}
+    for entry in index:
+        blob = testrepo[entry.id]
+        assert isinstance(blob, Blob)
+        expected[f'prefix/{entry.path}'] = blob.data
+
+    # Small batches to go through the read ahead more than once
+    with tarfile.open(tmp_path / 'foo.tar.gz', mode='w:gz') as archive:
+        testrepo.write_archive(COMMIT_HASH, archive, prefix='prefix/', batch_size=2)
+    with tarfile.open(tmp_path / 'foo.tar.gz') as archive:
+        members = archive.getmembers()
+        assert [m.name for m in members] == sorted(expected)
+        for member in members:
+            f = archive.extractfile(member)
+            assert f is not None
+            assert f.read() == expected[member.name]
+
+    with zipfile.ZipFile(tmp_path / 'foo.zip', 'w') as archive:
+        testrepo.write_archive(COMMIT_HASH, archive, prefix='prefix/', filters=True)
+    with zipfile.ZipFile(tmp_path / 'foo.zip') as archive:
+        assert archive.namelist() == sorted(expected)
+        for name, data in expected.items():
+            assert archive.read(name) == data
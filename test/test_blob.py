@@ -256,7 +256,7 @@ def test_blobio(testrepo: Repository) -> None:
     assert isinstance(blob, pygit2.Blob)
     with pygit2.BlobIO(blob) as reader:
         assert b'bye world\n' == reader.read()
-    assert not reader.raw._thread.is_alive()  # type: ignore[attr-defined]
+    assert reader.raw.closed
 
 
 def test_blobio_filtered(testrepo: Repository) -> None:
@@ -265,7 +265,37 @@ def test_blobio_filtered(testrepo: Repository) -> None:
     assert isinstance(blob, pygit2.Blob)
     with pygit2.BlobIO(blob, as_path='bye.txt') as reader:
         assert b'bye world\n' == reader.read()
-    assert not reader.raw._thread.is_alive()  # type: ignore[attr-defined]
+    assert reader.raw.closed
+
+
+def test_blobreader(testrepo: Repository) -> None:
+    blob_oid = testrepo.create_blob_fromworkdir('bye.txt')
+    blob = testrepo[blob_oid]
+    assert isinstance(blob, pygit2.Blob)
+
+    with pygit2.BlobReader(blob, as_path='bye.txt') as reader:
+        assert isinstance(reader, io.RawIOBase)
+        buf = bytearray(4)
+        chunks = []
+        while n := reader.readinto(buf):
+            chunks.append(bytes(buf[:n]))
+        assert chunks == [b'bye ', b'worl', b'd\n']
+        assert reader.read() == b''
+    assert reader.closed
+    with pytest.raises(ValueError):
+        reader.read()
+
+    reader = pygit2.BlobReader(blob)
+    assert reader.read(3) == b'bye'
+    assert reader.readall() == b' world\n'
+
+    with pytest.raises(TypeError):
+        pygit2.BlobReader(
+            blob,
+            as_path='bye.txt',
+            flags=BlobFilter.ATTRIBUTES_FROM_COMMIT,
+            commit_id=1234,  # type: ignore
+        )
 
 
 def test_blob_write_to_queue_invalid_commit_id_type(testrepo: Repository) -> None:
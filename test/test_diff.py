@@ -25,16 +25,26 @@
 
 """Tests for Diff objects."""
 
+import io
 import textwrap
 from collections.abc import Iterator
+from concurrent.futures import ThreadPoolExecutor
 from itertools import chain
 from pathlib import Path
 
 import pytest
 
 import pygit2
-from pygit2 import Diff, Repository
-from pygit2.enums import DeltaStatus, DiffFlag, DiffOption, DiffStatsFormat, FileMode
+from pygit2 import Diff, Oid, Repository
+from pygit2.enums import (
+    DeltaStatus,
+    DiffFind,
+    DiffFlag,
+    DiffFormat,
+    DiffOption,
+    DiffStatsFormat,
+    FileMode,
+)
 
 from .utils import diff_safeiter
 
@@ -355,6 +365,52 @@ def test_diff_ids(barerepo: Repository) -> None:
     assert delta.new_file.id == 'af431f20fc541ed6d5afede3e2dc7160f6f01f16'
 
 
+def test_diff_write_patch(barerepo: Repository, tmp_path: Path) -> None:
+    commit_a = barerepo[COMMIT_SHA1_1]
+    commit_b = barerepo[COMMIT_SHA1_2]
+    diff = commit_a.tree.diff_to_tree(commit_b.tree)
+
+    out = io.BytesIO()
+    assert diff.write_patch(out) == len(PATCH)
+    assert out.getvalue() == PATCH.encode()
+
+    out = io.BytesIO()
+    diff.write_patch(out, format=DiffFormat.NAME_STATUS)
+    assert out.getvalue() == b'M\ta\nD\tc/d\n'
+
+    path = tmp_path / 'patch'
+    with path.open('wb') as f:
+        diff.write_patch(f.fileno(), DiffFormat.PATCH)
+    assert path.read_text() == PATCH
+
+    with pytest.raises(TypeError):
+        diff.write_patch('patch')  # type: ignore
+
+
+def test_diff_cache(barerepo: Repository) -> None:
+    barerepo.diff_cache = pygit2.DiffCache(maxsize=2)
+    diff = barerepo.diff(COMMIT_SHA1_1, COMMIT_SHA1_2)
+    assert isinstance(diff, Diff)
+    assert diff.patch == PATCH
+    assert diff.stats is diff.stats
+    assert diff.patchid is diff.patchid
+    assert barerepo.diff(COMMIT_SHA1_1, COMMIT_SHA1_2) is diff
+    assert (barerepo.diff_cache.hits, barerepo.diff_cache.misses) == (1, 1)
+
+    # Working directory options don't change the key, other options do
+    flags = DiffOption.INCLUDE_UNTRACKED
+    assert barerepo.diff(COMMIT_SHA1_1, COMMIT_SHA1_2, flags=flags) is diff
+    assert barerepo.diff(COMMIT_SHA1_1, COMMIT_SHA1_2, context_lines=1) is not diff
+    assert barerepo.diff(COMMIT_SHA1_2, COMMIT_SHA1_3) is not diff
+    assert len(barerepo.diff_cache) == 2
+    assert barerepo.diff(COMMIT_SHA1_1, COMMIT_SHA1_2) is not diff
+    assert (barerepo.diff_cache.hits, barerepo.diff_cache.misses) == (2, 4)
+
+    barerepo.diff_cache.clear()
+    assert len(barerepo.diff_cache) == 0
+    barerepo.diff_cache = None
+
+
 def test_diff_patchid(barerepo: Repository) -> None:
     commit_a = barerepo[COMMIT_SHA1_1]
     commit_b = barerepo[COMMIT_SHA1_2]
@@ -393,6 +449,93 @@ def test_find_similar(barerepo: Repository) -> None:
     assert any(patch.delta.status_char() == 'R' for patch in diff_safeiter(diff))
 
 
+def test_find_similar_cache(barerepo: Repository) -> None:
+    def tree(files: dict[str, bytes]) -> pygit2.Tree:
+        tb = barerepo.TreeBuilder()
+        for name, data in files.items():
+            tb.insert(name, barerepo.create_blob(data), FileMode.BLOB)
+        return barerepo[tb.write()]  # type: ignore[return-value]
+
+    a = b''.join(b'line %d\n' % i for i in range(100))
+    b = b''.join(b'other %d\n' % i for i in range(100))
+    old = tree({'a': a, 'b': b})
+    new = tree({'a2': a + b'more\n', 'b2': b + b'more\n'})
+
+    def renames(old: pygit2.Tree, new: pygit2.Tree, **kwargs: object) -> int:
+        diff = old.diff_to_tree(new)
+        diff.find_similar(**kwargs)  # type: ignore[arg-type]
+        return sum(delta.status == DeltaStatus.RENAMED for delta in diff.deltas)
+
+    cache = pygit2.SimilarityCache(maxsize=16)
+    assert renames(old, new, cache=cache) == 2
+    assert (len(cache), cache.hits, cache.misses) == (4, 0, 4)
+    barerepo.similarity_cache = cache
+    assert renames(old, new) == 2
+    assert (len(cache), cache.hits, cache.misses) == (4, 4, 4)
+    cache.clear()
+    assert (len(cache), cache.hits, cache.misses) == (0, 0, 0)
+
+    # Identical files are still matched once the budget is spent
+    old = tree({'a': a, 'b': b, 'c': b'same\n'})
+    new = tree({'a2': a + b'more\n', 'b2': b + b'more\n', 'c2': b'same\n'})
+    assert renames(old, new) == 3
+    assert 1 <= renames(old, new, max_pairs=1) < 3
+    with pytest.raises(ValueError):
+        renames(old, new, max_pairs=-1)
+    with pytest.raises(TypeError):
+        renames(old, new, cache={})
+
+
+class CountingBackend(pygit2.OdbBackend):
+    """An object database in memory, counting the objects read."""
+
+    def __init__(self) -> None:
+        super().__init__()
+        self.objects: dict[Oid, tuple[int, bytes]] = {}
+        self.reads = 0
+
+    def read_cb(self, oid: Oid) -> tuple[int, bytes]:
+        self.reads += 1
+        return self.objects[oid]
+
+    def read_header_cb(self, oid: Oid) -> tuple[int, int]:
+        typ, data = self.objects[oid]
+        return typ, len(data)
+
+    def write_cb(self, oid: Oid, data: bytes, typ: int) -> None:
+        self.objects[oid] = (typ, data)
+
+    def exists_cb(self, oid: Oid) -> bool:
+        return oid in self.objects
+
+
+def test_find_similar_budget_reads() -> None:
+    backend = CountingBackend()
+    odb = pygit2.Odb()
+    odb.add_backend(backend, 1)
+    repo = pygit2.Repository()
+    repo.set_odb(odb)
+
+    def tree(suffix: str) -> pygit2.Tree:
+        tb = repo.TreeBuilder()
+        for i in range(6):
+            data = b''.join(b'file %d line %d\n' % (i, k) for k in range(100))
+            oid = repo.create_blob(data + suffix.encode())
+            tb.insert(f'{i}{suffix}', oid, FileMode.BLOB)
+        return repo[tb.write()]  # type: ignore[return-value]
+
+    old, new = tree(''), tree('2')
+
+    def reads(**kwargs: object) -> int:
+        diff = old.diff_to_tree(new)
+        backend.reads = 0
+        diff.find_similar(DiffFind.FIND_RENAMES, **kwargs)  # type: ignore[arg-type]
+        return backend.reads
+
+    # Once the budget is spent, the files are not read again for every pair
+    assert reads(max_pairs=1) <= reads()
+
+
 def test_diff_stats(barerepo: Repository) -> None:
     commit_a = barerepo[COMMIT_SHA1_1]
     commit_b = barerepo[COMMIT_SHA1_2]
@@ -408,6 +551,63 @@ def test_diff_stats(barerepo: Repository) -> None:
     assert STATS_EXPECTED == formatted
 
 
+def test_diff_threads(barerepo: Repository) -> None:
+    # Diffs are computed without the GIL, concurrently on the same repository
+    commits = [COMMIT_SHA1_1, COMMIT_SHA1_2, COMMIT_SHA1_6, COMMIT_SHA1_7]
+    pairs = [(barerepo[a].tree, barerepo[b].tree) for a in commits for b in commits]
+
+    def stats(pair: tuple[pygit2.Tree, pygit2.Tree]) -> tuple[int, int, int]:
+        diff = pair[0].diff_to_tree(pair[1])
+        diff.find_similar()
+        return diff.stats.files_changed, diff.stats.insertions, diff.stats.deletions
+
+    expected = [stats(pair) for pair in pairs]
+    with ThreadPoolExecutor(max_workers=4) as executor:
+        assert list(executor.map(stats, pairs * 4)) == expected * 4
+
+
+def test_diff_busy(barerepo: Repository) -> None:
+    # The diff is marked busy while libgit2 works on it, file objects are
+    # written to from inside write_patch
+    diff = barerepo[COMMIT_SHA1_1].tree.diff_to_tree(barerepo[COMMIT_SHA1_2].tree)
+    calls = []
+
+    class Writer(io.BytesIO):
+        def write(self, data: bytes) -> int:  # type: ignore[override]
+            for use in (len, lambda diff: diff.patch, lambda diff: diff[0]):
+                with pytest.raises(RuntimeError):
+                    use(diff)
+            calls.append(data)
+            return super().write(data)
+
+    out = Writer()
+    assert diff.write_patch(out) == len(PATCH)
+    assert calls
+    # Usable again once it returns
+    assert len(diff) == 2
+    assert diff.patch == PATCH
+
+
+def test_diff_busy_threads(barerepo: Repository) -> None:
+    # Using a diff while another thread runs find_similar raises, not crashes
+    tree_a, tree_b = barerepo[COMMIT_SHA1_1].tree, barerepo[COMMIT_SHA1_6].tree
+    expected = tree_a.diff_to_tree(tree_b)
+    expected.find_similar()
+
+    for _ in range(20):
+        diff = tree_a.diff_to_tree(tree_b)
+        with ThreadPoolExecutor(max_workers=1) as executor:
+            future = executor.submit(diff.find_similar)
+            while not future.done():
+                try:
+                    list(diff.deltas)
+                    diff.stats
+                except RuntimeError:
+                    pass
+            future.result()
+        assert diff.patch == expected.patch
+
+
 def test_deltas(barerepo: Repository) -> None:
     commit_a = barerepo[COMMIT_SHA1_1]
     commit_b = barerepo[COMMIT_SHA1_2]
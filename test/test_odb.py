@@ -33,7 +33,7 @@ from pathlib import Path
 import pytest
 
 # pygit2
-from pygit2 import Odb, Oid, Repository
+from pygit2 import Odb, OdbBackendMemory, Oid, Repository
 from pygit2.enums import ObjectType
 
 from . import utils
@@ -89,6 +89,21 @@ def test_read(odb: Odb) -> None:
     assert isinstance(a3[0], ObjectType)
 
 
+def test_read_object(odb: Odb) -> None:
+    utils.assertRaisesWithArg(KeyError, '1' * 40, odb.read_object, '1' * 40)
+
+    obj = odb.read_object(BLOB_HEX[:4])
+    assert obj.id == BLOB_OID
+    assert obj.type == ObjectType.BLOB
+    assert obj.size == len(BLOB_CONTENTS)
+    assert obj.data == BLOB_CONTENTS
+
+    view = memoryview(obj)
+    assert view.readonly
+    del obj
+    assert view.tobytes() == BLOB_CONTENTS
+
+
 def test_read_header(odb: Odb) -> None:
     with pytest.raises(TypeError):
         odb.read_header(123)  # type: ignore
@@ -109,3 +124,44 @@ def test_write(odb: Odb) -> None:
 
     oid = odb.write(ObjectType.BLOB, data)
     assert type(oid) is Oid
+
+
+def test_objects(odb: Odb) -> None:
+    oids = list(odb.objects())
+    assert BLOB_OID in oids
+    assert len(oids) == len(set(oids))
+    assert set(oids) == set(odb)
+
+
+def test_objects_kinds(testrepopacked: Repository) -> None:
+    odb = testrepopacked.odb
+    packed = set(odb.objects(loose=False))
+    assert len(packed) == 18
+    assert set(odb.objects(packed=False)) == set()
+
+    packs = (Path(testrepopacked.path) / 'objects' / 'pack').glob('*.pack')
+    assert set(odb.objects(loose=False, packs=packs)) == packed
+    assert set(odb.objects(loose=False, packs=['pack-missing'])) == set()
+
+
+def test_objects_batches() -> None:
+    odb = Odb()
+    odb.add_backend(OdbBackendMemory(), 1)
+    oids = {odb.write(ObjectType.BLOB, b'%d' % i) for i in range(10000)}
+
+    # More ids than a batch holds, handed over a batch at a time
+    assert set(odb.objects()) == oids
+
+    # Iterators dropped before the end stop their producer
+    for _ in range(3):
+        objects = odb.objects()
+        assert next(objects) in oids
+        del objects
+    objects = odb.objects()
+    assert sum(1 for _ in zip(range(5000), objects)) == 5000
+    del objects
+
+
+def test_objects_packs_needs_path() -> None:
+    with pytest.raises(ValueError):
+        Odb().objects(packs=['pack-missing'])
@@ -277,3 +277,27 @@ def test_foreach_cb_bad_oid(barerepo: Repository) -> None:
     odb.add_backend(backend, 1)
     with pytest.raises(pygit2.InvalidError):
         next(iter(odb))
+
+
+def test_memory_backend(barerepo: Repository) -> None:
+    backend = pygit2.OdbBackendMemory()
+    barerepo.odb.add_backend(backend, 1000)
+
+    # New objects go to memory, the others are still read from disk
+    oid = barerepo.create_blob(b'in memory\n')
+    assert barerepo.create_blob(b'a contents\n') == BLOB_OID
+    assert len(backend) == 1
+    assert backend.nbytes == 10
+    assert list(backend) == [oid]
+    assert backend.read(oid) == (ObjectType.BLOB, b'in memory\n')
+    assert backend.exists_prefix(str(oid)[:7]) == oid
+    assert not backend.exists(BLOB_OID)
+    assert barerepo[oid].data == b'in memory\n'
+    assert barerepo[BLOB_OID].data == b'a contents\n'
+
+    on_disk = Repository(barerepo.path)
+    assert oid not in on_disk
+
+    name = backend.write_pack(Path(barerepo.path) / 'objects' / 'pack')
+    assert (Path(barerepo.path) / 'objects' / 'pack' / f'pack-{name}.idx').exists()
+    assert Repository(barerepo.path)[oid].data == b'in memory\n'
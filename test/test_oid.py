@@ -30,7 +30,7 @@ from binascii import unhexlify
 
 import pytest
 
-from pygit2 import Oid
+from pygit2 import Oid, OidMap, OidSet
 
 HEX = '15b648aec6ed045b5ca6f57f8b7831a8b4757298'
 RAW = unhexlify(HEX.encode('ascii'))
@@ -100,9 +100,74 @@ def test_hash() -> None:
     s.add(Oid(hex='0000000000000000000000000000000000000001'))
     assert len(s) == 3
 
+    # Same as the hex string it compares equal to
+    assert hash(Oid(raw=RAW)) == hash(HEX)
+    assert {HEX: 1}[Oid(raw=RAW)] == 1
+
 
 def test_bool() -> None:
     assert Oid(raw=RAW)
     assert Oid(hex=HEX)
     assert not Oid(raw=b'')
     assert not Oid(hex='0000000000000000000000000000000000000000')
+
+
+def test_oidset() -> None:
+    oids = [Oid(raw=bytes([i]) * 20) for i in range(100)]
+    s = OidSet(oids[:50])
+    assert len(s) == 50
+    assert oids[0] in s
+    assert str(oids[1]) in s
+    assert oids[50] not in s
+
+    s.update(oids)
+    s.add(HEX)
+    assert len(s) == 101
+    assert set(s) == set(oids) | {Oid(hex=HEX)}
+
+    for oid in oids[::2]:
+        s.discard(oid)
+    s.discard(oids[0])
+    assert len(s) == 51
+    assert all((oid in s) == (i % 2 == 1) for i, oid in enumerate(oids))
+
+    with pytest.raises(ValueError):
+        s.add(HEX[:7])
+
+    s.clear()
+    assert len(s) == 0
+    assert list(s) == []
+
+
+def test_oidset_changed_during_iteration() -> None:
+    s = OidSet([HEX])
+    with pytest.raises(RuntimeError):
+        for oid in s:
+            s.add(Oid(raw=RAW[::-1]))
+
+
+def test_oidmap() -> None:
+    oids = [Oid(raw=bytes([i]) * 20) for i in range(100)]
+    m = OidMap()
+    for i, oid in enumerate(oids):
+        m[oid] = i
+    assert len(m) == 100
+    assert m[oids[5]] == 5
+    assert m[str(oids[6])] == 6
+    assert m.get(HEX) is None
+    assert m.get(HEX, 'x') == 'x'
+    with pytest.raises(KeyError):
+        m[HEX]
+
+    m[oids[5]] = 'five'
+    del m[oids[6]]
+    assert len(m) == 99
+    assert oids[6] not in m
+    assert m[oids[5]] == 'five'
+    assert dict(m.items()) == {
+        oid: 'five' if i == 5 else i for i, oid in enumerate(oids) if i != 6
+    }
+    assert set(m) == set(oids) - {oids[6]}
+    assert sorted(v for v in m.values() if isinstance(v, int)) == [
+        i for i in range(100) if i not in (5, 6)
+    ]
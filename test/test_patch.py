@@ -285,3 +285,35 @@ def test_patch_multi_blob(testrepo: Repository) -> None:
     assert patch_text == patch.text
     assert patch_text2 == patch2.text
     assert patch.text == patch2.text
+
+
+def test_hunk_iter() -> None:
+    patch = pygit2.Patch.create_from(BLOB_OLD_CONTENT, BLOB_NEW_CONTENT)
+    hunk = patch.hunks[0]
+    assert len(hunk) == 4
+    assert [line.raw_content for line in hunk] == [
+        line.raw_content for line in hunk.lines
+    ]
+    assert hunk[-1].content == 'foo bar\n'
+    with pytest.raises(IndexError):
+        hunk[4]
+
+
+def test_line_table() -> None:
+    patch = pygit2.Patch.create_from(BLOB_OLD_CONTENT, BLOB_NEW_CONTENT)
+    table = patch.line_table()
+    lines = [line for hunk in patch.hunks for line in hunk.lines]
+    offsets = table['offsets']
+    assert len(offsets) == len(lines) + 1
+    assert list(table['hunk_offsets']) == [0, len(lines)]
+    for i, line in enumerate(lines):
+        assert table['content'][offsets[i] : offsets[i + 1]] == line.raw_content
+        assert chr(table['origin'][i]) == line.origin
+        assert table['old_lineno'][i] == line.old_lineno
+        assert table['new_lineno'][i] == line.new_lineno
+
+    patch = pygit2.Patch.create_from(BLOB_OLD_CONTENT, BLOB_OLD_CONTENT)
+    table = patch.line_table()
+    assert table['content'] == b''
+    assert list(table['offsets']) == [0]
+    assert list(table['hunk_offsets']) == [0]
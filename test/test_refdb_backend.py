@@ -33,6 +33,7 @@ import pytest
 
 import pygit2
 from pygit2 import Commit, Oid, Reference, Repository, Signature
+from pygit2.enums import ReferenceFilter
 
 from . import utils
 
@@ -209,6 +210,32 @@ def test_iterator_callback(testrepo: Repository) -> None:
     ]
 
 
+class GlobRefdbBackend(IterRefdbBackend):
+    """A backend which takes the glob of the iterations."""
+
+    def __init__(self, source: pygit2.RefdbBackend) -> None:
+        super().__init__(source)
+        self.globs: list[str | None] = []
+
+    def iterator(self, glob: str | None) -> Iterator[Reference]:
+        self.globs.append(glob)
+        return iter(self)
+
+
+def test_iterator_callback_glob(testrepo: Repository) -> None:
+    backend = GlobRefdbBackend(pygit2.RefdbFsBackend(testrepo))
+    refdb = pygit2.Refdb.new(testrepo)
+    refdb.set_backend(backend)
+    testrepo.set_refdb(refdb)
+
+    names = list(testrepo.references.names('refs/heads/m*'))
+    assert names == ['refs/heads/master']
+    names = sorted(testrepo.references)
+    assert names == ['refs/heads/i18n', 'refs/heads/master', 'refs/heads/symbolic']
+    assert list(testrepo.references.iterator(ReferenceFilter.TAGS)) == []
+    assert backend.globs == ['refs/heads/m*', None, 'refs/tags/*']
+
+
 @utils.requires_refcount
 def test_iterator_callback_no_leak(testrepo: Repository) -> None:
     # Iterating must not leak the Reference objects the backend yields.
@@ -341,3 +368,67 @@ def test_ensure_log(repo: Repository) -> None:
     assert not repo.backend.has_log('refs/heads/new-log')
     repo.backend.ensure_log('refs/heads/new-log')
     assert repo.backend.has_log('refs/heads/new-log')
+
+
+def test_memory_backend(testrepo: Repository) -> None:
+    master = testrepo.references['refs/heads/master'].target
+    refdb = pygit2.Refdb.new(testrepo)
+    refdb.set_backend(pygit2.RefdbMemoryBackend())
+    testrepo.set_refdb(refdb)
+
+    assert list(testrepo.references) == []
+    testrepo.references.create('refs/heads/b', master)
+    testrepo.references.create('refs/heads/a', master)
+    testrepo.create_reference('refs/heads/sym', 'refs/heads/a')
+    assert list(testrepo.references) == [
+        'refs/heads/a',
+        'refs/heads/b',
+        'refs/heads/sym',
+    ]
+    assert testrepo.references['refs/heads/sym'].resolve().target == master
+    with pytest.raises(pygit2.AlreadyExistsError):
+        testrepo.references.create('refs/heads/a', master)
+
+    testrepo.references.delete('refs/heads/b')
+    assert 'refs/heads/b' not in testrepo.references
+    branches = testrepo.references.iterator(ReferenceFilter.BRANCHES)
+    assert [ref.name for ref in branches] == ['refs/heads/a', 'refs/heads/sym']
+
+
+def test_memory_backend_overlay(testrepo: Repository) -> None:
+    master = testrepo.references['refs/heads/master'].target
+    backend = pygit2.RefdbMemoryBackend(pygit2.RefdbFsBackend(testrepo), reflog=True)
+    refdb = pygit2.Refdb.new(testrepo)
+    refdb.set_backend(backend)
+    testrepo.set_refdb(refdb)
+
+    # Reads fall through to the files, writes and deletes stay in memory
+    assert testrepo.head.target == master
+    testrepo.references.create('refs/heads/scratch', master)
+    testrepo.references.delete('refs/heads/i18n')
+    names = list(testrepo.references)
+    assert 'refs/heads/scratch' in names
+    assert 'refs/heads/i18n' not in names
+    assert 'refs/heads/master' in names
+    assert names == sorted(names)
+
+    on_disk = Repository(testrepo.path)
+    assert 'refs/heads/scratch' not in on_disk.references
+    assert 'refs/heads/i18n' in on_disk.references
+
+    [entry] = backend.reflog('refs/heads/scratch')
+    assert entry.oid_old == Oid(hex='0' * 40)
+    assert entry.oid_new == master
+    assert backend.reflog('refs/heads/i18n') == []
+
+    # Transactions lock and write the references in memory
+    i18n = on_disk.references['refs/heads/i18n'].target
+    assert testrepo.update_refs([('refs/heads/master', master, i18n)]) == []
+    assert testrepo.references['refs/heads/master'].target == i18n
+    assert on_disk.references['refs/heads/master'].target == master
+    assert backend.reflog('refs/heads/master')[0].oid_new == i18n
+
+
+def test_memory_backend_base_must_be_native(testrepo: Repository) -> None:
+    with pytest.raises(TypeError):
+        pygit2.RefdbMemoryBackend(ProxyRefdbBackend(pygit2.RefdbFsBackend(testrepo)))
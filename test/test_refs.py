@@ -37,6 +37,7 @@ from pygit2 import (
     InvalidSpecError,
     Oid,
     Reference,
+    RefsSnapshot,
     Repository,
     Signature,
     Tree,
@@ -454,6 +455,185 @@ def test_references_iterator_invalid_filter_python(testrepo: Repository) -> None
             refs.append((ref.name, ref.target))
 
 
+def test_references_glob(testrepo: Repository) -> None:
+    repo = testrepo
+    repo.create_reference(
+        'refs/tags/version1', '2be5719152d4f82c7302b1c0932d8e5f0a4a0e98'
+    )
+    repo.create_reference(
+        'refs/tags/nested/version2', '2be5719152d4f82c7302b1c0932d8e5f0a4a0e98'
+    )
+
+    assert sorted(repo.references.names('refs/tags/*')) == [
+        'refs/tags/nested/version2',
+        'refs/tags/version1',
+    ]
+    assert list(repo.references.names('refs/heads/m*')) == ['refs/heads/master']
+    assert list(repo.references.names('refs/notes/*')) == []
+    assert sorted(repo.references.names()) == sorted(repo.references)
+
+    refs = repo.references.iterator(glob='refs/heads/i*')
+    assert [ref.name for ref in refs] == ['refs/heads/i18n']
+    # The filter still applies with a glob
+    refs = repo.references.iterator(ReferenceFilter.TAGS, glob='refs/heads/*')
+    assert list(refs) == []
+
+
+def test_references_iterator_next_many(testrepo: Repository) -> None:
+    repo = testrepo
+    iter = repo.references_iterator_init('refs/heads/*')
+    refs = repo.references_iterator_next_many(iter, 1)
+    assert len(refs) == 1
+    assert refs[0].name.startswith('refs/heads/')
+    names = repo.references_iterator_next_many(iter, 10, names_only=True)
+    assert sorted([refs[0].name] + names) == ['refs/heads/i18n', 'refs/heads/master']
+    assert repo.references_iterator_next_many(iter, 10) == []
+
+    iter = repo.references_iterator_init()
+    names = repo.references_iterator_next_many(
+        iter, 10, ReferenceFilter.BRANCHES, names_only=True
+    )
+    assert sorted(names) == ['refs/heads/i18n', 'refs/heads/master']
+
+    with pytest.raises(ValueError):
+        repo.references_iterator_next_many(iter, -1)
+
+
+def _snapshot_rows(snapshot: RefsSnapshot) -> list[tuple[str, str, str]]:
+    names, offsets = bytes(snapshot.names), snapshot.name_offsets
+    symbolic, symbolic_offsets = bytes(snapshot.symbolic), snapshot.symbolic_offsets
+    targets = bytes(snapshot.targets)
+    return [
+        (
+            names[offsets[i] : offsets[i + 1]].decode(),
+            targets[i * 20 : (i + 1) * 20].hex(),
+            symbolic[symbolic_offsets[i] : symbolic_offsets[i + 1]].decode(),
+        )
+        for i in range(len(snapshot))
+    ]
+
+
+def test_refs_snapshot(testrepo: Repository) -> None:
+    repo = testrepo
+    repo.create_reference('refs/tags/version1', LAST_COMMIT)
+    repo.create_reference('refs/heads/symbolic', 'refs/heads/master')
+
+    snapshot = repo.refs_snapshot()
+    assert len(snapshot) == len(repo.listall_references())
+    assert snapshot.peeled is None
+
+    snapshot = repo.refs_snapshot('refs/heads/')
+    assert _snapshot_rows(snapshot) == [
+        ('refs/heads/i18n', '5470a671a80ac3789f1a6a8cefbcf43ce7af0563', ''),
+        ('refs/heads/master', LAST_COMMIT, ''),
+        ('refs/heads/symbolic', '00' * 20, 'refs/heads/master'),
+    ]
+    assert len(repo.refs_snapshot('refs/heads/m')) == 1
+    assert len(repo.refs_snapshot('refs/heads/*')) == 0
+
+    snapshot = repo.refs_snapshot('refs/heads/', peel=True)
+    assert snapshot.peeled is not None
+    peeled = bytes(snapshot.peeled)
+    assert peeled[40:60].hex() == LAST_COMMIT
+
+
+def test_refs_snapshot_diff(testrepo: Repository) -> None:
+    repo = testrepo
+    repo.create_reference('refs/heads/symbolic', 'refs/heads/master')
+    repo.create_reference('refs/tags/version1', LAST_COMMIT)
+    before = repo.refs_snapshot(peel=True)
+    assert before.diff(repo.refs_snapshot(peel=True)) == ([], [], [])
+
+    repo.create_reference('refs/tags/version2', LAST_COMMIT)
+    repo.references.delete('refs/tags/version1')
+    repo.references['refs/heads/master'].set_target(
+        '5470a671a80ac3789f1a6a8cefbcf43ce7af0563'
+    )
+    after = repo.refs_snapshot(peel=True)
+    assert before.diff(after) == (
+        ['refs/tags/version2'],
+        ['refs/heads/master', 'refs/heads/symbolic'],
+        ['refs/tags/version1'],
+    )
+    # Without the peeled ids, the symbolic reference did not change
+    assert repo.refs_snapshot().diff(before) == (
+        ['refs/tags/version1'],
+        ['refs/heads/master'],
+        ['refs/tags/version2'],
+    )
+
+    with pytest.raises(TypeError):
+        before.diff(None)  # type: ignore
+
+
+def test_refs_snapshot_diff_released(testrepo: Repository) -> None:
+    repo = testrepo
+    before = repo.refs_snapshot(peel=True)
+    repo.create_reference('refs/tags/version1', LAST_COMMIT)
+    after = repo.refs_snapshot(peel=True)
+
+    # The snapshots keep their own memory, whatever happens to the views
+    columns = 'names', 'name_offsets', 'targets', 'symbolic', 'symbolic_offsets'
+    for snapshot in (before, after):
+        for name in (*columns, 'peeled'):
+            getattr(snapshot, name).release()
+    assert before.diff(after) == (['refs/tags/version1'], [], [])
+    with pytest.raises(ValueError):
+        bytes(before.names)
+
+
+def test_update_refs(testrepo: Repository) -> None:
+    repo = testrepo
+    i18n = '5470a671a80ac3789f1a6a8cefbcf43ce7af0563'
+    rejected = repo.update_refs(
+        [
+            ('refs/heads/master', LAST_COMMIT, i18n),
+            ('refs/tags/version1', None, LAST_COMMIT),
+            ('refs/heads/i18n', i18n, None),
+        ],
+        message='batch update',
+    )
+    assert rejected == []
+    assert repo.references['refs/heads/master'].target == i18n
+    assert repo.references['refs/tags/version1'].target == LAST_COMMIT
+    assert 'refs/heads/i18n' not in repo.references
+    entry = next(repo.references['refs/heads/master'].log())
+    assert entry.message == 'batch update'
+
+    # Atomic: one stale expectation and nothing is updated
+    with pytest.raises(GitError):
+        repo.update_refs(
+            [
+                ('refs/heads/master', i18n, LAST_COMMIT),
+                ('refs/tags/version1', None, i18n),
+            ]
+        )
+    assert repo.references['refs/heads/master'].target == i18n
+    assert repo.references['refs/tags/version1'].target == LAST_COMMIT
+
+    # Not atomic: the others are updated
+    rejected = repo.update_refs(
+        [
+            ('refs/heads/master', i18n, LAST_COMMIT),
+            ('refs/tags/version1', None, i18n),
+        ],
+        atomic=False,
+    )
+    assert rejected == ['refs/tags/version1']
+    assert repo.references['refs/heads/master'].target == LAST_COMMIT
+    assert repo.references['refs/tags/version1'].target == LAST_COMMIT
+
+    with pytest.raises(ValueError):
+        repo.update_refs(
+            [
+                ('refs/heads/master', LAST_COMMIT, i18n),
+                ('refs/heads/master', LAST_COMMIT, i18n),
+            ]
+        )
+    with pytest.raises(TypeError):
+        repo.update_refs([('refs/heads/master', LAST_COMMIT)])  # type: ignore
+
+
 def test_lookup_reference(testrepo: Repository) -> None:
     repo = testrepo
 
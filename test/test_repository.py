@@ -23,6 +23,7 @@
 # the Free Software Foundation, 51 Franklin Street, Fifth Floor,
 # Boston, MA 02110-1301, USA.
 
+import re
 import shutil
 import tempfile
 from pathlib import Path
@@ -40,6 +41,7 @@ from pygit2 import (
     Oid,
     Remote,
     Repository,
+    Tree,
     Worktree,
     clone_repository,
     discover_repository,
@@ -59,6 +61,7 @@ from pygit2.enums import (
     StashApplyProgress,
 )
 from pygit2.index import MergeFileResult
+from pygit2.repository import _regex_literal
 
 from . import utils
 
@@ -1209,3 +1212,89 @@ def test_merge_file_from_index(testrepo: Repository) -> None:
         hello_txt_executable.mode,
         get_hello_txt_from_repo(),
     )
+
+
+def test_grep(testrepo: Repository) -> None:
+    sub = testrepo.TreeBuilder()
+    sub.insert('b.txt', testrepo.create_blob(b'no match\nthe main road'), FileMode.BLOB)
+    tb = testrepo.TreeBuilder()
+    tb.insert('a.py', testrepo.create_blob(b'import os\ndef main():\n'), FileMode.BLOB)
+    tb.insert('bin', testrepo.create_blob(b'main\x00'), FileMode.BLOB)
+    tb.insert('sub', sub.write(), FileMode.TREE)
+    tree = tb.write()
+
+    expected = [(b'a.py', 2, b'def main():'), (b'sub/b.txt', 2, b'the main road')]
+    assert testrepo.grep(tree, 'main') == expected
+    assert testrepo.grep(tree, 'main', threads=2) == expected
+    assert testrepo.grep(tree, b'MAIN', flags=re.IGNORECASE) == expected
+    assert testrepo.grep(tree, 'main', pathspec='sub/*') == expected[1:]
+    assert testrepo.grep(tree, r'^def \w+\(') == expected[:1]
+    assert testrepo.grep(tree, 'm.in', fixed_strings=True) == []
+    assert testrepo.grep(testrepo[tree], 'import', pathspec=['*.py']) == [
+        (b'a.py', 1, b'import os')
+    ]
+
+
+@pytest.mark.parametrize(
+    'pattern,literal',
+    [
+        (rb'def main', b'def main'),
+        (rb'^def \w+\(', b'def '),
+        (rb'abc\.def', b'abc.def'),
+        (rb'foo\.?x', b'foo'),
+        (rb'\x41BC', b''),
+        (rb'X\x41BC', b'X'),
+        (rb'\101BC', b''),
+        (rb'A\N{LATIN SMALL LETTER A}BC', b'A'),
+        (rb'ab\d+cd', b'ab'),
+    ],
+)
+def test_regex_literal(pattern: bytes, literal: bytes) -> None:
+    assert _regex_literal(pattern) == literal
+
+
+def test_grep_escapes(testrepo: Repository) -> None:
+    tb = testrepo.TreeBuilder()
+    tb.insert('a', testrepo.create_blob(b'ABC\n41BC\n01BC\n\nabc\n'), FileMode.BLOB)
+    tree = tb.write()
+
+    assert testrepo.grep(tree, rb'\x41BC') == [(b'a', 1, b'ABC')]
+    assert testrepo.grep(tree, rb'\101BC') == [(b'a', 1, b'ABC')]
+    # The pattern is matched as bytes, where \N is not supported
+    with pytest.raises(re.error):
+        testrepo.grep(tree, r'\N{LATIN CAPITAL LETTER A}BC')
+    # Without a literal every line is searched, the empty one too
+    assert testrepo.grep(tree, '^$') == [(b'a', 4, b'')]
+    assert testrepo.grep(tree, 'abc', flags=re.IGNORECASE) == [
+        (b'a', 1, b'ABC'),
+        (b'a', 5, b'abc'),
+    ]
+
+
+def test_grep_ignore_case(testrepo: Repository) -> None:
+    data = b'Main\nMAIN road\nmane\n\xc3\x89t\xc3\xa9 main\n'
+    tb = testrepo.TreeBuilder()
+    tb.insert('a', testrepo.create_blob(data), FileMode.BLOB)
+    tb.insert('bin', testrepo.create_blob(b'MAIN\x00'), FileMode.BLOB)
+    tree = testrepo[tb.write()]
+    assert isinstance(tree, Tree)
+
+    # The literal is searched in C ignoring the case of ASCII letters only
+    expected = [
+        (b'a', 1, b'Main'),
+        (b'a', 2, b'MAIN road'),
+        (b'a', 4, b'\xc3\x89t\xc3\xa9 main'),
+    ]
+    assert tree._grep(b'mAiN', ignore_case=True) == expected
+    assert tree._grep(b'T\xc3\xa9', ignore_case=True) == expected[2:]
+    assert tree._grep(b'T\xc3\x89', ignore_case=True) == []
+    assert tree._grep(b'main') == expected[2:]
+    assert testrepo.grep(tree, 'main', flags=re.IGNORECASE) == expected
+    assert testrepo.grep(tree, 'MAIN', fixed_strings=True, flags=re.I) == expected
+    assert testrepo.grep(tree, r'ma[a-z]n\b', flags=re.IGNORECASE) == expected
+    assert testrepo.grep(tree, 'M.IN R', flags=re.IGNORECASE) == expected[1:2]
+
+    # Every line, split in C, for the patterns without a literal
+    assert tree._grep_lines() == [(b'a', data.split(b'\n')[:-1])]
+    assert tree._grep_lines(pathspec='b*') == []
+    assert testrepo.grep(tree, r'^\w{4}$') == [(b'a', 1, b'Main'), (b'a', 3, b'mane')]
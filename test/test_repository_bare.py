@@ -164,6 +164,30 @@ def test_expand_id(barerepo: Repository) -> None:
     assert commit_sha == expanded
 
 
+def test_lookup_many(barerepo: Repository) -> None:
+    missing = '1' * 40
+    objs = barerepo.lookup_many([HEAD_SHA, missing, BLOB_OID, PARENT_SHA[:7]])
+    assert len(objs) == 4
+    assert isinstance(objs[0], Commit)
+    assert objs[0].id == HEAD_SHA
+    assert objs[1] is None
+    assert objs[2].id == BLOB_OID
+    assert objs[3].id == PARENT_SHA
+
+    objs = barerepo.lookup_many([HEAD_SHA, BLOB_HEX], ObjectType.BLOB)
+    assert objs[0] is None
+    assert objs[1].id == BLOB_OID
+
+    assert barerepo.lookup_many([]) == []
+    with pytest.raises(TypeError):
+        barerepo.lookup_many([123])  # type: ignore
+
+
+def test_read_many(barerepo: Repository) -> None:
+    odb = barerepo.odb
+    assert odb.read_many([BLOB_HEX, '1' * 40]) == [odb.read(BLOB_HEX), None]
+
+
 @utils.requires_refcount
 def test_lookup_commit_refcount(barerepo: Repository) -> None:
     start = sys.getrefcount(barerepo)
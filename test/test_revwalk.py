@@ -25,8 +25,12 @@
 
 """Tests for revision walk."""
 
-from pygit2 import Repository
-from pygit2.enums import SortMode
+import sys
+
+import pytest
+
+from pygit2 import OdbBackendMemory, Oid, Repository
+from pygit2.enums import DeltaStatus, SortMode
 
 # In the order given by git log
 log = [
@@ -63,6 +67,115 @@ def test_walk(testrepo: Repository) -> None:
     assert [x.id for x in walker] == log
 
 
+def test_walk_oids(testrepo: Repository) -> None:
+    walker = testrepo.walk(log[0], SortMode.TIME).oids()
+    oids = list(walker)
+    assert all(type(x) is Oid for x in oids)
+    assert oids == log
+
+    walker = testrepo.walk(log[0], SortMode.TIME, yield_ids=True)
+    assert list(walker) == log
+
+
+def test_next_batch(testrepo: Repository) -> None:
+    walker = testrepo.walk(log[0], SortMode.TIME)
+    assert walker.next_batch(3) == log[:3]
+    assert walker.next_batch(3) == log[3:]
+    assert walker.next_batch(3) == []
+
+    walker = testrepo.walk(log[0], SortMode.TIME)
+    raw = walker.next_batch(10, raw=True)
+    assert raw == b''.join(Oid(hex=x).raw for x in log)
+
+    # Nothing is reserved for ids the walk does not have
+    walker = testrepo.walk(log[0], SortMode.TIME)
+    assert walker.next_batch(sys.maxsize // 20) == log
+    with pytest.raises(ValueError):
+        walker.next_batch(-1)
+    with pytest.raises(ValueError):
+        walker.next_batch(sys.maxsize)
+
+
+def test_commit_table(testrepo: Repository) -> None:
+    def oids(view: memoryview) -> list[Oid]:
+        raw = bytes(view)
+        return [Oid(raw=raw[i : i + 20]) for i in range(0, len(raw), 20)]
+
+    table = testrepo.commit_table(testrepo.walk(log[0], SortMode.TIME))
+    assert oids(table['id']) == log
+    # The columns are handed over, not copied into bytes
+    assert table['id'].readonly
+    assert not isinstance(table['id'].obj, bytes)
+    trees = oids(table['tree'])
+    parents = oids(table['parents'])
+
+    for i, oid in enumerate(log):
+        commit = testrepo[oid]
+        assert trees[i] == commit.tree_id
+        assert table['committer_time'][i] == commit.commit_time
+        assert table['committer_offset'][i] == commit.commit_time_offset
+        assert table['author_time'][i] == commit.author.time
+        start, end = table['parent_offsets'][i : i + 2]
+        assert parents[start:end] == commit.parent_ids
+        start, end = table['author_name_offsets'][i : i + 2]
+        assert bytes(table['author_name'][start:end]) == commit.author.raw_name
+
+    table = testrepo.commit_table(log[1:3])
+    assert oids(table['id']) == log[1:3]
+    assert len(table['committer_email_offsets']) == 3
+
+
+def test_changed_paths(testrepo: Repository) -> None:
+    commits = [testrepo[oid] for oid in log]
+    expected = []
+    for commit in commits:
+        if commit.parents:
+            diff = commit.parents[0].tree.diff_to_tree(commit.tree)
+        else:
+            diff = commit.tree.diff_to_tree(swap=True)
+        expected.append(
+            [
+                (delta.new_file.path, int(delta.status))
+                if delta.status != DeltaStatus.DELETED
+                else (delta.old_file.path, int(delta.status))
+                for delta in diff.deltas
+            ]
+        )
+
+    for threads in (1, 3):
+        changes = testrepo.changed_paths(
+            testrepo.walk(log[0], SortMode.TIME), threads=threads
+        )
+        assert bytes(changes['id']) == b''.join(Oid(hex=oid).raw for oid in log)
+        offsets = changes['offsets']
+        assert len(offsets) == len(log) + 1
+        paths = changes['paths']
+        assert len(set(paths)) == len(paths)
+        for i in range(len(log)):
+            entries = range(offsets[i], offsets[i + 1])
+            assert [
+                (paths[changes['path_ids'][j]], changes['status'][j]) for j in entries
+            ] == expected[i]
+
+    changes = testrepo.changed_paths([log[2][:7]], threads=4)
+    assert bytes(changes['id']) == Oid(hex=log[2]).raw
+
+    with pytest.raises(ValueError):
+        testrepo.changed_paths(log, threads=0)
+    with pytest.raises(KeyError):
+        testrepo.changed_paths([log[0], '1' * 40], threads=2)
+
+
+def test_changed_paths_custom_backend(testrepo: Repository) -> None:
+    # Threads can't open handles of their own, the diffs run serially
+    expected = testrepo.changed_paths(log)
+    testrepo.odb.add_backend(OdbBackendMemory(), 1000)
+    changes = testrepo.changed_paths(log, threads=4)
+    assert changes['paths'] == expected['paths']
+    for name in ('id', 'offsets', 'path_ids', 'status'):
+        assert bytes(changes[name]) == bytes(expected[name])
+
+
 def test_reverse(testrepo: Repository) -> None:
     walker = testrepo.walk(log[0], SortMode.TIME | SortMode.REVERSE)
     assert [x.id for x in walker] == list(reversed(log))
@@ -90,6 +90,69 @@ def test_status_ignored(
     } == expected
 
 
+def test_status_pathspec_raw(dirtyrepo: Repository) -> None:
+    git_status = dirtyrepo.status()
+    expected = {
+        path: status
+        for path, status in git_status.items()
+        if path.startswith('subdir/')
+    }
+    assert expected
+    assert dirtyrepo.status(pathspec=['subdir']) == expected
+    assert dirtyrepo.status(pathspec='subdir/*') == expected
+
+    raw = dirtyrepo.status(raw=True)
+    assert isinstance(raw, list)
+    assert all(type(path) is bytes and type(flags) is int for path, flags in raw)
+    assert {path.decode(): flags for path, flags in raw} == git_status
+
+
+def test_status_cache(dirtyrepo: Repository) -> None:
+    workdir = Path(dirtyrepo.workdir)
+    cache = pygit2.StatusCache(dirtyrepo)
+    assert cache.refresh() == dirtyrepo.status()
+    assert cache.refresh() == dirtyrepo.status()
+
+    # New file in an existing directory, modified and deleted files
+    (workdir / 'subdir' / 'another_file').write_text('hello')
+    (workdir / 'modified_file').write_text('changed again')
+    (workdir / 'current_file').unlink()
+    status = cache.refresh()
+    assert status['subdir/another_file'] == FileStatus.WT_NEW
+    assert status == dirtyrepo.status()
+
+    # New directory, and a change to the index
+    (workdir / 'newdir').mkdir()
+    (workdir / 'newdir' / 'file').write_text('hello')
+    assert cache.refresh() == dirtyrepo.status()
+    dirtyrepo.index.add('newdir/file')
+    dirtyrepo.index.write()
+    status = cache.refresh()
+    assert status['newdir/file'] == FileStatus.INDEX_NEW
+    assert status == dirtyrepo.status()
+
+    assert cache.refresh(raw=True) == dict(dirtyrepo.status(raw=True))
+
+
+def test_status_cache_ignored_directory(dirtyrepo: Repository) -> None:
+    workdir = Path(dirtyrepo.workdir)
+    (workdir / 'build').mkdir()
+    (workdir / 'build' / 'tracked').write_text('hello')
+    with open(Path(dirtyrepo.path) / 'info' / 'exclude', 'a') as f:
+        f.write('build/\n')
+    dirtyrepo.index.add('build/tracked')
+    dirtyrepo.index.write()
+
+    cache = pygit2.StatusCache(dirtyrepo)
+    assert cache.refresh() == dirtyrepo.status()
+
+    # Tracked files are seen even if the directory is not walked
+    (workdir / 'build' / 'tracked').write_text('changed')
+    status = cache.refresh()
+    assert status['build/tracked'] == FileStatus.INDEX_NEW | FileStatus.WT_MODIFIED
+    assert status == dirtyrepo.status()
+
+
 def test_status_file_non_ascii(tmp_path: Path) -> None:
     """status_file must round-trip non-ASCII path names."""
     repo = pygit2.init_repository(str(tmp_path / 'repo'))
@@ -29,7 +29,7 @@ import pytest
 
 import pygit2
 from pygit2 import Object, Repository, Tree
-from pygit2.enums import FileMode, ObjectType
+from pygit2.enums import FileMode, ObjectType, TreeWalkMode
 
 from . import utils
 
@@ -126,6 +126,107 @@ def test_read_subtree(barerepo: Repository) -> None:
     assert subtree_entry == barerepo[subtree_entry.id]
 
 
+def test_walk(barerepo: Repository) -> None:
+    tree = barerepo[TREE_SHA]
+    assert isinstance(tree, Tree)
+    entries = {
+        b'a': (0o100644, tree['a'].id),
+        b'b': (0o100644, tree['b'].id),
+        b'c': (0o040000, tree['c'].id),
+        b'c/d': (0o100644, tree['c/d'].id),
+    }
+
+    def walk(**kwargs: object) -> list[bytes]:
+        result = tree.walk(**kwargs)  # type: ignore
+        assert tree.walk(threads=3, **kwargs) == result  # type: ignore
+        for path, mode, oid in result:
+            assert entries[path] == (mode, oid)
+        return [path for path, mode, oid in result]
+
+    assert walk() == [b'a', b'b', b'c', b'c/d']
+    assert walk(mode=TreeWalkMode.POST) == [b'a', b'b', b'c/d', b'c']
+    assert walk(include_blobs=False) == [b'c']
+    assert walk(pathspec='c') == [b'c', b'c/d']
+    assert walk(pathspec='c/*') == [b'c/d']
+    assert walk(pathspec=['*d', b'a']) == [b'a', b'c/d']
+    assert walk(pathspec='x/*') == []
+
+    table = tree.walk(columns=True)
+    offsets = table['path_offsets']
+    assert list(offsets) == [0, 1, 2, 3, 6]
+    assert table['path'][offsets[3] : offsets[4]] == b'c/d'
+    assert list(table['mode']) == [0o100644, 0o100644, 0o040000, 0o100644]
+    assert bytes(table['id'][20:40]) == tree['b'].id.raw
+
+    with pytest.raises(ValueError):
+        tree.walk(mode=2)  # type: ignore
+    with pytest.raises(ValueError):
+        tree.walk(threads=0)
+
+
+@pytest.fixture
+def wide_tree(barerepo: Repository) -> Tree:
+    """A tree with enough subtrees for the walk to be split between threads."""
+    blob = barerepo.create_blob(b'hello')
+    leaf = barerepo.TreeBuilder()
+    leaf.insert('file', blob, FileMode.BLOB)
+    leaf_id = leaf.write()
+
+    root = barerepo.TreeBuilder()
+    for i in range(20):
+        middle = barerepo.TreeBuilder()
+        middle.insert('file', blob, FileMode.BLOB)
+        for j in range(20):
+            middle.insert(f'sub{j:02}', leaf_id, FileMode.TREE)
+        root.insert(f'dir{i:02}', middle.write(), FileMode.TREE)
+    root.insert('file', blob, FileMode.BLOB)
+    tree = barerepo[root.write()]
+    assert isinstance(tree, Tree)
+    return tree
+
+
+@pytest.mark.parametrize(
+    'kwargs',
+    [
+        {},
+        {'mode': TreeWalkMode.POST},
+        {'include_blobs': False},
+        {'pathspec': 'dir1*/sub0*'},
+    ],
+)
+def test_walk_threads(wide_tree: Tree, kwargs: dict[str, object]) -> None:
+    serial = wide_tree.walk(**kwargs)  # type: ignore
+    assert serial
+    for threads in (2, 3, 8):
+        assert wide_tree.walk(threads=threads, **kwargs) == serial  # type: ignore
+
+    table = wide_tree.walk(columns=True, **kwargs)  # type: ignore
+    parallel = wide_tree.walk(columns=True, threads=3, **kwargs)  # type: ignore
+    for name in ('path', 'path_offsets', 'mode', 'id'):
+        assert bytes(parallel[name]) == bytes(table[name])
+
+
+def test_lookup_paths(barerepo: Repository) -> None:
+    tree = barerepo[TREE_SHA]
+    assert isinstance(tree, Tree)
+    paths = ['c/d', 'a', 'x', 'c', 'c/x', 'a/d', b'b', '', 'c//d']
+    assert tree.lookup_paths(paths) == [
+        (tree['c/d'].id, 0o100644),
+        (tree['a'].id, 0o100644),
+        None,
+        (tree['c'].id, 0o040000),
+        None,
+        None,
+        (tree['b'].id, 0o100644),
+        None,
+        None,
+    ]
+    assert tree.lookup_paths([]) == []
+
+    with pytest.raises(TypeError):
+        tree.lookup_paths('a')
+
+
 def test_new_tree(barerepo: Repository) -> None:
     repo = barerepo
     b0 = repo.create_blob('1')